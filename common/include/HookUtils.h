@@ -1,7 +1,11 @@
 #pragma once
 #include <safetyhook.hpp>
 #include <Windows.h>
+#include "ModuleImage.h"
 #include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
 
 template<typename R, typename ...Args>
 SafetyHookInline CreateHookFunction(R(*target)(Args...), R(*hook)(Args...)) {
@@ -30,7 +34,7 @@ namespace HookUtils {
 	// Returns the address of the function pattern, or nullptr if not found
 	// func: The caller function
 	// signature: The function pattern
-	// scanSize: The size of the scan range
+	// scanSize: The size of the scan range, clamped to the end of the code range containing func
 	uintptr_t LookupFunctionPattern(void *func, std::string_view signature, uint32_t scanSize);
 
 
@@ -77,5 +81,34 @@ namespace HookUtils {
 
 	std::optional<size_t> GetModuleSize(HMODULE module);
 
+	// Headers and section table of the main module, parsed on first use
+	// Returns nullptr if the headers cannot be parsed; scans then fall back to the whole image
+	const ModuleImage* GetMainModuleImage();
+
+	// Scans below only cover the executable sections of the main module (ModuleImage::CodeRanges)
+	// Their matches are cached in "<plugin>.sigcache" (SignatureCache) and reused on later launches of the same build,
+	// once SaveSignatureCache has written them
+	// They run on the calling thread only, so REL::Pattern can use them from static initializers under the loader lock
 	uintptr_t ScanIDAPattern(std::string_view signature, int32_t offset = 0, int32_t relOffset = 0, int32_t instructionLength = 0);
+
+	// Same as ScanIDAPattern, but scans every code range and logs the signature if it matches more than once
+	// Returns the first match, so a signature that became ambiguous after a game update keeps its old behavior
+	// A diagnostic: it costs a full scan where ScanIDAPattern stops early, so REL::Pattern only uses it in debug builds
+	uintptr_t ScanUniqueIDAPattern(std::string_view signature, int32_t offset = 0, int32_t relOffset = 0, int32_t instructionLength = 0);
+
+	// One ScanIDAPattern request for ScanIDAPatterns
+	struct IDAPattern {
+		std::string_view signature;
+		int32_t offset = 0;
+		int32_t relOffset = 0;
+		int32_t instructionLength = 0;
+	};
+
+	// Resolve all signatures in a single pass over the main module
+	// Returns one address per pattern, in order, resolved like ScanIDAPattern (0 if not found)
+	std::vector<uintptr_t> ScanIDAPatterns(std::span<const IDAPattern> patterns);
+
+	// Write the matches resolved so far to "<plugin>.sigcache", if any are new
+	// Call it once the plugin has resolved its signatures, rather than after every scan
+	void SaveSignatureCache();
 }
\ No newline at end of file
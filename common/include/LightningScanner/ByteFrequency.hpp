@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+namespace LightningScanner {
+
+// clang-format off
+/**
+ * How common each byte value is in x86-64 machine code, log-scaled from
+ * 0 (rarest) to 255 (most common).
+ *
+ * Measured over ~100MB of compiler-generated .text. Used to anchor patterns
+ * on the bytes least likely to produce false candidates.
+ *
+ * \headerfile ByteFrequency.hpp <LightningScanner/ByteFrequency.hpp>
+ */
+inline constexpr uint8_t ByteFrequency[256] = {
+    255, 175, 130, 119, 144, 114,  94,  94, 155,  84,  74,  58,  95,  72,  53, 204,
+    148,  96,  60,  40,  91,  68,  68,  45, 119,  32,  35,  30,  69,  58,  38, 122,
+    127,  69,  40,  27, 198,  89,  23,  26, 122,  84,  25,  51,  67,  57,  77,  29,
+    106, 122,  24,  35,  67,  80,  27,  53, 101, 131,  45,  84,  81,  74,  32,  42,
+    154, 164,  74,  91, 161, 121,  63,  77, 236, 156,  61,  49, 173, 111,  42,  48,
+    105,  32,  29,  82, 101,  93,  66,  74,  77,  19,  27,  78,  89,  95,  67,  71,
+     91,  78, 143,  45,  88,  60, 170,  59,  75,  57,  22,  60,  84,  62,  48, 109,
+    111,  40,  87,  67, 147, 122,  45,  69,  80,  28,  32,  56, 103,  92, 105,  87,
+    107,  92,  40, 160, 161, 152,  32,  49,  78, 209,  19, 197,  63, 170,  22,  22,
+     91,  30,  15,  17,  73,  41,  11,  14,  56,   4,   0,   4,  44,  20,   6,  16,
+     65,  92,  26,  26,  30,  11,   4,   9,  60,  14,  28,  19,  49,  15,   4,  30,
+     67,  70,   9,  19,  63,  36,  77,  62,  86,  65,  78,  39,  85,  58,  76,  64,
+    142, 134,  90, 118, 111, 117, 101, 135,  90,  86,  65,  44,  43,  50,  53,  49,
+     86,  77,  85,  67,  58,  57,  66,  49,  92,  59,  59,  75,  51,  61,  73, 102,
+    105,  99,  82,  70,  66,  68,  71,  79, 174, 131,  79, 113,  77,  82,  88, 102,
+     97,  62,  76, 104,  49, 115, 109,  93, 109,  91,  85,  78,  91, 119, 150, 207,
+};
+// clang-format on
+
+} // namespace LightningScanner
@@ -10,8 +10,13 @@ namespace LightningScanner {
 struct CpuInfo {
     /** Is SSE4.2 supported? */
     bool sse42Supported = false;
-    /** Is AVX2 supported? */
+    /** Is AVX2 supported, and are YMM registers enabled by the OS? */
     bool avx2Supported = false;
+    /**
+     * Are AVX-512F and AVX-512BW supported, and are ZMM and opmask registers
+     * enabled by the OS?
+     */
+    bool avx512Supported = false;
 
     /**
      * Get the cpu information
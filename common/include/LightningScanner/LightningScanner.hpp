@@ -7,25 +7,25 @@
 #include <LightningScanner/ScanResult.hpp>
 
 #include <LightningScanner/CpuInfo.hpp>
-#include <LightningScanner/backends/Avx2.hpp>
-#include <LightningScanner/backends/Scalar.hpp>
-#include <LightningScanner/backends/Sse42.hpp>
+#include <LightningScanner/ParallelScan.hpp>
+#include <LightningScanner/ScanBackend.hpp>
 
 namespace LightningScanner {
 
 /**
- * \brief Single result IDA-style pattern scanner
+ * \brief IDA-style pattern scanner
  * \headerfile LightningScanner.hpp <LightningScanner/LightningScanner.hpp>
  *
  * A pattern scanner that searches for an IDA-style pattern
- * and returns the pointer to the first occurrence in the binary.
+ * and returns the pointer to the first occurrence in the binary,
+ * or every occurrence and their count.
  *
  * \tparam PreferredMode the preferred scan mode.
  *          This is used as a suggestion for the scanner which mode to try
  * first, if the mode is not supported, it will try every other one until it
  * finds a supported one.
  */
-template <ScanMode PreferredMode = ScanMode::Avx2>
+template <ScanMode PreferredMode = ScanMode::Avx512>
 class Scanner {
 public:
     /**
@@ -56,24 +56,84 @@ public:
      * \endcode
      */
     ScanResult Find(void* startAddr, size_t size) const {
+        return SelectBackend().find(m_Pattern, startAddr, size);
+    }
+
+    /**
+     * Find every occurrence of the pattern in the binary in one pass
+     *
+     * \param{in} startAddr address to start the search from
+     * \param{in} size binary size of the search area
+     * \param{in} maxCount stop after this many matches
+     *
+     * \return ScanResult instances in address order; matches may overlap
+     *
+     * Example:
+     *
+     * \code{.cpp}
+     * using namespace LightningScanner;
+     * const auto scanner = Scanner("48 89 5c 24 ?? 48 89 6c");
+     * bool unique = scanner.FindAll(binary, binarySize, 2).size() == 1;
+     * \endcode
+     */
+    std::vector<ScanResult> FindAll(void* startAddr, size_t size,
+                                    size_t maxCount = SIZE_MAX) const {
+        return SelectBackend().findAll(m_Pattern, startAddr, size, maxCount);
+    }
+
+    /**
+     * Count the occurrences of the pattern in the binary in one pass
+     *
+     * \param{in} startAddr address to start the search from
+     * \param{in} size binary size of the search area
+     */
+    size_t Count(void* startAddr, size_t size) const {
+        return SelectBackend().count(m_Pattern, startAddr, size);
+    }
+
+    /**
+     * Find the first occurrence of the pattern in the binary, scanning
+     * chunks of it on several threads
+     *
+     * Not for DllMain or a DLL's static initializers: threads cannot start
+     * while the loader lock is held, so the join there never returns.
+     *
+     * \param{in} startAddr address to start the search from
+     * \param{in} size binary size of the search area
+     * \param{in} threadCount threads to use including the calling one, or 0
+     * to use the hardware concurrency (at most 8).
+     *
+     * \return A ScanResult instance, the same one Find returns
+     */
+    ScanResult FindParallel(void* startAddr, size_t size,
+                            size_t threadCount = 0) const {
+        return LightningScanner::FindParallel(
+            m_Pattern, SelectBackend().find, startAddr, size, threadCount);
+    }
+
+private:
+    static const ScanBackend& SelectBackend() {
         const CpuInfo& cpuInfo = CpuInfo::GetCpuInfo();
 
-        if (PreferredMode == ScanMode::Avx2 && cpuInfo.avx2Supported)
-            return FindAvx2(m_Pattern, startAddr, size);
+        if (PreferredMode == ScanMode::Avx512 && cpuInfo.avx512Supported)
+            return Avx512Backend;
+        else if (PreferredMode == ScanMode::Avx2 && cpuInfo.avx2Supported)
+            return Avx2Backend;
         else if (PreferredMode == ScanMode::Sse42 && cpuInfo.sse42Supported)
-            return FindSse42(m_Pattern, startAddr, size);
+            return Sse42Backend;
         else if (PreferredMode == ScanMode::Scalar)
-            return FindScalar(m_Pattern, startAddr, size);
+            return ScalarBackend;
 
-        if (cpuInfo.avx2Supported)
-            return FindAvx2(m_Pattern, startAddr, size);
+        if (cpuInfo.avx512Supported)
+            return Avx512Backend;
+        else if (cpuInfo.avx2Supported)
+            return Avx2Backend;
         else if (cpuInfo.sse42Supported)
-            return FindSse42(m_Pattern, startAddr, size);
+            return Sse42Backend;
 
-        return FindScalar(m_Pattern, startAddr, size);
+        return ScalarBackend;
     }
 
-private:
     Pattern m_Pattern;
 };
 
@@ -0,0 +1,60 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <LightningScanner/Pattern.hpp>
+#include <LightningScanner/ScanResult.hpp>
+
+namespace LightningScanner {
+
+/**
+ * \brief Multi-pattern IDA-style pattern scanner
+ * \headerfile MultiScanner.hpp <LightningScanner/MultiScanner.hpp>
+ *
+ * Compiles several IDA-style patterns into one matcher that finds the first
+ * occurrence of every pattern in a single pass over the binary.
+ *
+ * Each pattern is anchored on one of its rarest fixed bytes. The scan
+ * compares 16 positions at a time against the set of anchor bytes and only
+ * verifies the patterns whose anchor byte was hit.
+ */
+class MultiScanner {
+public:
+    /**
+     * Create a new MultiScanner instance from IDA-style patterns
+     *
+     * Example:
+     *
+     * \code{.cpp}
+     * LightningScanner::MultiScanner({"48 89 5c 24 ?? 48 89 6c", "E8 ? ? ? ? 84 C0"});
+     * \endcode
+     *
+     * \param patterns patterns to search for.
+     */
+    explicit MultiScanner(std::vector<Pattern> patterns);
+
+    /**
+     * Find the first occurrence of every pattern in the binary
+     *
+     * \param{in} startAddr address to start the search from
+     * \param{in} size binary size of the search area
+     *
+     * \return One ScanResult per pattern, in the order the patterns were
+     * given; patterns that were not found hold nullptr.
+     */
+    std::vector<ScanResult> Find(void* startAddr, size_t size) const;
+
+private:
+    std::vector<Pattern> m_Patterns;
+    /** Offset of the anchor byte in each pattern */
+    std::vector<size_t> m_AnchorOffsets;
+    /** Distinct anchor bytes of all patterns */
+    std::vector<uint8_t> m_AnchorBytes;
+    /** Patterns anchored on each byte value */
+    std::array<std::vector<uint32_t>, 256> m_PatternsByAnchor;
+    /** Patterns without a fixed byte, which match at the start address */
+    std::vector<uint32_t> m_UnanchoredPatterns;
+};
+
+} // namespace LightningScanner
@@ -0,0 +1,33 @@
+#pragma once
+#include <LightningScanner/Pattern.hpp>
+#include <LightningScanner/ScanBackend.hpp>
+#include <LightningScanner/ScanResult.hpp>
+
+namespace LightningScanner {
+
+/** Bytes of search area each worker takes at a time */
+inline constexpr size_t ParallelChunkSize = 1024 * 1024;
+
+/**
+ * Scan the binary on several threads.
+ *
+ * The area is split into chunks that overlap by the pattern size minus one,
+ * so a match across a chunk boundary is still found. Workers take chunks in
+ * address order and skip every chunk after the earliest match found so far,
+ * so the result is the same as a single-threaded scan.
+ *
+ * \headerfile ParallelScan.hpp <LightningScanner/ParallelScan.hpp>
+ *
+ * \param{in} data pattern data.
+ * \param{in} find backend used to scan each chunk.
+ * \param{in} startAddr address to start the search from
+ * \param{in} size binary size of the search area
+ * \param{in} threadCount threads to use including the calling one, or 0 to
+ * use the hardware concurrency (at most 8).
+ * \param{in} chunkSize bytes of search area per chunk.
+ */
+ScanResult FindParallel(const Pattern& data, FindFunction find, void* startAddr,
+                        size_t size, size_t threadCount = 0,
+                        size_t chunkSize = ParallelChunkSize);
+
+} // namespace LightningScanner
@@ -1,4 +1,5 @@
 #pragma once
+#include <LightningScanner/ByteFrequency.hpp>
 #include <LightningScanner/allocator/AlignedAllocator.hpp>
 #include <cmath>
 #include <cstdint>
@@ -73,6 +74,25 @@ struct Pattern {
 
         unpaddedSize = data.size();
 
+        anchorOffset = unpaddedSize;
+        secondAnchorOffset = unpaddedSize;
+        for (size_t i = 0; i < unpaddedSize; i++) {
+            if (mask[i] == 0x00)
+                continue;
+
+            if (anchorOffset == unpaddedSize ||
+                ByteFrequency[data[i]] < ByteFrequency[data[anchorOffset]]) {
+                secondAnchorOffset = anchorOffset;
+                anchorOffset = i;
+            } else if (secondAnchorOffset == unpaddedSize ||
+                       ByteFrequency[data[i]] <
+                           ByteFrequency[data[secondAnchorOffset]]) {
+                secondAnchorOffset = i;
+            }
+        }
+        if (secondAnchorOffset == unpaddedSize)
+            secondAnchorOffset = anchorOffset;
+
         size_t count = (size_t)std::ceil((float)data.size() / Alignment);
         size_t paddingSize = count * Alignment - data.size();
 
@@ -82,6 +102,19 @@ struct Pattern {
         }
     }
 
+    /**
+     * Check the pattern against the bytes at an address
+     *
+     * \param addr address of at least unpaddedSize readable bytes.
+     */
+    bool Matches(const uint8_t* addr) const {
+        for (size_t i = 0; i < unpaddedSize; i++) {
+            if ((addr[i] & mask[i]) != data[i])
+                return false;
+        }
+        return true;
+    }
+
 public:
     /** Pattern binary data */
     std::vector<uint8_t, AlignedAllocator<uint8_t, Alignment>> data{};
@@ -89,6 +122,16 @@ public:
     std::vector<uint8_t, AlignedAllocator<uint8_t, Alignment>> mask{};
     /** Unpadded pattern size */
     size_t unpaddedSize{};
+    /**
+     * Offset of the rarest fixed byte in x86-64 code (see ByteFrequency),
+     * or unpaddedSize if every byte is a wildcard.
+     */
+    size_t anchorOffset{};
+    /**
+     * Offset of the second rarest fixed byte, or anchorOffset if the
+     * pattern has only one fixed byte.
+     */
+    size_t secondAnchorOffset{};
 
 private:
     static uint8_t CharToByte(char symbol) {
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <LightningScanner/Pattern.hpp>
+#include <LightningScanner/ScanResult.hpp>
+
+#include <LightningScanner/backends/Avx2.hpp>
+#include <LightningScanner/backends/Avx512.hpp>
+#include <LightningScanner/backends/Scalar.hpp>
+#include <LightningScanner/backends/Sse42.hpp>
+
+namespace LightningScanner {
+
+/** Signature of the backends' Find functions */
+using FindFunction = ScanResult (*)(const Pattern&, void*, size_t);
+/** Signature of the backends' FindAll functions */
+using FindAllFunction = std::vector<ScanResult> (*)(const Pattern&, void*,
+                                                    size_t, size_t);
+/** Signature of the backends' Count functions */
+using CountFunction = size_t (*)(const Pattern&, void*, size_t);
+
+/**
+ * The entry points of one scan backend
+ *
+ * \headerfile ScanBackend.hpp <LightningScanner/ScanBackend.hpp>
+ */
+struct ScanBackend {
+    /** Backend name */
+    const char* name;
+    FindFunction find;
+    FindAllFunction findAll;
+    CountFunction count;
+};
+
+/** Scalar backend */
+inline constexpr ScanBackend ScalarBackend{"Scalar", FindScalar, FindAllScalar,
+                                           CountScalar};
+/** SSE4.2 backend */
+inline constexpr ScanBackend Sse42Backend{"Sse42", FindSse42, FindAllSse42,
+                                          CountSse42};
+/** AVX2 backend */
+inline constexpr ScanBackend Avx2Backend{"Avx2", FindAvx2, FindAllAvx2,
+                                         CountAvx2};
+/** AVX-512BW backend */
+inline constexpr ScanBackend Avx512Backend{"Avx512", FindAvx512,
+                                           FindAllAvx512, CountAvx512};
+
+} // namespace LightningScanner
@@ -12,4 +12,6 @@ enum class ScanMode {
     Sse42,
     /** Scan mode that uses AVX2 SIMD instructions */
     Avx2,
+    /** Scan mode that uses AVX-512BW SIMD instructions */
+    Avx512,
 };
\ No newline at end of file
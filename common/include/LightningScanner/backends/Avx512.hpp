@@ -0,0 +1,46 @@
+#pragma once
+#include <LightningScanner/Pattern.hpp>
+#include <LightningScanner/ScanResult.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace LightningScanner {
+
+/**
+ * Scan the binary using AVX-512BW SIMD instructions.
+ *
+ * \headerfile Avx512.hpp <LightningScanner/backends/Avx512.hpp>
+ *
+ * \param{in} data pattern data.
+ * \param{in} startAddr address to start the search from
+ * \param{in} size binary size of the search area
+ */
+ScanResult FindAvx512(const Pattern& data, void* startAddr, size_t size);
+
+/**
+ * Find every occurrence of the pattern in the binary, using AVX-512BW SIMD instructions.
+ *
+ * Matches are returned in address order and may overlap.
+ *
+ * \headerfile Avx512.hpp <LightningScanner/backends/Avx512.hpp>
+ *
+ * \param{in} data pattern data.
+ * \param{in} startAddr address to start the search from
+ * \param{in} size binary size of the search area
+ * \param{in} maxCount stop after this many matches
+ */
+std::vector<ScanResult> FindAllAvx512(const Pattern& data, void* startAddr,
+                                      size_t size, size_t maxCount = SIZE_MAX);
+
+/**
+ * Count the occurrences of the pattern in the binary, using AVX-512BW SIMD instructions.
+ *
+ * \headerfile Avx512.hpp <LightningScanner/backends/Avx512.hpp>
+ *
+ * \param{in} data pattern data.
+ * \param{in} startAddr address to start the search from
+ * \param{in} size binary size of the search area
+ */
+size_t CountAvx512(const Pattern& data, void* startAddr, size_t size);
+
+} // namespace LightningScanner
\ No newline at end of file
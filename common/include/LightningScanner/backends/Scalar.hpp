@@ -1,6 +1,7 @@
 #pragma once
 #include <LightningScanner/Pattern.hpp>
 #include <LightningScanner/ScanResult.hpp>
+#include <cstdint>
 #include <vector>
 
 namespace LightningScanner {
@@ -16,4 +17,30 @@ namespace LightningScanner {
  */
 ScanResult FindScalar(const Pattern& data, void* startAddr, size_t size);
 
+/**
+ * Find every occurrence of the pattern in the binary, using scalar scanning.
+ *
+ * Matches are returned in address order and may overlap.
+ *
+ * \headerfile Scalar.hpp <LightningScanner/backends/Scalar.hpp>
+ *
+ * \param{in} data pattern data.
+ * \param{in} startAddr address to start the search from
+ * \param{in} size binary size of the search area
+ * \param{in} maxCount stop after this many matches
+ */
+std::vector<ScanResult> FindAllScalar(const Pattern& data, void* startAddr,
+                                      size_t size, size_t maxCount = SIZE_MAX);
+
+/**
+ * Count the occurrences of the pattern in the binary, using scalar scanning.
+ *
+ * \headerfile Scalar.hpp <LightningScanner/backends/Scalar.hpp>
+ *
+ * \param{in} data pattern data.
+ * \param{in} startAddr address to start the search from
+ * \param{in} size binary size of the search area
+ */
+size_t CountScalar(const Pattern& data, void* startAddr, size_t size);
+
 } // namespace LightningScanner
\ No newline at end of file
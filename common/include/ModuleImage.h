@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace HookUtils {
+	// A PE image with its headers parsed once and its section table cached.
+	// Does not depend on Windows headers, so an executable on disk can be inspected on any platform.
+	class ModuleImage {
+	public:
+		struct Section {
+			std::string name;
+			uint32_t rva = 0;
+			uint32_t virtualSize = 0;
+			uint32_t characteristics = 0;
+
+			// IMAGE_SCN_MEM_EXECUTE or IMAGE_SCN_CNT_CODE
+			bool IsExecutable() const;
+		};
+
+		ModuleImage(const ModuleImage&) = delete;
+		ModuleImage& operator=(const ModuleImage&) = delete;
+		ModuleImage(ModuleImage&&) = default;
+		ModuleImage& operator=(ModuleImage&&) = default;
+
+		// Parse a module the loader has mapped: base is its HMODULE
+		static std::optional<ModuleImage> FromMemory(const void* base, std::string* error = nullptr);
+
+		// Read a PE file and lay its sections out at their RVAs, like the loader does (no relocations or imports)
+		static std::optional<ModuleImage> FromFile(const std::filesystem::path& path, std::string* error = nullptr);
+
+		std::byte* Base() const { return base_; }
+		uint32_t SizeOfImage() const { return sizeOfImage_; }
+		uint32_t TimeDateStamp() const { return timeDateStamp_; }
+		uint32_t CheckSum() const { return checkSum_; }
+		std::span<const Section> Sections() const { return sections_; }
+
+		// Section by name, e.g. ".text"
+		const Section* FindSection(std::string_view name) const;
+
+		// Section containing the RVA, if any
+		const Section* SectionAt(uint32_t rva) const;
+
+		// Bytes of [rva, rva + size), clamped to the image; empty if rva is outside it
+		std::span<std::byte> Range(uint32_t rva, size_t size) const;
+
+		// Bytes of a section, clamped to the image
+		std::span<std::byte> SectionBytes(const Section& section) const;
+
+		// Executable sections in address order, with sections that follow each other merged into one range
+		// so a pattern across their boundary is still found
+		const std::vector<std::span<std::byte>>& CodeRanges() const { return codeRanges_; }
+
+		// Code range containing the address, if any
+		std::optional<std::span<std::byte>> CodeRangeAt(const void* address) const;
+
+	private:
+		ModuleImage() = default;
+
+		static std::optional<ModuleImage> Parse(std::byte* base, size_t headerBytes, std::string* error);
+
+		std::vector<std::byte> storage_;
+		std::byte* base_ = nullptr;
+		uint32_t sizeOfImage_ = 0;
+		uint32_t sectionAlignment_ = 0;
+		uint32_t timeDateStamp_ = 0;
+		uint32_t checkSum_ = 0;
+		std::vector<Section> sections_;
+		std::vector<std::span<std::byte>> codeRanges_;
+	};
+}
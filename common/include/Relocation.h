@@ -311,7 +311,13 @@ private:
 
 } // namespace REL
 
+#ifndef FORCE_INLINE
+#if defined(_MSC_VER)
 #define FORCE_INLINE __forceinline
+#else
+#define FORCE_INLINE inline __attribute__((always_inline))
+#endif
+#endif
 
 #define DEF_MEMBER_FN(fnName, retnType, addr, ...)                             \
   template <class... Params>                                                   \
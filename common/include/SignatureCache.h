@@ -0,0 +1,44 @@
+#pragma once
+#include "ModuleImage.h"
+#include <LightningScanner/Pattern.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace HookUtils {
+	// Pattern matches resolved on earlier launches, persisted to a small text file.
+	// The file belongs to one build of the executable: it is keyed by TimeDateStamp, CheckSum and SizeOfImage,
+	// and its entries are dropped when any of them changes.
+	// Does not depend on Windows headers, like ModuleImage.
+	class SignatureCache {
+	public:
+		// Load the cache for image from path; a missing, unreadable or stale file gives an empty cache
+		static SignatureCache Load(std::filesystem::path path, const ModuleImage& image);
+
+		// Cache key of a signature lookup, including the offsets applied to its match
+		static std::string MakeKey(std::string_view signature, int32_t offset, int32_t relOffset, int32_t instructionLength);
+
+		// RVA of the match stored for key, if the pattern still matches there inside a code range of image
+		std::optional<uint32_t> Lookup(std::string_view key, const LightningScanner::Pattern& pattern, const ModuleImage& image) const;
+
+		void Store(std::string_view key, uint32_t rva);
+
+		// Write every entry to the file if anything changed since it was loaded or last saved
+		bool Save(std::string* error = nullptr);
+
+		size_t Size() const { return entries_.size(); }
+
+	private:
+		SignatureCache() = default;
+
+		std::filesystem::path path_;
+		uint32_t timeDateStamp_ = 0;
+		uint32_t checkSum_ = 0;
+		uint32_t sizeOfImage_ = 0;
+		std::unordered_map<std::string, uint32_t> entries_;
+		bool dirty_ = false;
+	};
+}
@@ -1,7 +1,15 @@
 #define NOMINMAX
 #include "HookUtils.h"
+#include "FileUtils.h"
+#include "LogUtils.h"
+#include "SignatureCache.h"
 #include "LightningScanner/LightningScanner.hpp"
+#include "LightningScanner/MultiScanner.hpp"
+#include <algorithm>
 #include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
 
 namespace HookUtils {
 void *LookupCallee(void *caller, void *callee, bool stopAtCC,
@@ -38,8 +46,15 @@ void *LookupCallee(void *caller, void *callee, bool stopAtCC,
 }
 
 uintptr_t LookupFunctionPattern(void *func, std::string_view signature, uint32_t scanSize) {
+	size_t size = scanSize;
+	if (auto image = GetMainModuleImage()) {
+		// Don't run past the end of the function's section into data
+		if (auto range = image->CodeRangeAt(func)) {
+			size = std::min<size_t>(size, range->data() + range->size() - (std::byte*)func);
+		}
+	}
 	const auto scanner = LightningScanner::Scanner(signature);
-	return (uintptr_t)scanner.Find(func, scanSize).Get<std::byte*>();
+	return (uintptr_t)scanner.Find(func, size).Get<std::byte*>();
 }
 
 std::optional<size_t> GetModuleSize(HMODULE module) {
@@ -65,24 +80,212 @@ std::optional<size_t> GetModuleSize(HMODULE module) {
 	return ntHeaders->OptionalHeader.SizeOfImage;
 }
 
-uintptr_t ScanIDAPattern(std::string_view signature, int32_t offset, int32_t relOffset, int32_t instructionLength) {
-	using namespace LightningScanner;
-	const auto scanner = Scanner(signature);
-    auto module = GetModuleHandleA(nullptr);
-	auto moduleSize = GetModuleSize(module).value_or(0);
-	auto addr = (uintptr_t)scanner.Find(module, moduleSize).Get<std::byte*>();
+const ModuleImage* GetMainModuleImage() {
+	static const std::optional<ModuleImage> image = [] {
+		std::string error;
+		auto parsed = ModuleImage::FromMemory(GetModuleHandleA(nullptr), &error);
+		if (!parsed) {
+			_MESSAGE("Failed to parse the main module headers: %s", error.c_str());
+		}
+		return parsed;
+	}();
+	return image ? &*image : nullptr;
+}
+
+// Code ranges of the main module, or the whole image if its headers could not be parsed
+static std::vector<std::span<std::byte>> MainModuleScanRanges() {
+	if (auto image = GetMainModuleImage(); image && !image->CodeRanges().empty()) {
+		return image->CodeRanges();
+	}
+	auto module = GetModuleHandleA(nullptr);
+	return { std::span<std::byte>((std::byte*)module, GetModuleSize(module).value_or(0)) };
+}
+
+// Matches resolved on earlier launches, kept in "<plugin>.sigcache" next to the plugin
+// Only a cache hit whose bytes still match the pattern is used, so a stale entry costs one compare and a scan
+static std::mutex s_signatureCacheLock;
+
+static SignatureCache* GetSignatureCache() {
+	static std::optional<SignatureCache> cache = []() -> std::optional<SignatureCache> {
+		auto image = GetMainModuleImage();
+		auto path = FileUtils::GetCurrentModulePath();
+		if (!image || path.empty()) {
+			return std::nullopt;
+		}
+		return SignatureCache::Load(path.replace_extension(".sigcache"), *image);
+	}();
+	return cache ? &*cache : nullptr;
+}
+
+static uintptr_t LookupCachedMatch(const std::string& key, const LightningScanner::Pattern& pattern) {
+	std::lock_guard lock(s_signatureCacheLock);
+	auto cache = GetSignatureCache();
+	if (!cache) {
+		return 0;
+	}
+	auto image = GetMainModuleImage();
+	auto rva = cache->Lookup(key, pattern, *image);
+	return rva ? (uintptr_t)image->Base() + *rva : 0;
+}
+
+// Remember the matches found by a scan; misses are not cached so they are scanned again next launch
+// Only the in-memory cache changes; SaveSignatureCache writes the file
+static void StoreCachedMatches(std::span<const std::string> keys, std::span<const uintptr_t> addrs) {
+	std::lock_guard lock(s_signatureCacheLock);
+	auto cache = GetSignatureCache();
+	if (!cache) {
+		return;
+	}
+	auto base = (uintptr_t)GetMainModuleImage()->Base();
+	for (size_t i = 0; i < keys.size(); i++) {
+		if (addrs[i]) {
+			cache->Store(keys[i], (uint32_t)(addrs[i] - base));
+		}
+	}
+}
+
+void SaveSignatureCache() {
+	std::lock_guard lock(s_signatureCacheLock);
+	auto cache = GetSignatureCache();
+	std::string error;
+	if (cache && !cache->Save(&error)) {
+		_MESSAGE("Failed to save the signature cache: %s", error.c_str());
+	}
+}
+
+static uintptr_t ApplyPatternOffsets(uintptr_t addr, int32_t offset, int32_t relOffset, int32_t instructionLength) {
 	if (addr) {
 		addr += offset;
 		if (relOffset > 0 && instructionLength != 0) {
 			addr = ReadOffsetData(addr, relOffset, instructionLength);
 		}
 	}
+	return addr;
+}
+
+uintptr_t ScanIDAPattern(std::string_view signature, int32_t offset, int32_t relOffset, int32_t instructionLength) {
+	using namespace LightningScanner;
+	const auto pattern = Pattern(signature);
+	const auto key = SignatureCache::MakeKey(signature, offset, relOffset, instructionLength);
+	uintptr_t addr = LookupCachedMatch(key, pattern);
+	if (!addr) {
+		// Single-threaded: REL::Pattern resolves during the DLL's static init, under the loader lock,
+		// where a FindParallel worker could never start and its join would hang the game
+		const auto scanner = Scanner(pattern);
+		for (auto& range : MainModuleScanRanges()) {
+			addr = (uintptr_t)scanner.Find(range.data(), range.size()).Get<std::byte*>();
+			if (addr) {
+				break;
+			}
+		}
+		StoreCachedMatches({ &key, 1 }, { &addr, 1 });
+	}
   // if (!addr) {
   //   throw std::runtime_error("failed to find pattern: " + std::string(signature));
   // }
-	return addr;
+	return ApplyPatternOffsets(addr, offset, relOffset, instructionLength);
+}
+
+uintptr_t ScanUniqueIDAPattern(std::string_view signature, int32_t offset, int32_t relOffset, int32_t instructionLength) {
+	// Enough matches to show in the log; the scan stops at this many
+	constexpr size_t kMaxMatchesLogged = 8;
+
+	using namespace LightningScanner;
+	const auto pattern = Pattern(signature);
+	const auto key = SignatureCache::MakeKey(signature, offset, relOffset, instructionLength);
+	// The ambiguity was logged on the launch that scanned it
+	if (auto cached = LookupCachedMatch(key, pattern)) {
+		return ApplyPatternOffsets(cached, offset, relOffset, instructionLength);
+	}
+
+	const auto scanner = Scanner(pattern);
+	std::vector<ScanResult> matches;
+	for (auto& range : MainModuleScanRanges()) {
+		auto found = scanner.FindAll(range.data(), range.size(), kMaxMatchesLogged - matches.size());
+		matches.insert(matches.end(), found.begin(), found.end());
+		if (matches.size() == kMaxMatchesLogged) {
+			break;
+		}
+	}
+	if (matches.empty()) {
+		return 0;
+	}
+
+	auto addr = (uintptr_t)matches.front().Get<std::byte*>();
+	StoreCachedMatches({ &key, 1 }, { &addr, 1 });
+	if (matches.size() > 1) {
+		auto module = (std::byte*)GetModuleHandleA(nullptr);
+		std::string rvas;
+		for (auto& match : matches) {
+			char rva[16];
+			snprintf(rva, sizeof(rva), " 0x%08llX", (unsigned long long)(match.Get<std::byte>() - module));
+			rvas += rva;
+		}
+		_MESSAGE("Ambiguous pattern: %.*s matches %zu%s times, using the first. RVAs:%s", (int)signature.size(),
+			signature.data(), matches.size(), matches.size() == kMaxMatchesLogged ? "+" : "", rvas.c_str());
+	}
+	return ApplyPatternOffsets(addr, offset, relOffset, instructionLength);
 }
 
+std::vector<uintptr_t> ScanIDAPatterns(std::span<const IDAPattern> patterns) {
+	using namespace LightningScanner;
+	std::vector<uintptr_t> found(patterns.size(), 0);
+	std::vector<std::string> missedKeys;
+	std::vector<Pattern> missed;
+	std::vector<size_t> missedIndices;
+	for (size_t i = 0; i < patterns.size(); i++) {
+		const auto& pattern = patterns[i];
+		auto key = SignatureCache::MakeKey(pattern.signature, pattern.offset, pattern.relOffset, pattern.instructionLength);
+		auto compiled = Pattern(pattern.signature);
+		found[i] = LookupCachedMatch(key, compiled);
+		if (!found[i]) {
+			missedKeys.push_back(std::move(key));
+			missed.push_back(std::move(compiled));
+			missedIndices.push_back(i);
+		}
+	}
+
+	// Only the patterns the cache could not answer go through the scan
+	if (!missed.empty()) {
+		std::vector<uintptr_t> scanned(missedIndices.size(), 0);
+		// Indices into scanned of the patterns no earlier range has resolved; each range gets a scanner of just those
+		std::vector<size_t> unresolved(missed.size());
+		for (size_t i = 0; i < unresolved.size(); i++) {
+			unresolved[i] = i;
+		}
+		for (auto& range : MainModuleScanRanges()) {
+			std::vector<Pattern> pending;
+			pending.reserve(unresolved.size());
+			for (size_t i : unresolved) {
+				pending.push_back(missed[i]);
+			}
+			auto results = MultiScanner(std::move(pending)).Find(range.data(), range.size());
+			std::vector<size_t> stillUnresolved;
+			for (size_t i = 0; i < unresolved.size(); i++) {
+				scanned[unresolved[i]] = (uintptr_t)results[i].Get<std::byte*>();
+				if (!scanned[unresolved[i]]) {
+					stillUnresolved.push_back(unresolved[i]);
+				}
+			}
+			unresolved = std::move(stillUnresolved);
+			if (unresolved.empty()) {
+				break;
+			}
+		}
+		StoreCachedMatches(missedKeys, scanned);
+		for (size_t i = 0; i < scanned.size(); i++) {
+			found[missedIndices[i]] = scanned[i];
+		}
+	}
+
+	std::vector<uintptr_t> addrs;
+	addrs.reserve(patterns.size());
+	for (size_t i = 0; i < patterns.size(); i++) {
+		const auto& pattern = patterns[i];
+		addrs.push_back(ApplyPatternOffsets(found[i], pattern.offset, pattern.relOffset, pattern.instructionLength));
+	}
+	return addrs;
+}
 
 bool SafeReadBuf(uintptr_t addr, void *data, size_t len) {
   DWORD oldProtect;
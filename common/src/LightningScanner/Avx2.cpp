@@ -1,46 +1,123 @@
 #include <LightningScanner/backends/Avx2.hpp>
+#include <bit>
 #include <immintrin.h>
 
 namespace LightningScanner {
 
-ScanResult FindAvx2(const Pattern& patternData, void* startAddr, size_t size) {
-    constexpr size_t UNIT_SIZE = 32;
-
-    size_t processedSize = 0;
-
-    __m256i pattern = _mm256_load_si256((__m256i*)patternData.data.data());
-    __m256i mask = _mm256_load_si256((__m256i*)patternData.mask.data());
-    __m256i allZeros = _mm256_set1_epi8(0x00);
-
-    for (size_t chunk = 0; chunk < size; chunk++) {
-        __m256i chunkData =
-            _mm256_loadu_si256((__m256i*)((char*)startAddr + chunk));
-
-        __m256i blend = _mm256_blendv_epi8(allZeros, chunkData, mask);
-        __m256i eq = _mm256_cmpeq_epi8(pattern, blend);
-
-        if (_mm256_movemask_epi8(eq) == 0xffffffff) {
-            processedSize += UNIT_SIZE;
-
-            if (processedSize < patternData.unpaddedSize) {
-                chunk += UNIT_SIZE - 1;
-                pattern = _mm256_load_si256(
-                    (__m256i*)(patternData.data.data() + processedSize));
-                mask = _mm256_load_si256(
-                    (__m256i*)(patternData.mask.data() + processedSize));
-            } else {
-                char* matchAddr =
-                    (char*)startAddr + chunk - processedSize + UNIT_SIZE;
-                return ScanResult((void*)matchAddr);
-            }
-        } else {
-            pattern = _mm256_load_si256((__m256i*)patternData.data.data());
-            mask = _mm256_load_si256((__m256i*)patternData.mask.data());
-            processedSize = 0;
+namespace {
+
+constexpr size_t UNIT_SIZE = 32;
+
+/** Needs patternData.data.size() readable bytes at addr */
+bool MatchesAvx2(const Pattern& patternData, const uint8_t* addr) {
+    for (size_t offset = 0; offset < patternData.data.size();
+         offset += UNIT_SIZE) {
+        __m256i chunkData = _mm256_loadu_si256((const __m256i*)(addr + offset));
+        __m256i pattern =
+            _mm256_load_si256((const __m256i*)(patternData.data.data() + offset));
+        __m256i mask =
+            _mm256_load_si256((const __m256i*)(patternData.mask.data() + offset));
+
+        __m256i eq =
+            _mm256_cmpeq_epi8(pattern, _mm256_and_si256(chunkData, mask));
+        if ((uint32_t)_mm256_movemask_epi8(eq) != 0xffffffff)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Call onMatch with every match in address order until it returns false.
+ */
+template <typename OnMatch>
+void ScanAvx2(const Pattern& patternData, const uint8_t* binary, size_t size,
+              OnMatch&& onMatch) {
+    const size_t patternSize = patternData.unpaddedSize;
+    if (patternSize > size)
+        return;
+
+    // Every start in [0, lastStart] leaves room for the whole pattern.
+    const size_t lastStart = size - patternSize;
+    if (patternData.anchorOffset == patternSize) {
+        for (size_t start = 0; start <= lastStart; start++) {
+            if (!onMatch(binary + start))
+                return;
         }
+        return;
     }
 
-    return ScanResult(nullptr);
+    const size_t anchor = patternData.anchorOffset;
+    const size_t secondAnchor = patternData.secondAnchorOffset;
+    const __m256i anchorByte =
+        _mm256_set1_epi8((char)patternData.data[anchor]);
+    const __m256i secondAnchorByte =
+        _mm256_set1_epi8((char)patternData.data[secondAnchor]);
+
+    // Test both anchor bytes for 32 starts at once, then verify the
+    // candidates. The anchors are inside the pattern, so the loads stay
+    // within the search area.
+    size_t start = 0;
+    for (; start + UNIT_SIZE <= lastStart + 1; start += UNIT_SIZE) {
+        __m256i first =
+            _mm256_loadu_si256((const __m256i*)(binary + start + anchor));
+        __m256i second =
+            _mm256_loadu_si256((const __m256i*)(binary + start + secondAnchor));
+        __m256i hits = _mm256_and_si256(_mm256_cmpeq_epi8(first, anchorByte),
+                                        _mm256_cmpeq_epi8(second, secondAnchorByte));
+
+        for (uint32_t candidates = (uint32_t)_mm256_movemask_epi8(hits);
+             candidates != 0; candidates &= candidates - 1) {
+            const size_t candidate = start + std::countr_zero(candidates);
+            const uint8_t* addr = binary + candidate;
+            if ((candidate + patternData.data.size() <= size
+                     ? MatchesAvx2(patternData, addr)
+                     : patternData.Matches(addr)) &&
+                !onMatch(addr))
+                return;
+        }
+    }
+
+    for (; start <= lastStart; start++) {
+        if (binary[start + anchor] == patternData.data[anchor] &&
+            patternData.Matches(binary + start) && !onMatch(binary + start))
+            return;
+    }
+}
+
+} // namespace
+
+ScanResult FindAvx2(const Pattern& patternData, void* startAddr, size_t size) {
+    const uint8_t* found = nullptr;
+    ScanAvx2(patternData, (const uint8_t*)startAddr, size,
+             [&](const uint8_t* addr) {
+                 found = addr;
+                 return false;
+             });
+    return ScanResult((void*)found);
+}
+
+std::vector<ScanResult> FindAllAvx2(const Pattern& patternData, void* startAddr,
+                                    size_t size, size_t maxCount) {
+    std::vector<ScanResult> results;
+    if (maxCount == 0)
+        return results;
+
+    ScanAvx2(patternData, (const uint8_t*)startAddr, size,
+             [&](const uint8_t* addr) {
+                 results.emplace_back((void*)addr);
+                 return results.size() < maxCount;
+             });
+    return results;
+}
+
+size_t CountAvx2(const Pattern& patternData, void* startAddr, size_t size) {
+    size_t count = 0;
+    ScanAvx2(patternData, (const uint8_t*)startAddr, size,
+             [&](const uint8_t*) {
+                 ++count;
+                 return true;
+             });
+    return count;
 }
 
-} // namespace LightningScanner
\ No newline at end of file
+} // namespace LightningScanner
@@ -0,0 +1,123 @@
+#include <LightningScanner/backends/Avx512.hpp>
+#include <bit>
+#include <immintrin.h>
+
+namespace LightningScanner {
+
+namespace {
+
+constexpr size_t UNIT_SIZE = 64;
+
+/** Lanes [0, count) of a 64-byte unit, count <= UNIT_SIZE */
+__mmask64 LaneMask(size_t count) {
+    return count >= UNIT_SIZE ? ~(__mmask64)0 : ((__mmask64)1 << count) - 1;
+}
+
+/**
+ * Needs only patternData.unpaddedSize readable bytes at addr: the loads are
+ * masked to the pattern, and masked-off lanes are never touched.
+ */
+bool MatchesAvx512(const Pattern& patternData, const uint8_t* addr) {
+    for (size_t offset = 0; offset < patternData.unpaddedSize;
+         offset += UNIT_SIZE) {
+        const __mmask64 lanes = LaneMask(patternData.unpaddedSize - offset);
+        __m512i chunkData = _mm512_maskz_loadu_epi8(lanes, addr + offset);
+        __m512i pattern =
+            _mm512_maskz_loadu_epi8(lanes, patternData.data.data() + offset);
+        __m512i mask =
+            _mm512_maskz_loadu_epi8(lanes, patternData.mask.data() + offset);
+
+        if (_mm512_mask_cmpneq_epi8_mask(
+                lanes, pattern, _mm512_and_si512(chunkData, mask)) != 0)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Call onMatch with every match in address order until it returns false.
+ */
+template <typename OnMatch>
+void ScanAvx512(const Pattern& patternData, const uint8_t* binary, size_t size,
+                OnMatch&& onMatch) {
+    const size_t patternSize = patternData.unpaddedSize;
+    if (patternSize > size)
+        return;
+
+    // Every start in [0, lastStart] leaves room for the whole pattern.
+    const size_t lastStart = size - patternSize;
+    if (patternData.anchorOffset == patternSize) {
+        for (size_t start = 0; start <= lastStart; start++) {
+            if (!onMatch(binary + start))
+                return;
+        }
+        return;
+    }
+
+    const size_t anchor = patternData.anchorOffset;
+    const size_t secondAnchor = patternData.secondAnchorOffset;
+    const __m512i anchorByte =
+        _mm512_set1_epi8((char)patternData.data[anchor]);
+    const __m512i secondAnchorByte =
+        _mm512_set1_epi8((char)patternData.data[secondAnchor]);
+
+    // Test both anchor bytes for 64 starts at once, then verify the
+    // candidates. The last iteration masks off the starts past lastStart, so
+    // no scalar tail is needed and nothing outside the area is read.
+    for (size_t start = 0; start <= lastStart; start += UNIT_SIZE) {
+        const __mmask64 lanes = LaneMask(lastStart + 1 - start);
+        __m512i first = _mm512_maskz_loadu_epi8(lanes, binary + start + anchor);
+        __m512i second =
+            _mm512_maskz_loadu_epi8(lanes, binary + start + secondAnchor);
+        __mmask64 hits = _mm512_mask_cmpeq_epi8_mask(
+            _mm512_mask_cmpeq_epi8_mask(lanes, first, anchorByte), second,
+            secondAnchorByte);
+
+        for (uint64_t candidates = (uint64_t)hits; candidates != 0;
+             candidates &= candidates - 1) {
+            const uint8_t* addr = binary + start + std::countr_zero(candidates);
+            if (MatchesAvx512(patternData, addr) && !onMatch(addr))
+                return;
+        }
+    }
+}
+
+} // namespace
+
+ScanResult FindAvx512(const Pattern& patternData, void* startAddr,
+                      size_t size) {
+    const uint8_t* found = nullptr;
+    ScanAvx512(patternData, (const uint8_t*)startAddr, size,
+               [&](const uint8_t* addr) {
+                   found = addr;
+                   return false;
+               });
+    return ScanResult((void*)found);
+}
+
+std::vector<ScanResult> FindAllAvx512(const Pattern& patternData,
+                                      void* startAddr, size_t size,
+                                      size_t maxCount) {
+    std::vector<ScanResult> results;
+    if (maxCount == 0)
+        return results;
+
+    ScanAvx512(patternData, (const uint8_t*)startAddr, size,
+               [&](const uint8_t* addr) {
+                   results.emplace_back((void*)addr);
+                   return results.size() < maxCount;
+               });
+    return results;
+}
+
+size_t CountAvx512(const Pattern& patternData, void* startAddr, size_t size) {
+    size_t count = 0;
+    ScanAvx512(patternData, (const uint8_t*)startAddr, size,
+               [&](const uint8_t*) {
+                   ++count;
+                   return true;
+               });
+    return count;
+}
+
+} // namespace LightningScanner
@@ -6,11 +6,17 @@ namespace LightningScanner {
 #if defined(_MSC_VER) && !defined(__clang__)
 #include <intrin.h>
 #define cpuid(info, x) __cpuidex(info, x, 0)
+#define xgetbv(index) _xgetbv(index)
 #else
 #include <cpuid.h>
 void cpuid(int info[4], int infoType) {
     __cpuid_count(infoType, 0, info[0], info[1], info[2], info[3]);
 }
+uint64_t xgetbv(uint32_t index) {
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+    return ((uint64_t)edx << 32) | eax;
+}
 #endif
 
 CpuInfo::CpuInfo() {
@@ -18,22 +24,39 @@ CpuInfo::CpuInfo() {
     cpuid(info, 0);
     int32_t idsAmount = info[0];
 
+    // Register state the OS saves on context switches (XCR0), and so allows
+    // the instructions that use it.
+    uint64_t enabledState = 0;
+
     if (idsAmount >= 1) {
         const int32_t SSE42_MASK = (1 << 20);
+        const int32_t OSXSAVE_MASK = (1 << 27);
 
         int32_t cpuInfo[4];
         cpuid(cpuInfo, 1);
 
         sse42Supported = cpuInfo[2] & SSE42_MASK;
+        if (cpuInfo[2] & OSXSAVE_MASK)
+            enabledState = xgetbv(0);
     }
 
     if (idsAmount >= 7) {
         const int32_t AVX2_MASK = (1 << 5);
+        const int32_t AVX512F_MASK = (1 << 16);
+        const int32_t AVX512BW_MASK = (1 << 30);
+        // XMM and YMM state
+        const uint64_t AVX_STATE = 0x06;
+        // XMM, YMM, opmask, upper ZMM0-15 and ZMM16-31 state
+        const uint64_t AVX512_STATE = 0xE6;
 
         int32_t cpuInfo[4];
         cpuid(cpuInfo, 7);
 
-        avx2Supported = cpuInfo[1] & AVX2_MASK;
+        avx2Supported = (cpuInfo[1] & AVX2_MASK) &&
+                        (enabledState & AVX_STATE) == AVX_STATE;
+        avx512Supported = (cpuInfo[1] & AVX512F_MASK) &&
+                          (cpuInfo[1] & AVX512BW_MASK) &&
+                          (enabledState & AVX512_STATE) == AVX512_STATE;
     }
 }
 
@@ -42,4 +65,4 @@ const CpuInfo& CpuInfo::GetCpuInfo() {
     return info;
 }
 
-} // namespace LightningScanner
\ No newline at end of file
+} // namespace LightningScanner
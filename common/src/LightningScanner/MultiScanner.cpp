@@ -0,0 +1,122 @@
+#include <LightningScanner/ByteFrequency.hpp>
+#include <LightningScanner/MultiScanner.hpp>
+#include <bit>
+#include <utility>
+#include <emmintrin.h>
+
+namespace LightningScanner {
+
+namespace {
+
+/** Anchor bytes compared per 16-byte block before falling back to a table lookup per byte */
+constexpr size_t VectorAnchorLimit = 8;
+/** How much more common than a pattern's rarest byte a shared anchor byte may be */
+constexpr uint8_t SharedAnchorSlack = 24;
+
+} // namespace
+
+MultiScanner::MultiScanner(std::vector<Pattern> patterns)
+    : m_Patterns(std::move(patterns)) {
+    m_AnchorOffsets.resize(m_Patterns.size());
+
+    for (uint32_t index = 0; index < m_Patterns.size(); index++) {
+        const Pattern& pattern = m_Patterns[index];
+
+        const size_t rarest = pattern.anchorOffset;
+        if (rarest == pattern.unpaddedSize) {
+            m_UnanchoredPatterns.push_back(index);
+            continue;
+        }
+
+        // Fewer distinct anchor bytes keep the block compare short, so reuse
+        // one that is already taken if it is nearly as rare.
+        size_t anchor = rarest;
+        const int limit =
+            ByteFrequency[pattern.data[rarest]] + SharedAnchorSlack;
+        for (size_t i = 0; i < pattern.unpaddedSize; i++) {
+            if (pattern.mask[i] != 0x00 &&
+                ByteFrequency[pattern.data[i]] <= limit &&
+                !m_PatternsByAnchor[pattern.data[i]].empty()) {
+                anchor = i;
+                break;
+            }
+        }
+
+        const uint8_t anchorByte = pattern.data[anchor];
+        if (m_PatternsByAnchor[anchorByte].empty())
+            m_AnchorBytes.push_back(anchorByte);
+        m_PatternsByAnchor[anchorByte].push_back(index);
+        m_AnchorOffsets[index] = anchor;
+    }
+}
+
+std::vector<ScanResult> MultiScanner::Find(void* startAddr,
+                                           size_t size) const {
+    const uint8_t* binary = (const uint8_t*)startAddr;
+    std::vector<const uint8_t*> matches(m_Patterns.size(), nullptr);
+
+    for (uint32_t index : m_UnanchoredPatterns) {
+        if (m_Patterns[index].unpaddedSize <= size)
+            matches[index] = binary;
+    }
+
+    size_t remaining = 0;
+    for (const auto& anchored : m_PatternsByAnchor) {
+        for (uint32_t index : anchored) {
+            if (m_Patterns[index].unpaddedSize <= size)
+                ++remaining;
+        }
+    }
+
+    // A pattern's anchor sits at a fixed offset, so the first verified
+    // candidate of each pattern is also its lowest-address match.
+    const auto verify = [&](size_t position) {
+        for (uint32_t index : m_PatternsByAnchor[binary[position]]) {
+            const Pattern& pattern = m_Patterns[index];
+            const size_t anchor = m_AnchorOffsets[index];
+            if (matches[index] != nullptr || position < anchor ||
+                pattern.unpaddedSize > size ||
+                position - anchor > size - pattern.unpaddedSize)
+                continue;
+
+            if (pattern.Matches(binary + position - anchor)) {
+                matches[index] = binary + position - anchor;
+                --remaining;
+            }
+        }
+    };
+
+    size_t position = 0;
+    if (m_AnchorBytes.size() <= VectorAnchorLimit) {
+        constexpr size_t UNIT_SIZE = 16;
+
+        __m128i anchors[VectorAnchorLimit];
+        for (size_t i = 0; i < m_AnchorBytes.size(); i++)
+            anchors[i] = _mm_set1_epi8((char)m_AnchorBytes[i]);
+
+        for (; remaining != 0 && position + UNIT_SIZE <= size;
+             position += UNIT_SIZE) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)(binary + position));
+            __m128i hits = _mm_setzero_si128();
+            for (size_t i = 0; i < m_AnchorBytes.size(); i++)
+                hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, anchors[i]));
+
+            for (uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+                 mask != 0 && remaining != 0; mask &= mask - 1)
+                verify(position + std::countr_zero(mask));
+        }
+    }
+
+    for (; remaining != 0 && position < size; position++) {
+        if (!m_PatternsByAnchor[binary[position]].empty())
+            verify(position);
+    }
+
+    std::vector<ScanResult> results;
+    results.reserve(matches.size());
+    for (const uint8_t* match : matches)
+        results.emplace_back((void*)match);
+    return results;
+}
+
+} // namespace LightningScanner
@@ -0,0 +1,67 @@
+#include <LightningScanner/ParallelScan.hpp>
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace LightningScanner {
+
+namespace {
+
+constexpr size_t MaxDefaultThreads = 8;
+
+} // namespace
+
+ScanResult FindParallel(const Pattern& data, FindFunction find, void* startAddr,
+                        size_t size, size_t threadCount, size_t chunkSize) {
+    if (threadCount == 0)
+        threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(),
+                                         1, MaxDefaultThreads);
+    chunkSize = std::max<size_t>(chunkSize, 1);
+
+    const size_t chunkCount = size / chunkSize + (size % chunkSize != 0);
+    threadCount = std::min(threadCount, chunkCount);
+    if (threadCount <= 1)
+        return find(data, startAddr, size);
+
+    uint8_t* binary = (uint8_t*)startAddr;
+    const size_t overlap = data.unpaddedSize == 0 ? 0 : data.unpaddedSize - 1;
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<size_t> bestOffset{std::numeric_limits<size_t>::max()};
+
+    const auto worker = [&]() {
+        for (;;) {
+            const size_t begin = nextChunk.fetch_add(1) * chunkSize;
+            // Chunks are handed out in address order, so once one ahead of
+            // this one has matched, nothing later can win.
+            if (begin >= size || begin >= bestOffset.load())
+                return;
+
+            const size_t end = std::min(size, begin + chunkSize + overlap);
+            uint8_t* match = find(data, binary + begin, end - begin).Get<uint8_t>();
+            if (match == nullptr)
+                continue;
+
+            const size_t offset = (size_t)(match - binary);
+            size_t best = bestOffset.load();
+            while (offset < best &&
+                   !bestOffset.compare_exchange_weak(best, offset)) {
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; i++)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    const size_t best = bestOffset.load();
+    return ScanResult(best == std::numeric_limits<size_t>::max() ? nullptr
+                                                                 : binary + best);
+}
+
+} // namespace LightningScanner
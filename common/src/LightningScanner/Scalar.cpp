@@ -1,30 +1,59 @@
-#include <LightningScanner/backends/Sse42.hpp>
+#include <LightningScanner/backends/Scalar.hpp>
 
 namespace LightningScanner {
 
+namespace {
+
+/**
+ * Call onMatch with every match in address order until it returns false.
+ */
+template <typename OnMatch>
+void ScanScalar(const Pattern& patternData, uint8_t* binary, size_t size,
+                OnMatch&& onMatch) {
+    if (patternData.unpaddedSize > size)
+        return;
+
+    for (size_t binaryOffset = 0;
+         binaryOffset <= size - patternData.unpaddedSize; ++binaryOffset) {
+        if (patternData.Matches(binary + binaryOffset) &&
+            !onMatch(binary + binaryOffset))
+            return;
+    }
+}
+
+} // namespace
+
 ScanResult FindScalar(const Pattern& patternData, void* startAddr,
                       size_t size) {
-    uint8_t* binary = (uint8_t*)startAddr;
-
-    for (size_t binaryOffset = 0; binaryOffset < size; ++binaryOffset) {
-        bool found = true;
-        for (size_t patternOffset = 0; patternOffset < patternData.data.size();
-             patternOffset++) {
-            if (patternData.mask[patternOffset] == 0x00)
-                continue;
-            if (*(binary + binaryOffset + patternOffset) !=
-                patternData.data[patternOffset]) {
-                found = false;
-                break;
-            }
-        }
-
-        if (found) {
-            return ScanResult((void*)(binary + binaryOffset));
-        }
-    }
+    uint8_t* found = nullptr;
+    ScanScalar(patternData, (uint8_t*)startAddr, size, [&](uint8_t* addr) {
+        found = addr;
+        return false;
+    });
+    return ScanResult((void*)found);
+}
+
+std::vector<ScanResult> FindAllScalar(const Pattern& patternData,
+                                      void* startAddr, size_t size,
+                                      size_t maxCount) {
+    std::vector<ScanResult> results;
+    if (maxCount == 0)
+        return results;
+
+    ScanScalar(patternData, (uint8_t*)startAddr, size, [&](uint8_t* addr) {
+        results.emplace_back((void*)addr);
+        return results.size() < maxCount;
+    });
+    return results;
+}
 
-    return ScanResult(nullptr);
+size_t CountScalar(const Pattern& patternData, void* startAddr, size_t size) {
+    size_t count = 0;
+    ScanScalar(patternData, (uint8_t*)startAddr, size, [&](uint8_t*) {
+        ++count;
+        return true;
+    });
+    return count;
 }
 
-} // namespace LightningScanner
\ No newline at end of file
+} // namespace LightningScanner
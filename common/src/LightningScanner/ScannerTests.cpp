@@ -0,0 +1,345 @@
+#include <LightningScanner/CpuInfo.hpp>
+#include <LightningScanner/LightningScanner.hpp>
+#include <LightningScanner/MultiScanner.hpp>
+#include <LightningScanner/ParallelScan.hpp>
+#include <LightningScanner/ScanBackend.hpp>
+#include <ModuleImage.h>
+#include <SignatureCache.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace LightningScanner;
+
+namespace {
+
+// Independent of Pattern::Matches: every start whose pattern bytes fit inside the area.
+std::vector<const uint8_t*> FindAllReference(const std::vector<int>& pattern, const uint8_t* binary, size_t size) {
+    std::vector<const uint8_t*> matches;
+    for (size_t start = 0; start + pattern.size() <= size; ++start) {
+        bool found = true;
+        for (size_t i = 0; i < pattern.size() && found; ++i) {
+            found = pattern[i] < 0 || binary[start + i] == pattern[i];
+        }
+        if (found) {
+            matches.push_back(binary + start);
+        }
+    }
+    return matches;
+}
+
+bool SameMatches(std::vector<ScanResult> results, const std::vector<const uint8_t*>& expected) {
+    if (results.size() != expected.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].Get<uint8_t>() != expected[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string ToSignature(const std::vector<int>& pattern) {
+    std::string signature;
+    for (int byte : pattern) {
+        char text[4];
+        std::snprintf(text, sizeof(text), byte < 0 ? "? " : "%02X ", byte);
+        signature += text;
+    }
+    return signature;
+}
+
+std::vector<ScanBackend> SupportedBackends() {
+    const CpuInfo& cpuInfo = CpuInfo::GetCpuInfo();
+    std::vector<ScanBackend> backends{ScalarBackend};
+    if (cpuInfo.sse42Supported) {
+        backends.push_back(Sse42Backend);
+    }
+    if (cpuInfo.avx2Supported) {
+        backends.push_back(Avx2Backend);
+    }
+    if (cpuInfo.avx512Supported) {
+        backends.push_back(Avx512Backend);
+    }
+    return backends;
+}
+
+template <class T>
+void Put(std::vector<uint8_t>& bytes, size_t offset, T value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+// A PE32+ file with two adjacent code sections, .rdata, and a code section whose
+// VirtualSize runs past SizeOfImage.
+std::vector<uint8_t> MakePeFile() {
+    struct SectionSpec {
+        const char* name;
+        uint32_t rva, virtualSize, rawSize, rawOffset, characteristics;
+    };
+    const SectionSpec sections[] = {
+        {".text", 0x1000, 0x800, 0x400, 0x400, 0x60000020},
+        {"PAGE", 0x2000, 0x300, 0x400, 0x800, 0x60000020},
+        {".rdata", 0x3000, 0x200, 0x200, 0xC00, 0x40000040},
+        {".stub", 0x4000, 0x3000, 0x200, 0xE00, 0x60000020},
+    };
+
+    std::vector<uint8_t> file(0x1000);
+    Put<uint16_t>(file, 0, 0x5A4D);
+    Put<uint32_t>(file, 0x3C, 0x40);
+    Put<uint32_t>(file, 0x40, 0x00004550);
+    Put<uint16_t>(file, 0x44, 0x8664);
+    Put<uint16_t>(file, 0x46, static_cast<uint16_t>(std::size(sections)));
+    Put<uint32_t>(file, 0x48, 0x5EED1234);
+    Put<uint16_t>(file, 0x54, 240);
+    Put<uint16_t>(file, 0x58, 0x20B);
+    Put<uint32_t>(file, 0x58 + 32, 0x1000);
+    Put<uint32_t>(file, 0x58 + 56, 0x6000);
+    Put<uint32_t>(file, 0x58 + 60, 0x400);
+    Put<uint32_t>(file, 0x58 + 64, 0xC0FFEE);
+    size_t header = 0x58 + 240;
+    for (const auto& section : sections) {
+        std::memcpy(file.data() + header, section.name, std::strlen(section.name));
+        Put<uint32_t>(file, header + 8, section.virtualSize);
+        Put<uint32_t>(file, header + 12, section.rva);
+        Put<uint32_t>(file, header + 16, section.rawSize);
+        Put<uint32_t>(file, header + 20, section.rawOffset);
+        Put<uint32_t>(file, header + 36, section.characteristics);
+        header += 40;
+    }
+
+    // One signature in .text, another only in .rdata
+    const uint8_t code[] = {0x48, 0x8B, 0x05, 0x11, 0x22, 0x33, 0x44};
+    const uint8_t data[] = {0x4C, 0x8D, 0x0D, 0x55, 0x66, 0x77, 0x88};
+    std::memcpy(file.data() + 0x410, code, sizeof(code));
+    std::memcpy(file.data() + 0xC20, data, sizeof(data));
+    return file;
+}
+
+const char* CheckModuleImage() {
+    using HookUtils::ModuleImage;
+
+    const auto path = std::filesystem::temp_directory_path() / "LightningScannerTests.exe";
+    const std::vector<uint8_t> file = MakePeFile();
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+    std::string error;
+    auto image = ModuleImage::FromFile(path, &error);
+    if (!image) {
+        return "FromFile rejected a valid image";
+    }
+    if (image->Sections().size() != 4 || image->SizeOfImage() != 0x6000 || image->TimeDateStamp() != 0x5EED1234 ||
+        image->CheckSum() != 0xC0FFEE || image->FindSection(".rdata") == nullptr ||
+        image->FindSection(".rdata")->rva != 0x3000 || image->FindSection(".rdata")->IsExecutable()) {
+        return "headers or section table parsed wrong";
+    }
+    if (image->SectionAt(0x2100) == nullptr || image->SectionAt(0x2100)->name != "PAGE" ||
+        image->SectionAt(0x2400) != nullptr) {
+        return "SectionAt";
+    }
+    if (image->Range(0x5F00, 0x1000).size() != 0x100 || !image->Range(0x6000, 1).empty()) {
+        return "Range is not clamped to SizeOfImage";
+    }
+    std::byte* base = image->Base();
+    if (base[0x1010] != std::byte{0x48} || base[0x1400] != std::byte{0} || base[0x3020] != std::byte{0x4C}) {
+        return "sections not laid out at their RVAs";
+    }
+
+    // .text and PAGE merge across the alignment gap; .stub is clamped to the image
+    const auto& ranges = image->CodeRanges();
+    if (ranges.size() != 2 || ranges[0].data() != base + 0x1000 || ranges[0].size() != 0x1300 ||
+        ranges[1].data() != base + 0x4000 || ranges[1].size() != 0x2000) {
+        return "CodeRanges";
+    }
+    const auto at = image->CodeRangeAt(base + 0x1FFF);
+    if (!at || at->data() != ranges[0].data() || image->CodeRangeAt(base + 0x3000)) {
+        return "CodeRangeAt";
+    }
+
+    const Scanner inCode("48 8B 05 ? 22 33 44");
+    const Scanner inData("4C 8D 0D ? 66 77 88");
+    size_t codeHits = 0;
+    size_t dataHits = 0;
+    for (const auto& range : ranges) {
+        codeHits += inCode.Count(range.data(), range.size());
+        dataHits += inData.Count(range.data(), range.size());
+    }
+    if (codeHits != 1 || dataHits != 0 || inData.Count(base, image->SizeOfImage()) != 1) {
+        return "scanning CodeRanges";
+    }
+
+    auto mapped = ModuleImage::FromMemory(base);
+    if (!mapped || mapped->Sections().size() != 4 || mapped->CodeRanges().size() != ranges.size() ||
+        mapped->CodeRanges()[1].data() != ranges[1].data() || mapped->CodeRanges()[1].size() != ranges[1].size()) {
+        return "FromMemory disagrees with FromFile";
+    }
+
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), 0x100);
+    error.clear();
+    if (ModuleImage::FromFile(path, &error) || error.empty()) {
+        return "FromFile accepted truncated headers";
+    }
+    std::filesystem::remove(path);
+    if (ModuleImage::FromFile(path, &error)) {
+        return "FromFile accepted a missing file";
+    }
+    return nullptr;
+}
+
+const char* CheckSignatureCache() {
+    using HookUtils::ModuleImage;
+    using HookUtils::SignatureCache;
+
+    const auto directory = std::filesystem::temp_directory_path();
+    const auto imagePath = directory / "LightningScannerTests.exe";
+    const auto cachePath = directory / "LightningScannerTests.sigcache";
+    std::vector<uint8_t> file = MakePeFile();
+    std::ofstream(imagePath, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+    auto image = ModuleImage::FromFile(imagePath);
+    std::filesystem::remove(cachePath);
+    if (!image) {
+        return "FromFile rejected a valid image";
+    }
+
+    const Pattern code("48 8B 05 ? 22 33 44");
+    const Pattern data("4C 8D 0D ? 66 77 88");
+    const std::string codeKey = SignatureCache::MakeKey("48 8B 05 ? 22 33 44", 3, 3, 7);
+    const std::string dataKey = SignatureCache::MakeKey("4C 8D 0D ? 66 77 88", 0, 0, 0);
+    auto cache = SignatureCache::Load(cachePath, *image);
+    if (cache.Size() != 0 || cache.Lookup(codeKey, code, *image)) {
+        return "a missing file gave entries";
+    }
+    cache.Store(codeKey, 0x1010);
+    cache.Store(dataKey, 0x3020);
+    cache.Store(SignatureCache::MakeKey("48 8B 05 ? 22 33 44", 0, 0, 0), 0x5FFE);
+    if (!cache.Save()) {
+        return "Save failed";
+    }
+
+    auto reloaded = SignatureCache::Load(cachePath, *image);
+    if (reloaded.Size() != 3 || reloaded.Lookup(codeKey, code, *image) != 0x1010u) {
+        return "entries did not survive a reload";
+    }
+    // Offsets are part of the key; entries outside code or at the end of the image are rejected
+    if (reloaded.Lookup(SignatureCache::MakeKey("48 8B 05 ? 22 33 44", 3, 3, 0), code, *image) ||
+        reloaded.Lookup(dataKey, data, *image) ||
+        reloaded.Lookup(SignatureCache::MakeKey("48 8B 05 ? 22 33 44", 0, 0, 0), code, *image)) {
+        return "Lookup accepted an entry it should reject";
+    }
+    image->Base()[0x1015] = std::byte{0x90};
+    if (reloaded.Lookup(codeKey, code, *image)) {
+        return "Lookup accepted bytes that no longer match";
+    }
+
+    // Another build of the executable invalidates the whole file
+    file[0x48] ^= 1;
+    std::ofstream(imagePath, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+    auto rebuilt = ModuleImage::FromFile(imagePath);
+    std::filesystem::remove(imagePath);
+    if (!rebuilt || SignatureCache::Load(cachePath, *rebuilt).Size() != 0) {
+        return "entries of another build were kept";
+    }
+    std::filesystem::remove(cachePath);
+    return nullptr;
+}
+
+}  // namespace
+
+#ifdef LIGHTNINGSCANNER_TEST_MAIN
+int main() {
+    const std::vector<ScanBackend> backends = SupportedBackends();
+    std::mt19937 rng(0x5CA11u);
+
+    // Small alphabets give many partial matches; lengths past 64 cover multi-unit verification,
+    // and patterns are cut from the buffer so most of them match, often right at its end.
+    for (int iteration = 0; iteration < 4000; ++iteration) {
+        const size_t size = rng() % 3000;
+        const unsigned alphabet = 1 + rng() % (iteration % 4 == 0 ? 255 : 4);
+        std::vector<uint8_t> buffer(size + 1);
+        for (auto& byte : buffer) {
+            byte = static_cast<uint8_t>(0xC3 + rng() % alphabet);
+        }
+
+        std::vector<std::vector<int>> patterns;
+        std::vector<Pattern> compiled;
+        for (int count = 1 + rng() % 8; count > 0; --count) {
+            std::vector<int> pattern(1 + rng() % 80);
+            const size_t at = size == 0 ? 0 : rng() % size;
+            const bool tail = rng() % 4 == 0;
+            for (size_t i = 0; i < pattern.size(); ++i) {
+                const size_t source = tail && pattern.size() <= size ? size - pattern.size() + i : at + i;
+                if (rng() % 5 == 0) {
+                    pattern[i] = -1;
+                } else if (source < size && rng() % 64 != 0) {
+                    pattern[i] = buffer[source];
+                } else {
+                    pattern[i] = static_cast<uint8_t>(0xC3 + rng() % alphabet);
+                }
+            }
+            patterns.push_back(pattern);
+            compiled.emplace_back(ToSignature(pattern));
+        }
+
+        auto multiResults = MultiScanner(compiled).Find(buffer.data(), size);
+        for (size_t index = 0; index < patterns.size(); ++index) {
+            const auto allExpected = FindAllReference(patterns[index], buffer.data(), size);
+            const uint8_t* expected = allExpected.empty() ? nullptr : allExpected.front();
+            const size_t maxCount = 1 + rng() % 4;
+            const std::vector<const uint8_t*> firstExpected(
+                allExpected.begin(), allExpected.begin() + std::min(maxCount, allExpected.size()));
+            for (const auto& backend : backends) {
+                if (!SameMatches(backend.findAll(compiled[index], buffer.data(), size, SIZE_MAX), allExpected) ||
+                    !SameMatches(backend.findAll(compiled[index], buffer.data(), size, maxCount), firstExpected) ||
+                    !backend.findAll(compiled[index], buffer.data(), size, 0).empty() ||
+                    backend.count(compiled[index], buffer.data(), size) != allExpected.size()) {
+                    std::cerr << "[FAIL] " << backend.name << " FindAll/Count disagree with the reference for \""
+                              << ToSignature(patterns[index]) << "\" in " << size << " bytes.\n";
+                    return 1;
+                }
+                if (backend.find(compiled[index], buffer.data(), size).Get<uint8_t>() != expected) {
+                    std::cerr << "[FAIL] " << backend.name << " disagrees with the reference for \""
+                              << ToSignature(patterns[index]) << "\" in " << size << " bytes.\n";
+                    return 1;
+                }
+                // Chunks shorter than the pattern put matches across every kind of boundary.
+                const size_t chunkSize = 1 + rng() % 96;
+                if (FindParallel(compiled[index], backend.find, buffer.data(), size, 4, chunkSize).Get<uint8_t>() !=
+                    expected) {
+                    std::cerr << "[FAIL] Parallel " << backend.name << " disagrees with the reference for \""
+                              << ToSignature(patterns[index]) << "\" in " << size << " bytes, " << chunkSize
+                              << "-byte chunks.\n";
+                    return 1;
+                }
+            }
+            if (multiResults[index].Get<uint8_t>() != expected) {
+                std::cerr << "[FAIL] MultiScanner disagrees with the reference for \""
+                          << ToSignature(patterns[index]) << "\" in " << size << " bytes.\n";
+                return 1;
+            }
+        }
+    }
+
+    if (const char* failure = CheckModuleImage()) {
+        std::cerr << "[FAIL] ModuleImage: " << failure << ".\n";
+        return 1;
+    }
+    if (const char* failure = CheckSignatureCache()) {
+        std::cerr << "[FAIL] SignatureCache: " << failure << ".\n";
+        return 1;
+    }
+
+    std::cout << "[PASS] LightningScanner tests passed (";
+    for (size_t i = 0; i < backends.size(); ++i) {
+        std::cout << (i == 0 ? "" : ", ") << backends[i].name;
+    }
+    std::cout << ", parallel, MultiScanner, ModuleImage, SignatureCache).\n";
+    return 0;
+}
+#endif
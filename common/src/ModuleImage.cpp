@@ -0,0 +1,262 @@
+#include "ModuleImage.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace HookUtils {
+	namespace {
+		constexpr uint16_t kDosSignature = 0x5A4D;		// "MZ"
+		constexpr uint32_t kNtSignature = 0x00004550;	// "PE\0\0"
+		constexpr uint16_t kPe32Magic = 0x10B;
+		constexpr uint16_t kPe32PlusMagic = 0x20B;
+		constexpr uint32_t kScnCntCode = 0x00000020;
+		constexpr uint32_t kScnMemExecute = 0x20000000;
+
+		// e_lfanew sits at 0x3C in the DOS header; real images keep the NT headers within the first page or so
+		constexpr size_t kDosLfanewOffset = 0x3C;
+		constexpr uint32_t kMaxLfanew = 0x10000;
+
+		// Optional header fields we use sit at the same offsets in PE32 and PE32+
+		constexpr size_t kOptionalSectionAlignment = 32;
+		constexpr size_t kOptionalSizeOfImage = 56;
+		constexpr size_t kOptionalSizeOfHeaders = 60;
+		constexpr size_t kOptionalCheckSum = 64;
+		constexpr size_t kMinOptionalHeaderSize = 68;
+
+#pragma pack(push, 1)
+		struct FileHeader {
+			uint16_t machine;
+			uint16_t numberOfSections;
+			uint32_t timeDateStamp;
+			uint32_t pointerToSymbolTable;
+			uint32_t numberOfSymbols;
+			uint16_t sizeOfOptionalHeader;
+			uint16_t characteristics;
+		};
+
+		struct SectionHeader {
+			char name[8];
+			uint32_t virtualSize;
+			uint32_t virtualAddress;
+			uint32_t sizeOfRawData;
+			uint32_t pointerToRawData;
+			uint32_t pointerToRelocations;
+			uint32_t pointerToLinenumbers;
+			uint16_t numberOfRelocations;
+			uint16_t numberOfLinenumbers;
+			uint32_t characteristics;
+		};
+#pragma pack(pop)
+		static_assert(sizeof(FileHeader) == 20);
+		static_assert(sizeof(SectionHeader) == 40);
+
+		struct Headers {
+			uint32_t sizeOfImage = 0;
+			uint32_t sizeOfHeaders = 0;
+			uint32_t sectionAlignment = 0;
+			uint32_t timeDateStamp = 0;
+			uint32_t checkSum = 0;
+			std::vector<SectionHeader> sections;
+		};
+
+		void SetError(std::string* error, std::string_view message) {
+			if (error != nullptr) {
+				*error = std::string(message);
+			}
+		}
+
+		template <class T>
+		T ReadAt(const std::byte* bytes, size_t offset) {
+			T value{};
+			std::memcpy(&value, bytes + offset, sizeof(T));
+			return value;
+		}
+
+		// available: bytes readable at image (the whole file, or unbounded for a mapped module)
+		bool ParseHeaders(const std::byte* image, size_t available, Headers* out, std::string* error) {
+			if (available < kDosLfanewOffset + sizeof(uint32_t) || ReadAt<uint16_t>(image, 0) != kDosSignature) {
+				SetError(error, "Missing DOS header.");
+				return false;
+			}
+			const auto lfanew = ReadAt<uint32_t>(image, kDosLfanewOffset);
+			const size_t fileHeaderOffset = size_t{lfanew} + sizeof(uint32_t);
+			if (lfanew > kMaxLfanew || available < fileHeaderOffset + sizeof(FileHeader) ||
+				ReadAt<uint32_t>(image, lfanew) != kNtSignature) {
+				SetError(error, "Missing NT headers.");
+				return false;
+			}
+
+			const auto fileHeader = ReadAt<FileHeader>(image, fileHeaderOffset);
+			const size_t optionalOffset = fileHeaderOffset + sizeof(FileHeader);
+			const size_t sectionsOffset = optionalOffset + fileHeader.sizeOfOptionalHeader;
+			if (fileHeader.sizeOfOptionalHeader < kMinOptionalHeaderSize ||
+				available < sectionsOffset + size_t{fileHeader.numberOfSections} * sizeof(SectionHeader)) {
+				SetError(error, "Truncated PE headers.");
+				return false;
+			}
+			const auto magic = ReadAt<uint16_t>(image, optionalOffset);
+			if (magic != kPe32Magic && magic != kPe32PlusMagic) {
+				SetError(error, "Unknown optional header magic.");
+				return false;
+			}
+
+			out->sizeOfImage = ReadAt<uint32_t>(image, optionalOffset + kOptionalSizeOfImage);
+			out->sizeOfHeaders = ReadAt<uint32_t>(image, optionalOffset + kOptionalSizeOfHeaders);
+			out->sectionAlignment = ReadAt<uint32_t>(image, optionalOffset + kOptionalSectionAlignment);
+			out->checkSum = ReadAt<uint32_t>(image, optionalOffset + kOptionalCheckSum);
+			out->timeDateStamp = fileHeader.timeDateStamp;
+			if (out->sizeOfHeaders > out->sizeOfImage || sectionsOffset > out->sizeOfHeaders) {
+				SetError(error, "PE header sizes are inconsistent.");
+				return false;
+			}
+
+			out->sections.resize(fileHeader.numberOfSections);
+			for (size_t i = 0; i < out->sections.size(); i++) {
+				out->sections[i] = ReadAt<SectionHeader>(image, sectionsOffset + i * sizeof(SectionHeader));
+			}
+			return true;
+		}
+
+		// The loader maps max(VirtualSize, SizeOfRawData) for old images that leave VirtualSize at 0
+		uint32_t MappedSize(const SectionHeader& header) {
+			return header.virtualSize != 0 ? header.virtualSize : header.sizeOfRawData;
+		}
+	}
+
+	bool ModuleImage::Section::IsExecutable() const {
+		return (characteristics & (kScnMemExecute | kScnCntCode)) != 0;
+	}
+
+	std::optional<ModuleImage> ModuleImage::FromMemory(const void* base, std::string* error) {
+		if (base == nullptr) {
+			SetError(error, "Module base is null.");
+			return std::nullopt;
+		}
+		return Parse((std::byte*)base, std::numeric_limits<size_t>::max(), error);
+	}
+
+	std::optional<ModuleImage> ModuleImage::FromFile(const std::filesystem::path& path, std::string* error) {
+		std::ifstream in(path, std::ios::binary | std::ios::ate);
+		if (!in) {
+			SetError(error, "Failed to open " + path.string());
+			return std::nullopt;
+		}
+		std::vector<std::byte> file((size_t)in.tellg());
+		in.seekg(0);
+		if (!in.read((char*)file.data(), (std::streamsize)file.size())) {
+			SetError(error, "Failed to read " + path.string());
+			return std::nullopt;
+		}
+
+		Headers headers;
+		if (!ParseHeaders(file.data(), file.size(), &headers, error)) {
+			return std::nullopt;
+		}
+
+		// Headers, then every section's raw data at its RVA; the rest stays zero like uninitialized data
+		std::vector<std::byte> storage(headers.sizeOfImage);
+		std::memcpy(storage.data(), file.data(), std::min<size_t>(headers.sizeOfHeaders, file.size()));
+		for (const auto& section : headers.sections) {
+			if (section.virtualAddress >= storage.size() || section.pointerToRawData >= file.size()) {
+				continue;
+			}
+			const size_t length = std::min({size_t{section.sizeOfRawData}, size_t{MappedSize(section)},
+				storage.size() - section.virtualAddress, file.size() - section.pointerToRawData});
+			std::memcpy(storage.data() + section.virtualAddress, file.data() + section.pointerToRawData, length);
+		}
+
+		auto image = Parse(storage.data(), storage.size(), error);
+		if (image) {
+			image->storage_ = std::move(storage);
+		}
+		return image;
+	}
+
+	std::optional<ModuleImage> ModuleImage::Parse(std::byte* base, size_t headerBytes, std::string* error) {
+		Headers headers;
+		if (!ParseHeaders(base, headerBytes, &headers, error)) {
+			return std::nullopt;
+		}
+
+		ModuleImage image;
+		image.base_ = base;
+		image.sizeOfImage_ = headers.sizeOfImage;
+		image.sectionAlignment_ = std::max<uint32_t>(headers.sectionAlignment, 1);
+		image.timeDateStamp_ = headers.timeDateStamp;
+		image.checkSum_ = headers.checkSum;
+		for (const auto& header : headers.sections) {
+			Section section;
+			section.name.assign(header.name, strnlen(header.name, sizeof(header.name)));
+			section.rva = header.virtualAddress;
+			section.virtualSize = MappedSize(header);
+			section.characteristics = header.characteristics;
+			image.sections_.push_back(std::move(section));
+		}
+
+		std::vector<const Section*> code;
+		for (const auto& section : image.sections_) {
+			if (section.IsExecutable() && !image.SectionBytes(section).empty()) {
+				code.push_back(&section);
+			}
+		}
+		std::sort(code.begin(), code.end(), [](const Section* a, const Section* b) { return a->rva < b->rva; });
+		for (const Section* section : code) {
+			const auto bytes = image.SectionBytes(*section);
+			auto& ranges = image.codeRanges_;
+			if (!ranges.empty()) {
+				// Sections are mapped at SectionAlignment, so the gap after one section is its own padding
+				const size_t previousEnd = (size_t)(ranges.back().data() + ranges.back().size() - base);
+				const size_t alignedEnd = (previousEnd + image.sectionAlignment_ - 1) / image.sectionAlignment_ *
+					image.sectionAlignment_;
+				if (section->rva <= alignedEnd) {
+					const size_t begin = (size_t)(ranges.back().data() - base);
+					const size_t end = std::max(previousEnd, (size_t)section->rva + bytes.size());
+					ranges.back() = std::span<std::byte>(base + begin, end - begin);
+					continue;
+				}
+			}
+			ranges.push_back(bytes);
+		}
+		return image;
+	}
+
+	const ModuleImage::Section* ModuleImage::FindSection(std::string_view name) const {
+		for (const auto& section : sections_) {
+			if (section.name == name) {
+				return &section;
+			}
+		}
+		return nullptr;
+	}
+
+	const ModuleImage::Section* ModuleImage::SectionAt(uint32_t rva) const {
+		for (const auto& section : sections_) {
+			if (rva >= section.rva && rva - section.rva < section.virtualSize) {
+				return &section;
+			}
+		}
+		return nullptr;
+	}
+
+	std::span<std::byte> ModuleImage::Range(uint32_t rva, size_t size) const {
+		if (rva >= sizeOfImage_) {
+			return {};
+		}
+		return std::span<std::byte>(base_ + rva, std::min<size_t>(size, sizeOfImage_ - rva));
+	}
+
+	std::span<std::byte> ModuleImage::SectionBytes(const Section& section) const {
+		return Range(section.rva, section.virtualSize);
+	}
+
+	std::optional<std::span<std::byte>> ModuleImage::CodeRangeAt(const void* address) const {
+		const auto* byte = (const std::byte*)address;
+		for (const auto& range : codeRanges_) {
+			if (byte >= range.data() && byte < range.data() + range.size()) {
+				return range;
+			}
+		}
+		return std::nullopt;
+	}
+}
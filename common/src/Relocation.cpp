@@ -34,8 +34,15 @@ RelocationManager::RelocationManager()
 
 std::uintptr_t REL::Pattern::address() const {
   auto expectedAddr = _offset.address();
+  // Patterns resolve during static init, before any INI is read; debug builds
+  // also scan every code range to flag signatures that became ambiguous
+#ifdef _DEBUG
+  auto actualAddr = HookUtils::ScanUniqueIDAPattern(_signature, _dstOffset,
+                                                    _dataOffset, _instructionLength);
+#else
   auto actualAddr = HookUtils::ScanIDAPattern(_signature, _dstOffset,
                                               _dataOffset, _instructionLength);
+#endif
   if (actualAddr == 0) {
     _MESSAGE("Pattern not found: %s dstOffset: %d dataOffset: %d "
              "instructionLength: %d",
@@ -0,0 +1,118 @@
+#include "SignatureCache.h"
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <system_error>
+
+namespace HookUtils {
+	namespace {
+		// First line of the file; bump the version when the line format changes
+		constexpr std::string_view kMagic = "SignatureCache";
+		constexpr int kVersion = 1;
+
+		void SetError(std::string* error, std::string_view message) {
+			if (error != nullptr) {
+				*error = std::string(message);
+			}
+		}
+	}
+
+	SignatureCache SignatureCache::Load(std::filesystem::path path, const ModuleImage& image) {
+		SignatureCache cache;
+		cache.path_ = std::move(path);
+		cache.timeDateStamp_ = image.TimeDateStamp();
+		cache.checkSum_ = image.CheckSum();
+		cache.sizeOfImage_ = image.SizeOfImage();
+
+		std::ifstream in(cache.path_);
+		std::string line;
+		if (!in || !std::getline(in, line)) {
+			return cache;
+		}
+		char magic[32] = {};
+		int version = 0;
+		uint32_t timeDateStamp = 0, checkSum = 0, sizeOfImage = 0;
+		if (sscanf(line.c_str(), "%31s %d %" SCNx32 " %" SCNx32 " %" SCNx32, magic, &version, &timeDateStamp, &checkSum,
+				&sizeOfImage) != 5 || magic != kMagic || version != kVersion || timeDateStamp != cache.timeDateStamp_ ||
+			checkSum != cache.checkSum_ || sizeOfImage != cache.sizeOfImage_) {
+			// Another build of the executable: every RVA in the file is meaningless now
+			cache.dirty_ = true;
+			return cache;
+		}
+
+		// "<rva> <key>", the key running to the end of the line
+		while (std::getline(in, line)) {
+			uint32_t rva = 0;
+			int keyStart = 0;
+			if (sscanf(line.c_str(), "%" SCNx32 " %n", &rva, &keyStart) == 1 && keyStart > 0 &&
+				(size_t)keyStart < line.size()) {
+				cache.entries_[line.substr(keyStart)] = rva;
+			}
+		}
+		return cache;
+	}
+
+	std::string SignatureCache::MakeKey(std::string_view signature, int32_t offset, int32_t relOffset, int32_t instructionLength) {
+		char offsets[48];
+		snprintf(offsets, sizeof(offsets), "%d %d %d ", offset, relOffset, instructionLength);
+		return offsets + std::string(signature);
+	}
+
+	std::optional<uint32_t> SignatureCache::Lookup(std::string_view key, const LightningScanner::Pattern& pattern, const ModuleImage& image) const {
+		auto it = entries_.find(std::string(key));
+		if (it == entries_.end() || it->second >= image.SizeOfImage()) {
+			return std::nullopt;
+		}
+		// The whole match has to sit inside one code range, like a scan would have found it
+		const auto* match = image.Base() + it->second;
+		auto range = image.CodeRangeAt(match);
+		if (!range || pattern.unpaddedSize > (size_t)(range->data() + range->size() - match) ||
+			!pattern.Matches((const uint8_t*)match)) {
+			return std::nullopt;
+		}
+		return it->second;
+	}
+
+	void SignatureCache::Store(std::string_view key, uint32_t rva) {
+		auto [it, inserted] = entries_.try_emplace(std::string(key), rva);
+		if (inserted || it->second != rva) {
+			it->second = rva;
+			dirty_ = true;
+		}
+	}
+
+	bool SignatureCache::Save(std::string* error) {
+		if (!dirty_) {
+			return true;
+		}
+
+		// Write a sibling file and swap it in, so a crash mid-write never leaves a torn cache
+		auto temp = path_;
+		temp += ".tmp";
+		{
+			std::ofstream out(temp, std::ios::trunc);
+			char header[96];
+			snprintf(header, sizeof(header), "%.*s %d %08" PRIX32 " %08" PRIX32 " %08" PRIX32 "\n", (int)kMagic.size(),
+				kMagic.data(), kVersion, timeDateStamp_, checkSum_, sizeOfImage_);
+			out << header;
+			for (const auto& [key, rva] : entries_) {
+				char prefix[16];
+				snprintf(prefix, sizeof(prefix), "%08" PRIX32 " ", rva);
+				out << prefix << key << '\n';
+			}
+			if (!out.flush()) {
+				SetError(error, "Failed to write " + temp.string());
+				return false;
+			}
+		}
+		std::error_code ec;
+		std::filesystem::rename(temp, path_, ec);
+		if (ec) {
+			std::filesystem::remove(temp, ec);
+			SetError(error, "Failed to replace " + path_.string());
+			return false;
+		}
+		dirty_ = false;
+		return true;
+	}
+}
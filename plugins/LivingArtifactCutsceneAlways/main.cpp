@@ -18,6 +18,7 @@ extern "C" __declspec(dllexport) bool nioh3_plugin_initialize(const Nioh3PluginI
     _MESSAGE("Plugin dir: %s", param->plugins_dir);
 
     auto addr = HookUtils::ScanIDAPattern("85 D2 74 ? 48 8B C4 48 89 58 ? 89 50 ? 57");
+    HookUtils::SaveSignatureCache();
     if (addr) {
         _MESSAGE("Found patch addr: %p", addr);
         static auto livingArtifactCutsceneAlwaysAnimateMidHook = safetyhook::create_mid(addr, [](SafetyHookContext& ctx) {
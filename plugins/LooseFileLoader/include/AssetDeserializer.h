@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Common.h"
+
+#include <cstdint>
+
+namespace LooseFileLoader {
+
+// GetFileKtIdFromRes result for assets the game cannot map to a file.
+inline constexpr std::uint32_t kInvalidFileKtid = 0xFFFFFFFF;
+
+// Body of the DeserializeAsset hook without the register plumbing and the game's fileKtid lookup:
+// serves fileKtid from its mod override when there is a valid one, otherwise runs the vanilla
+// Deserialize, and returns what Deserialize returned. Only the handler's and reader's virtuals
+// are called, so tools can drive it with stand-ins (tools/DeserializeHarness.cpp).
+void* DeserializeAsset(IBaseGameAssetHandler* assetHandler, AssetLoadingContext* loadingContext,
+                       AssetReader* assetReader, void* param3, std::uint32_t fileKtid);
+
+// IBaseGameAssetHandler::GetTypeName without the std::string copy; "Unknown" when unnamed.
+const char* GetAssetHandlerTypeName(const IBaseGameAssetHandler* assetHandler);
+
+}  // namespace LooseFileLoader
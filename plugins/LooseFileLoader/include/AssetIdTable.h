@@ -0,0 +1,97 @@
+#pragma once
+
+#include <LightningScanner/allocator/AlignedAllocator.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace LooseFileLoader {
+
+struct RdbEntry;
+
+// Offline replica of GameManager::AssetIdManager's fileKtid -> resFileId index.
+//
+// BuildFileKtidToResFileId radix-sorts the collected fileKtids and numbers the unique keys in
+// order, so a resFileId is the rank of its fileKtid. The keys are stored as a static k-ary
+// search tree: every node is one bucket of kKeysPerNode keys (bucketStrideBytes = 64, one
+// cache line) with kBranchFactor children. Layer 0 holds the sorted keys themselves, padded
+// to whole buckets; each layer above stores, per child, the smallest key of that subtree.
+// A lookup reads one bucket per layer and ranks the probe against it with SIMD compares.
+class AssetIdTable final {
+public:
+    static constexpr std::uint32_t kKeysPerNode = 16;
+    static constexpr std::uint32_t kBranchFactor = kKeysPerNode + 1;
+    static constexpr std::uint32_t kBucketStrideBytes = kKeysPerNode * sizeof(std::uint32_t);
+    static constexpr std::uint32_t kInvalidResId = 0xFFFFFFFFu;
+
+    AssetIdTable() = default;
+
+    // Duplicate keys collapse into one resFileId, as in the game.
+    static AssetIdTable Build(std::span<const std::uint32_t> fileKtids);
+    static AssetIdTable Build(std::span<const RdbEntry> entries);
+
+    // resFileId for fileKtid, or kInvalidResId.
+    [[nodiscard]] std::uint32_t Find(std::uint32_t fileKtid) const;
+    // Index of the first sorted key >= fileKtid (KeyCount() when none).
+    [[nodiscard]] std::uint32_t LowerBound(std::uint32_t fileKtid) const;
+
+    [[nodiscard]] std::span<const std::uint32_t> SortedKeys() const;
+    [[nodiscard]] std::uint32_t KeyCount() const;
+    [[nodiscard]] std::uint32_t TreeDepth() const;
+    // Layer-0 buckets covered by one key of the root bucket.
+    [[nodiscard]] std::uint32_t BranchSpan() const;
+    [[nodiscard]] std::size_t MemoryBytes() const;
+
+    // Number of layers a table with keyCount unique keys needs.
+    [[nodiscard]] static std::uint32_t DepthForKeyCount(std::uint32_t keyCount);
+
+private:
+    using NodeStorage = std::vector<std::uint32_t, LightningScanner::AlignedAllocator<std::uint32_t, 64>>;
+
+    void BuildLayers(std::vector<std::uint32_t> sortedUniqueKeys);
+
+    NodeStorage nodes_{};
+    // Start of every layer in nodes_, in keys; layer 0 (the sorted keys) first.
+    std::vector<std::uint32_t> layerOffsets_{};
+    std::uint32_t keyCount_ = 0;
+};
+
+// Field snapshot of a live GameManager::AssetIdManager, copied by the plugin so this check stays
+// independent of Common.h.
+struct AssetIdManagerLayout {
+    const std::uint32_t* sortedFileKtid = nullptr;
+    std::uint32_t keyCount = 0;
+    std::uint32_t keyCountCopy = 0;
+    std::uint32_t treeDepth = 0;
+    std::uint32_t stepPerDepth = 0;
+    std::uint32_t branchFactor = 0;
+    std::uint32_t branchSpan = 0;
+    std::uint32_t bucketStrideBytes = 0;
+};
+
+struct AssetIdLayoutReport {
+    bool keysSorted = false;
+    bool strideMatchesBranchFactor = false;
+    bool depthMatchesKeyCount = false;
+    std::size_t sampledLookups = 0;
+    std::size_t lookupMismatches = 0;
+    std::vector<std::string> issues{};
+
+    [[nodiscard]] bool Ok() const {
+        return keysSorted && lookupMismatches == 0;
+    }
+};
+
+// Checks our reading of the live table: sortedFileKtid must be strictly ascending over keyCount
+// keys, and gameLookup (GetResIdByFileKtid) must return the rank for up to sampleCount evenly
+// spaced keys. The stride/depth fields are compared with what a bucket of
+// (branchFactor - 1) keys implies and reported in `issues` if they differ.
+AssetIdLayoutReport ValidateAssetIdManagerLayout(const AssetIdManagerLayout& layout,
+                                                 const std::function<std::uint32_t(std::uint32_t)>& gameLookup = {},
+                                                 std::size_t sampleCount = 256);
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace LooseFileLoader {
+
+// Trace image (little-endian):
+//   AssetLoadTraceHeader
+//   AssetLoadTraceRecord[]   in the order they were flushed, up to the end of the file
+#pragma pack(push, 1)
+struct AssetLoadTraceHeader {
+    char magic[4] = {'L', 'F', 'A', 'T'};
+    std::uint32_t version = 1;
+    std::uint32_t recordSize = 32;
+    std::uint32_t reserved = 0;
+};
+
+// One Deserialize call as seen by the DeserializeAsset hook.
+struct AssetLoadTraceRecord {
+    // When Deserialize was entered, relative to AssetLoadTrace::Start.
+    std::uint64_t startNanoseconds = 0;
+    // Bytes handed to Deserialize: the override's size, or the archive's asset size.
+    std::uint64_t size = 0;
+    // 0xFFFFFFFF when the game could not map the asset to a fileKtid.
+    std::uint32_t fileKtid = 0;
+    std::uint32_t typeInfoKtid = 0;
+    // How long Deserialize took, saturated at ~4.3 s.
+    std::uint32_t nanoseconds = 0;
+    // Small per-trace number of the loading thread, in order of its first load.
+    std::uint16_t threadIndex = 0;
+    std::uint16_t flags = 0;
+};
+#pragma pack(pop)
+static_assert(sizeof(AssetLoadTraceHeader) == 16);
+static_assert(sizeof(AssetLoadTraceRecord) == 32);
+
+// AssetLoadTraceRecord::flags
+inline constexpr std::uint16_t kAssetLoadTraceOverride = 0x0001;
+
+// Records every asset load to a compact binary file, for replaying the game's load pattern
+// offline (tools/AssetTraceReplay.cpp).
+//
+// Record only appends to a pending buffer under a short lock; a writer thread moves the buffer
+// to disk a few times a second, so a crash loses at most the last flush interval.
+class AssetLoadTrace final {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds kFlushInterval{250};
+
+    AssetLoadTrace();
+    AssetLoadTrace(const AssetLoadTrace&) = delete;
+    AssetLoadTrace& operator=(const AssetLoadTrace&) = delete;
+    ~AssetLoadTrace();
+
+    [[nodiscard]] bool IsEnabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    // Truncates path and starts recording; timestamps count from here.
+    bool Start(const std::filesystem::path& path, std::string* error = nullptr);
+    // Blocks until every recorded load is on disk. False when a write failed; recording stopped
+    // at that point.
+    bool Stop(std::string* error = nullptr);
+
+    void Record(Clock::time_point start, Clock::time_point end, std::uint32_t fileKtid, std::uint32_t typeInfoKtid,
+                std::uint64_t size, bool isOverride);
+
+    // Records sorted by startNanoseconds (flush order follows the end of each load instead).
+    static std::optional<std::vector<AssetLoadTraceRecord>> Load(const std::filesystem::path& path,
+                                                                 std::string* error = nullptr);
+
+private:
+    struct Writer;
+
+    [[nodiscard]] std::uint16_t LocalThreadIndex();
+
+    // Keys the per-thread index cache, which must not mistake a new instance at a reused address.
+    const std::uint64_t id_;
+    std::atomic<bool> enabled_{false};
+    Clock::time_point origin_{};
+    std::atomic<std::uint32_t> nextThreadIndex_{0};
+    std::unique_ptr<Writer> writer_;
+};
+
+inline AssetLoadTrace g_assetLoadTrace;
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace LooseFileLoader {
+
+// One Deserialize call as seen by the DeserializeAsset hook.
+struct AssetLoadSample {
+    std::uint32_t typeInfoKtid = 0;
+    // The asset handler; its vtable keys the type-name cache. Only dereferenced by the dumper.
+    const void* handler = nullptr;
+    std::uint64_t bytes = 0;
+    std::uint64_t nanoseconds = 0;
+    bool isOverride = false;
+};
+
+// Latency bucket b holds loads of [2^(b-1), 2^b) ns (bucket 0: under 1 ns); the last bucket also
+// takes everything slower.
+inline constexpr std::size_t kAssetLatencyBuckets = 32;
+
+struct AssetLoadStats {
+    std::uint64_t count = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t totalNanoseconds = 0;
+    std::uint64_t maxNanoseconds = 0;
+    std::array<std::uint64_t, kAssetLatencyBuckets> histogram{};
+
+    // Upper bound of the bucket holding the given fraction of loads; 0 when empty.
+    [[nodiscard]] std::uint64_t PercentileNanoseconds(double fraction) const;
+};
+
+struct AssetTypeTelemetry {
+    std::uint32_t typeInfoKtid = 0;
+    const void* handler = nullptr;
+    AssetLoadStats vanilla{};
+    AssetLoadStats overrides{};
+};
+
+struct AssetTelemetrySnapshot {
+    std::size_t threadCount = 0;
+    // Sorted by typeInfoKtid.
+    std::vector<AssetTypeTelemetry> types{};
+    // Loads that found every per-thread type slot taken; not split by type.
+    AssetLoadStats untracked{};
+};
+
+// Per-type asset load counters for profiling load hitches.
+//
+// Record touches only the calling thread's own table: a fixed open-addressed array of per-type
+// counters, written with relaxed atomic stores by that thread alone, so recording takes no lock
+// and shares no cache line. Snapshot sums every thread's table from any thread while loads keep
+// running. Type names are resolved only when JSON is written, once per handler vtable.
+class AssetTelemetry final {
+public:
+    using Clock = std::chrono::steady_clock;
+    // Returns the type name of an asset handler; called on the dumping thread.
+    using TypeNameResolver = std::function<std::string(const void* handler)>;
+
+    // Distinct typeInfoKtids tracked per thread.
+    static constexpr std::size_t kTypesPerThread = 256;
+
+    AssetTelemetry();
+    AssetTelemetry(const AssetTelemetry&) = delete;
+    AssetTelemetry& operator=(const AssetTelemetry&) = delete;
+    ~AssetTelemetry();
+
+    [[nodiscard]] bool IsEnabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    void SetEnabled(bool enabled) {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    void Record(const AssetLoadSample& sample);
+    [[nodiscard]] AssetTelemetrySnapshot Snapshot() const;
+
+    [[nodiscard]] std::string ToJson(const AssetTelemetrySnapshot& snapshot, const TypeNameResolver& resolver = {});
+    bool WriteJson(const std::filesystem::path& path, const TypeNameResolver& resolver = {}, std::string* error = nullptr);
+
+    // Enables recording and writes the JSON every interval (never when it is zero) and on
+    // StopDumping.
+    bool StartDumping(const std::filesystem::path& path, std::chrono::seconds interval, TypeNameResolver resolver,
+                      std::string* error = nullptr);
+    // Blocks until the dump thread has exited, then writes the final JSON.
+    void StopDumping();
+
+private:
+    struct ThreadTable;
+    struct Dumper;
+
+    ThreadTable& LocalTable();
+
+    // Keys the per-thread table cache, which must not mistake a new instance at a reused address.
+    const std::uint64_t id_;
+    std::atomic<bool> enabled_{false};
+    Clock::time_point created_{};
+    // Tables are never freed before the telemetry object: a thread that exits keeps its counts.
+    mutable std::mutex tablesMutex_{};
+    std::vector<std::unique_ptr<ThreadTable>> tables_{};
+    // handler vtable -> type name, filled while writing JSON.
+    std::mutex namesMutex_{};
+    std::unordered_map<const void*, std::string> typeNames_{};
+    std::unique_ptr<Dumper> dumper_;
+};
+
+inline AssetTelemetry g_assetTelemetry;
+
+}  // namespace LooseFileLoader
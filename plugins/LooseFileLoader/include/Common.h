@@ -1,5 +1,6 @@
 #pragma once
 
+#include "FileStreamReader.h"
 #include "Relocation.h"
 
 #include <cstdint>
@@ -13,6 +14,7 @@
 namespace LooseFileLoader {
 
 inline bool g_enableAssetLoadingLog = false;
+inline bool g_validateAssetIdTable = false;
 
 #pragma pack(push, 1)
 struct RDBDescriptor {
@@ -146,17 +148,6 @@ inline REL::Relocation<GameManager**> g_gameMain(REL::Pattern(0x4566990, "48 8B
 #pragma pack(pop)
 
 
-class IFileStreamReader {
-public:
-    virtual ~IFileStreamReader() = default;
-    virtual void Close() = 0;
-    virtual std::int64_t Skip(std::int64_t deltaBytes) = 0;
-    virtual std::uint64_t ReadByte(std::uint8_t* outByte) = 0;
-    virtual std::uint64_t Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) = 0;
-    virtual std::uint64_t GetID() const = 0;
-};
-
-
 class AssetReader : public IFileStreamReader {
 public:
     using ArchiveManager = GameManager::ArchiveManager;
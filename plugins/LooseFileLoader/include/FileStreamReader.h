@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace LooseFileLoader {
+
+// The game's stream interface handed to IBaseGameAssetHandler::Deserialize. Kept apart from
+// Common.h, which needs the game's relocations, so readers and tools build without the game.
+class IFileStreamReader {
+public:
+    virtual ~IFileStreamReader() = default;
+    virtual void Close() = 0;
+    virtual std::int64_t Skip(std::int64_t deltaBytes) = 0;
+    virtual std::uint64_t ReadByte(std::uint8_t* outByte) = 0;
+    virtual std::uint64_t Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) = 0;
+    virtual std::uint64_t GetID() const = 0;
+};
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace LooseFileLoader {
+
+// Read-only memory mapping of a whole file. Move-only; the view is unmapped on destruction.
+class MappedFile final {
+public:
+    static std::optional<MappedFile> Open(const std::filesystem::path& path, std::string* error = nullptr);
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    [[nodiscard]] std::span<const std::byte> Bytes() const;
+
+private:
+    MappedFile() = default;
+    void Close();
+
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+};
+
+}  // namespace LooseFileLoader
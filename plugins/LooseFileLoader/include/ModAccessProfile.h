@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace LooseFileLoader {
+
+// Profile image (little-endian):
+//   ModAccessProfileHeader
+//   std::uint32_t fileKtid[entryCount]   in the order the overrides were first loaded
+#pragma pack(push, 1)
+struct ModAccessProfileHeader {
+    char magic[4] = {'L', 'F', 'A', 'P'};
+    std::uint32_t version = 1;
+    std::uint32_t entryCount = 0;
+    std::uint32_t reserved = 0;
+};
+#pragma pack(pop)
+static_assert(sizeof(ModAccessProfileHeader) == 16);
+
+// The order in which mod overrides were hit in earlier sessions, for ModPrefetcher. Each fileKtid
+// appears once, at its first hit.
+class ModAccessProfile final {
+public:
+    static constexpr std::size_t kMaxEntries = 64 * 1024;
+    static constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+
+    ModAccessProfile() = default;
+    explicit ModAccessProfile(std::vector<std::uint32_t> order);
+
+    static std::optional<ModAccessProfile> Load(const std::filesystem::path& path, std::string* error = nullptr);
+    bool Save(const std::filesystem::path& path, std::string* error = nullptr) const;
+
+    // session's first hits in order, followed by the entries of previous that session never hit,
+    // so a short session does not forget the rest of an earlier one. Capped at kMaxEntries.
+    static ModAccessProfile Merge(std::span<const std::uint32_t> session, const ModAccessProfile& previous);
+
+    [[nodiscard]] std::span<const std::uint32_t> Order() const {
+        return order_;
+    }
+    [[nodiscard]] std::size_t Size() const {
+        return order_.size();
+    }
+    // Index of fileKtid in Order(), or kNotFound.
+    [[nodiscard]] std::size_t Position(std::uint32_t fileKtid) const;
+
+private:
+    std::vector<std::uint32_t> order_{};
+    std::unordered_map<std::uint32_t, std::uint32_t> positions_{};
+};
+
+}  // namespace LooseFileLoader
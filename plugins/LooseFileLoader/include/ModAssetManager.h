@@ -1,21 +1,49 @@
 #pragma once
 
+#include "ModOverrideIndex.h"
+#include "RcuCell.h"
+
 #include <cstdint>
 #include <filesystem>
-#include <optional>
-#include <unordered_map>
+#include <memory>
+#include <span>
+#include <string>
 
 namespace LooseFileLoader {
 
 class ModAssetManager {
 public:
-    void Build(const std::filesystem::path& gameRootDir);
-    [[nodiscard]] std::optional<std::filesystem::path> Find(std::uint32_t fileHash) const;
+    ModAssetManager();
+    ModAssetManager(const ModAssetManager&) = delete;
+    ModAssetManager& operator=(const ModAssetManager&) = delete;
+    ~ModAssetManager();
+
+    // With a cachePath, unchanged mod folders are restored from that file instead of being walked,
+    // and the file is rewritten whenever something had to be rescanned.
+    void Build(const std::filesystem::path& gameRootDir, const std::filesystem::path& cachePath = {});
+
+    // Overrides of at most maxFileBytes are read into memory, up to budgetBytes in total, whenever
+    // an index is built or reloaded (see ModOverrideIndex::Preload). A budget of 0 turns it off.
+    void SetPreloadBudget(std::uint64_t budgetBytes, std::uint64_t maxFileBytes);
+
+    // The current override snapshot. Hold the guard for as long as any ModOverride taken from it
+    // is in use; a reload never frees a snapshot that a guard still points to.
+    [[nodiscard]] RcuCell<ModOverrideIndex>::ReadGuard Acquire() const;
+
+    // Rebuilds the index whenever something under mods/ changes, rescanning only the folders the
+    // change touched. Call after Build.
+    bool StartWatching(std::string* error = nullptr);
+    void StopWatching();
 
 private:
-    std::unordered_map<std::uint32_t, std::filesystem::path> overrides_{};
+    struct State;
+
+    // paths are relative to mods/; overflow means the watcher lost track and everything is rescanned.
+    void ApplyChanges(std::span<const std::filesystem::path> paths, bool overflow);
+
+    RcuCell<ModOverrideIndex> index_;
+    std::unique_ptr<State> state_;
 };
 
 inline ModAssetManager g_modAssetManager;
 }  // namespace LooseFileLoader
-
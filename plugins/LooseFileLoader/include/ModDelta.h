@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace LooseFileLoader {
+
+// Delta image (little-endian), turning a source payload into a target payload:
+//   ModDeltaHeader
+//   ops until targetSize bytes are produced, each starting with varint (length << 1 | kind):
+//     kind 0, ADD:  length literal bytes follow
+//     kind 1, COPY: varint skip follows; skip source bytes, then copy length source bytes
+// Varints are LEB128. A COPY's skip counts from the end of the previous COPY, so the source is
+// only ever read forward, the way the game's own stream for the asset is consumed.
+#pragma pack(push, 1)
+struct ModDeltaHeader {
+    char magic[4] = {'L', 'F', 'D', 'T'};
+    std::uint32_t version = 1;
+    std::uint64_t sourceSize = 0;
+    std::uint64_t targetSize = 0;
+    // zlib crc32 of the whole source and target. ApplyModDelta checks both; ModDeltaReader checks
+    // the source when it opens, since it streams the target.
+    std::uint32_t sourceCrc32 = 0;
+    std::uint32_t targetCrc32 = 0;
+};
+#pragma pack(pop)
+static_assert(sizeof(ModDeltaHeader) == 32);
+
+inline constexpr std::uint64_t kModDeltaAdd = 0;
+inline constexpr std::uint64_t kModDeltaCopy = 1;
+
+// Validates magic and version; the ops are not looked at.
+std::optional<ModDeltaHeader> ReadModDeltaHeader(std::span<const std::byte> delta, std::string* error = nullptr);
+
+// Copies are found by hashing 16-byte source blocks and extending matches both ways; bytes
+// patched in place and short insertions or removals cost little more than the changed bytes.
+[[nodiscard]] std::vector<std::byte> EncodeModDelta(std::span<const std::byte> source, std::span<const std::byte> target);
+
+bool ApplyModDelta(std::span<const std::byte> source, std::span<const std::byte> delta,
+                   std::vector<std::byte>* outTarget, std::string* error = nullptr);
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace LooseFileLoader {
+
+// Watches a directory tree on a background thread (ReadDirectoryChangesW on Windows, inotify
+// elsewhere) and reports what changed in debounced batches: a batch is delivered once no new
+// event arrived for the quiet period, so an editor's save burst becomes one callback.
+class ModDirectoryWatcher final {
+public:
+    struct Batch {
+        // Relative to the watched root; one entry per changed file or directory, unordered.
+        std::vector<std::filesystem::path> paths{};
+        // Events were lost (queue overflow); the whole tree has to be treated as changed.
+        bool overflow = false;
+    };
+    using Callback = std::function<void(Batch)>;
+
+    static constexpr std::chrono::milliseconds kDefaultQuietPeriod{250};
+
+    ModDirectoryWatcher();
+    ModDirectoryWatcher(const ModDirectoryWatcher&) = delete;
+    ModDirectoryWatcher& operator=(const ModDirectoryWatcher&) = delete;
+    ~ModDirectoryWatcher();
+
+    // The callback runs on the watcher thread.
+    bool Start(const std::filesystem::path& root, Callback callback, std::string* error = nullptr,
+               std::chrono::milliseconds quietPeriod = kDefaultQuietPeriod);
+    // Blocks until the watcher thread has exited; no callback runs after it returns.
+    void Stop();
+    [[nodiscard]] bool IsRunning() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace LooseFileLoader
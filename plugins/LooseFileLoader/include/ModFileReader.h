@@ -1,37 +1,162 @@
 #pragma once
 
-#include "Common.h"
+#include "FileStreamReader.h"
+#include "ModOverrideIndex.h"
 
-#include <filesystem>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
 
 #include "binary_io/binary_io.hpp"
 
 namespace LooseFileLoader {
 
-class ModFileReader final : public IFileStreamReader {
+// Base of the readers handed to Deserialize for a mod override. They share one ID, so the
+// GetArchiveInfo hook can recognize any of them; it reports the override's path only for readers
+// whose output is the file's bytes as they are on disk (IsRedirectable).
+class ModStreamReader : public IFileStreamReader {
 public:
     static constexpr uint64_t kModFileReaderId = 0x2026022820260228;
 
+    std::uint64_t GetID() const final;
+
+    [[nodiscard]] virtual bool IsOpen() const = 0;
+    // True when a handler that reopens GetFilePath() reads the same bytes this reader serves.
+    // False for decoded overrides (compressed, delta), whose file holds the encoded form.
+    [[nodiscard]] virtual bool IsRedirectable() const = 0;
+    [[nodiscard]] std::uint64_t GetFileSize() const;
+    [[nodiscard]] const std::string& GetFilePath() const;
+
+protected:
+    const ModOverride* override_ = nullptr;
+    std::uint64_t fileSize_ = 0;
+};
+
+// Streams an override from disk with positioned OS reads (pread / ReadFile at an offset); the
+// position is tracked here, so Skip is free and no call goes through stdio. Reads of at least
+// kReadAheadBytes go straight into the caller's buffer; smaller ones and ReadByte are served
+// from a read-ahead buffer, taken on the first small read from a per-thread spare.
+class ModFileReader final : public ModStreamReader {
+public:
+    static constexpr std::size_t kReadAheadBytes = 64 * 1024;
+
     ModFileReader() = delete;
-    explicit ModFileReader(std::filesystem::path filePath);
+    // modOverride must outlive the reader. Its size is trusted unless it came from the on-disk
+    // cache, so opening a freshly scanned override costs no stat.
+    explicit ModFileReader(const ModOverride& modOverride);
     ~ModFileReader() override;
 
-    bool Open(std::filesystem::path filePath);
+    bool Open(const ModOverride& modOverride);
     void Close() override;
     std::int64_t Skip(std::int64_t deltaBytes) override;
     std::uint64_t ReadByte(std::uint8_t* outByte) override;
     std::uint64_t Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) override;
-    std::uint64_t GetID() const override;
 
-    [[nodiscard]] bool IsOpen() const;
-    [[nodiscard]] std::uint64_t GetFileSize() const;
-    [[nodiscard]] std::string GetFilePath() const;
+    [[nodiscard]] bool IsOpen() const override;
+    [[nodiscard]] bool IsRedirectable() const override;
+
+private:
+    // Reads up to size bytes at offset, retrying short reads; fewer only at end of file or on error.
+    std::uint64_t ReadAt(std::uint64_t offset, std::byte* dst, std::uint64_t size);
+
+#ifdef _WIN32
+    void* handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    std::uint64_t position_ = 0;
+    // Holds file bytes [bufferBegin_, bufferBegin_ + bufferFill_).
+    std::unique_ptr<std::byte[]> buffer_;
+    std::uint64_t bufferBegin_ = 0;
+    std::size_t bufferFill_ = 0;
+};
+
+// Serves a preloaded override (ModOverride::preloaded) straight from the index arena: no file
+// handle and no syscalls. modOverride must outlive the reader.
+class ModMemoryReader final : public ModStreamReader {
+public:
+    ModMemoryReader() = delete;
+    explicit ModMemoryReader(const ModOverride& modOverride);
+
+    bool Open(const ModOverride& modOverride);
+    void Close() override;
+    std::int64_t Skip(std::int64_t deltaBytes) override;
+    std::uint64_t ReadByte(std::uint8_t* outByte) override;
+    std::uint64_t Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) override;
+
+    [[nodiscard]] bool IsOpen() const override;
+    [[nodiscard]] bool IsRedirectable() const override;
 
 private:
-    std::filesystem::path filePath_{};
+    std::span<const std::byte> data_{};
+    std::uint64_t position_ = 0;
+    bool open_ = false;
+};
+
+// Serves a compressed override (ModOverride::compressed): a gzip or zlib stream, detected from its
+// header, inflated as Read and Skip advance. GetFileSize is the inflated size, from the gzip ISIZE
+// trailer; zlib has no size field, so a zlib stream is inflated once more while it is opened, and
+// one that ends before Z_STREAM_END does not open. The last 64 KB of output stay in a window, so a
+// short backward Skip does not restart the stream.
+// modOverride must outlive the reader.
+class ModInflateReader final : public ModStreamReader {
+public:
+    ModInflateReader() = delete;
+    explicit ModInflateReader(const ModOverride& modOverride);
+    ~ModInflateReader() override;
+
+    bool Open(const ModOverride& modOverride);
+    void Close() override;
+    std::int64_t Skip(std::int64_t deltaBytes) override;
+    std::uint64_t ReadByte(std::uint8_t* outByte) override;
+    std::uint64_t Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) override;
+
+    [[nodiscard]] bool IsOpen() const override;
+    [[nodiscard]] bool IsRedirectable() const override;
+
+private:
+    struct Inflater;
+
     binary_io::file_istream stream_{};
-    std::uint64_t fileSize_ = 0;
+    std::unique_ptr<Inflater> inflater_;
+    std::uint64_t position_ = 0;
 };
 
-}  // namespace LooseFileLoader
+// Serves a delta override (ModOverride::delta): a ModDelta patch applied to the game's own payload
+// for the asset as Read and Skip advance. The payload is read forward only, through the stream the
+// game handed to Deserialize; the delta file streams through a ModFileReader. The last 64 KB of
+// output stay in a window, as in ModInflateReader, and a Skip further back rewinds both streams.
+// modOverride and source must outlive the reader.
+class ModDeltaReader final : public ModStreamReader {
+public:
+    ModDeltaReader() = delete;
+    // sourceSize is the payload size the game reported; a delta made for another size, or for
+    // another payload by CRC-32, does not open. source is read through once to check it and rewound.
+    ModDeltaReader(const ModOverride& modOverride, IFileStreamReader& source, std::uint64_t sourceSize);
+    ~ModDeltaReader() override;
 
+    bool Open(const ModOverride& modOverride, IFileStreamReader& source, std::uint64_t sourceSize);
+    void Close() override;
+    std::int64_t Skip(std::int64_t deltaBytes) override;
+    std::uint64_t ReadByte(std::uint8_t* outByte) override;
+    std::uint64_t Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) override;
+
+    [[nodiscard]] bool IsOpen() const override;
+    [[nodiscard]] bool IsRedirectable() const override;
+    // The payload size the delta was made for; 0 when its header could not be read.
+    [[nodiscard]] std::uint64_t GetSourceSize() const;
+    // Open failed because the game's payload is not the one the delta was made for: another size,
+    // or the same size with another CRC-32.
+    [[nodiscard]] bool IsSourceMismatch() const;
+
+private:
+    struct Applier;
+
+    std::unique_ptr<Applier> applier_;
+    std::uint64_t position_ = 0;
+    std::uint64_t expectedSourceSize_ = 0;
+    bool sourceMismatch_ = false;
+};
+
+}  // namespace LooseFileLoader
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "AssetTelemetry.h"
+
 namespace LooseFileLoader {
 
 bool InstallHooks();
 
+// Names asset handlers for the telemetry JSON (IBaseGameAssetHandler::GetTypeName).
+AssetTelemetry::TypeNameResolver GetAssetTypeNameResolver();
+
 }  // namespace LooseFileLoader
 
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "ModOverrideIndex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace LooseFileLoader {
+
+// Cheap identity of one directory. lastWriteTime is read before the directory is listed and is
+// the only part checked at startup; entryCount and nameHash (sum of HashName over the entry
+// names) come from the listing and tell a touched folder from a changed one after a rescan.
+struct ModFolderFingerprint {
+    std::int64_t lastWriteTime = 0;
+    std::uint32_t entryCount = 0;
+    std::uint32_t nameHash = 0;
+
+    friend bool operator==(const ModFolderFingerprint&, const ModFolderFingerprint&) = default;
+};
+
+// Input for ModOverrideCache::Save: mods/ itself first, then every mod folder in precedence order.
+struct ModCacheFolder {
+    std::filesystem::path dir{};
+    ModFolderFingerprint fingerprint{};
+    // Folder-local precedence order.
+    std::vector<ModOverrideIndex::Record> candidates{};
+};
+
+// Cache image (little-endian, read in place from a file mapping):
+//   ModCacheHeader
+//   ModCacheFolderEntry[folderCount]
+//   ModCacheFileEntry[candidateCount]   every folder's candidates, folder by folder
+//   ModCacheFileEntry[winnerCount]      the resolved index, sorted by fileKtid
+//   ModCacheConflictEntry[conflictCount]
+//   string blob of UTF-8 absolute paths (modsDir first), deduplicated
+#pragma pack(push, 1)
+struct ModCacheHeader {
+    char magic[4] = {'L', 'F', 'M', 'C'};
+    std::uint32_t version = 1;
+    std::uint32_t folderCount = 0;
+    std::uint32_t candidateCount = 0;
+    std::uint32_t winnerCount = 0;
+    std::uint32_t conflictCount = 0;
+    std::uint32_t stringBytes = 0;
+    std::uint32_t modsDirLength = 0;
+};
+
+struct ModCacheFolderEntry {
+    std::int64_t lastWriteTime = 0;
+    std::uint32_t entryCount = 0;
+    std::uint32_t nameHash = 0;
+    std::uint32_t pathOffset = 0;
+    std::uint32_t pathLength = 0;
+    std::uint32_t firstCandidate = 0;
+    std::uint32_t candidateCount = 0;
+};
+
+struct ModCacheFileEntry {
+    std::uint64_t fileSize = 0;
+    std::uint32_t fileKtid = 0;
+    std::uint32_t pathOffset = 0;
+    std::uint32_t pathLength = 0;
+    std::uint32_t valid = 0;
+};
+
+struct ModCacheConflictEntry {
+    std::uint32_t fileKtid = 0;
+    std::uint32_t keptOffset = 0;
+    std::uint32_t keptLength = 0;
+    std::uint32_t skippedOffset = 0;
+    std::uint32_t skippedLength = 0;
+};
+#pragma pack(pop)
+static_assert(sizeof(ModCacheHeader) == 32);
+static_assert(sizeof(ModCacheFolderEntry) == 32);
+static_assert(sizeof(ModCacheFileEntry) == 24);
+static_assert(sizeof(ModCacheConflictEntry) == 20);
+
+// Persistent ModAssetManager index, so unchanged mod folders are not walked again on the next
+// launch. Records decoded from the cache set verifySizeOnOpen: a file overwritten in place does
+// not touch its folder's timestamp, so its size is re-read when it is actually opened.
+class ModOverrideCache final {
+public:
+    static std::optional<ModOverrideCache> Open(const std::filesystem::path& path, std::string* error = nullptr);
+    static bool Save(const std::filesystem::path& path, const std::filesystem::path& modsDir,
+                     std::span<const ModCacheFolder> folders, std::span<const ModOverride> winners,
+                     std::span<const ModOverrideConflict> conflicts, std::string* error = nullptr);
+
+    [[nodiscard]] std::string_view ModsDir() const;
+    [[nodiscard]] std::size_t FolderCount() const;
+    // UTF-8 absolute path of folder index; index 0 is mods/.
+    [[nodiscard]] std::string_view FolderPath(std::size_t index) const;
+    [[nodiscard]] ModFolderFingerprint FolderFingerprint(std::size_t index) const;
+    [[nodiscard]] std::vector<ModOverrideIndex::Record> FolderCandidates(std::size_t index) const;
+    [[nodiscard]] std::vector<ModOverrideIndex::Record> Winners() const;
+    [[nodiscard]] std::vector<ModOverrideConflict> Conflicts() const;
+
+private:
+    explicit ModOverrideCache(MappedFile mapping);
+    bool Attach(std::string* error);
+    [[nodiscard]] std::string_view String(std::uint32_t offset, std::uint32_t length) const;
+    [[nodiscard]] ModOverrideIndex::Record DecodeFile(const ModCacheFileEntry& entry) const;
+
+    MappedFile mapping_;
+    const ModCacheHeader* header_ = nullptr;
+    const ModCacheFolderEntry* folders_ = nullptr;
+    const ModCacheFileEntry* candidates_ = nullptr;
+    const ModCacheFileEntry* winners_ = nullptr;
+    const ModCacheConflictEntry* conflicts_ = nullptr;
+    const char* strings_ = nullptr;
+};
+
+// UTF-8 form of a path, as stored in the cache.
+[[nodiscard]] std::string ToCachePath(const std::filesystem::path& path);
+[[nodiscard]] std::filesystem::path FromCachePath(std::string_view utf8);
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "AssetIdTable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace LooseFileLoader {
+
+// One resolved mod override. Size and validity are captured while the index is built, so the
+// load path never has to stat the file again.
+struct ModOverride {
+    std::filesystem::path path{};
+    // generic_string() of path, handed to GetArchiveInfo and the log.
+    std::string displayPath{};
+    std::uint64_t fileSize = 0;
+    std::uint32_t fileKtid = 0;
+    // False when the size could not be read at build time; the game's own asset is used instead.
+    bool valid = false;
+    // Set for entries restored from ModOverrideCache: fileSize is from an earlier session.
+    bool verifySizeOnOpen = false;
+    // The whole file, read into the owning index's arena by ModOverrideIndex::Preload. It is
+    // served from memory from then on, as it was when it was read.
+    bool preloaded = false;
+    std::span<const std::byte> preloadedData{};
+    // Named "<hash>[.ext].gz" or "<hash>[.ext].zlib": a gzip or zlib stream, inflated while it is
+    // read (ModInflateReader). fileSize is then the compressed size on disk.
+    bool compressed = false;
+    // Named "<hash>[.ext].delta": a ModDelta patch applied to the game's own payload while it is
+    // read (ModDeltaReader). fileSize is then the delta's size on disk.
+    bool delta = false;
+};
+
+// True for the ".gz" and ".zlib" override names, compared case-insensitively.
+[[nodiscard]] bool IsCompressedOverridePath(const std::filesystem::path& path);
+// True for the ".delta" override names, compared case-insensitively.
+[[nodiscard]] bool IsDeltaOverridePath(const std::filesystem::path& path);
+
+struct ModPreloadStats {
+    std::size_t fileCount = 0;
+    std::uint64_t bytes = 0;
+    // Selected, but could not be read in full; they keep streaming from disk.
+    std::size_t failedCount = 0;
+};
+
+struct ModOverrideConflict {
+    std::uint32_t fileKtid = 0;
+    std::filesystem::path kept{};
+    std::filesystem::path skipped{};
+};
+
+// Immutable fileKtid -> ModOverride map for the DeserializeAsset hook.
+//
+// The keys live in an AssetIdTable (cache-line buckets, SIMD rank), and the rank indexes a
+// dense ModOverride array, so a hit hands out a stable pointer instead of copying the path.
+// Most lookups are vanilla assets, so a small bitmap over the low fileKtid bits rejects the
+// bulk of misses with a single load before the table is touched.
+class ModOverrideIndex final {
+public:
+    struct Record {
+        std::uint32_t fileKtid = 0;
+        std::filesystem::path path{};
+        std::uint64_t fileSize = 0;
+        bool valid = false;
+        bool verifySizeOnOpen = false;
+    };
+
+    ModOverrideIndex() = default;
+
+    // records must be in precedence order; the first record per fileKtid wins and every later one
+    // is reported in conflicts (when given).
+    static ModOverrideIndex Build(std::vector<Record> records, std::vector<ModOverrideConflict>* conflicts = nullptr);
+
+    // nullptr when fileKtid has no override. The pointer stays valid for the index's lifetime.
+    [[nodiscard]] const ModOverride* Find(std::uint32_t fileKtid) const {
+        const std::uint32_t bit = fileKtid & filterMask_;
+        if ((filter_[bit >> 6] & (std::uint64_t{1} << (bit & 63))) == 0) {
+            return nullptr;
+        }
+        const std::uint32_t rank = keys_.Find(fileKtid);
+        return rank != AssetIdTable::kInvalidResId ? &overrides_[rank] : nullptr;
+    }
+
+    // Reads every valid override of at most maxFileBytes into one arena, smallest first, until
+    // budgetBytes would be exceeded; the files are read in parallel. Compressed and delta overrides
+    // are left to stream. Only for an index that is not shared yet.
+    ModPreloadStats Preload(std::uint64_t budgetBytes, std::uint64_t maxFileBytes, std::size_t threadCount = 0);
+
+    [[nodiscard]] std::span<const ModOverride> Overrides() const {
+        return overrides_;
+    }
+    [[nodiscard]] std::size_t Size() const {
+        return overrides_.size();
+    }
+    [[nodiscard]] std::size_t MemoryBytes() const;
+
+private:
+    AssetIdTable keys_{};
+    // Sorted by fileKtid, i.e. indexed by the rank keys_ returns.
+    std::vector<ModOverride> overrides_{};
+    // One bit per value of (fileKtid & filterMask_); a single zero word while empty.
+    std::vector<std::uint64_t> filter_ = std::vector<std::uint64_t>(1, 0);
+    std::uint32_t filterMask_ = 0;
+    // Backing store of every ModOverride::preloadedData.
+    std::unique_ptr<std::byte[]> preloadArena_{};
+    std::size_t preloadBytes_ = 0;
+};
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace LooseFileLoader {
+
+class ModAssetManager;
+
+// Records the order in which mod overrides are loaded and, on later launches, reads the next
+// overrides of that order on a background thread, ahead of the DeserializeAsset hook, so they come
+// from the OS file cache rather than a cold disk. Level and menu loads repeat the same sequence.
+//
+// Every hit moves the read-ahead window to the lookahead entries after the hit's position in the
+// profile; the start of the profile is read right away. Preloaded overrides are skipped. The
+// profile (ModAccessProfile) is rewritten a few seconds after the last new hit, and on Stop.
+class ModPrefetcher final {
+public:
+    static constexpr std::size_t kDefaultLookahead = 16;
+
+    ModPrefetcher();
+    ModPrefetcher(const ModPrefetcher&) = delete;
+    ModPrefetcher& operator=(const ModPrefetcher&) = delete;
+    ~ModPrefetcher();
+
+    // A missing or unreadable profile only means nothing is prefetched this session.
+    bool Start(const ModAssetManager& overrides, const std::filesystem::path& profilePath,
+               std::size_t lookahead = kDefaultLookahead, std::string* error = nullptr);
+    // Blocks until the warmer thread has exited, then saves the profile if it changed.
+    void Stop();
+    [[nodiscard]] bool IsRunning() const;
+
+    // Called by the hook for every override it serves. Queues the hit for the warmer thread: no
+    // lock, heap allocation or I/O, and a single atomic load while prefetching is off.
+    void OnOverrideHit(std::uint32_t fileKtid);
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+};
+
+inline ModPrefetcher g_modPrefetcher;
+
+}  // namespace LooseFileLoader
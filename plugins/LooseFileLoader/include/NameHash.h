@@ -0,0 +1,152 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace LooseFileLoader {
+
+struct RdbEntry;
+
+// Engine name hash used for ktids and property names: walk the bytes back to front with
+// h = (h + c) * 31. Equivalently h = sum(c[i] * 31^(i + 1)) mod 2^32.
+[[nodiscard]] constexpr std::uint32_t HashName(std::string_view name) {
+    std::uint32_t hash = 0;
+    for (std::size_t i = name.size(); i > 0; --i) {
+        hash = (hash + static_cast<unsigned char>(name[i - 1])) * 31u;
+    }
+    return hash;
+}
+
+// 31^length mod 2^32.
+[[nodiscard]] constexpr std::uint32_t HashNamePower(std::size_t length) {
+    std::uint32_t result = 1;
+    std::uint32_t base = 31;
+    while (length != 0) {
+        if ((length & 1) != 0) {
+            result *= base;
+        }
+        base *= base;
+        length >>= 1;
+    }
+    return result;
+}
+
+// HashName(a + b) computed from HashName(a), a.size() and HashName(b).
+[[nodiscard]] constexpr std::uint32_t CombineNameHash(std::uint32_t prefixHash, std::size_t prefixLength,
+                                                      std::uint32_t suffixHash) {
+    return prefixHash + HashNamePower(prefixLength) * suffixHash;
+}
+
+static_assert(HashName("TypeInfo") == 0xEAA73D68);
+static_assert(CombineNameHash(HashName("Type"), 4, HashName("Info")) == HashName("TypeInfo"));
+
+// Name table image (all values little-endian uint32), usable straight from a file mapping:
+//   NameTableHeader
+//   displacement[bucketCount]
+//   NameTableSlot[slotCount]
+//   string blob, every name NUL-terminated
+// Lookup is a hash-and-displace perfect hash: bucket = Mix(hash, 0) % bucketCount,
+// slot = Mix(hash, displacement[bucket]) % slotCount, then one key compare.
+#pragma pack(push, 1)
+struct NameTableHeader {
+    char magic[4] = {'L', 'F', 'N', 'H'};
+    std::uint32_t version = 1;
+    std::uint32_t entryCount = 0;
+    std::uint32_t bucketCount = 0;
+    std::uint32_t slotCount = 0;
+    std::uint32_t stringBytes = 0;
+};
+
+struct NameTableSlot {
+    std::uint32_t hash = 0;
+    std::uint32_t nameOffset = 0;  // kEmptyNameSlot for unused slots
+    std::uint32_t nameLength = 0;
+};
+#pragma pack(pop)
+static_assert(sizeof(NameTableHeader) == 24);
+static_assert(sizeof(NameTableSlot) == 12);
+
+inline constexpr std::uint32_t kEmptyNameSlot = 0xFFFFFFFFu;
+
+class NameDictionaryBuilder final {
+public:
+    // The first name registered for a hash wins; later duplicates are ignored.
+    void Add(std::uint32_t hash, std::string_view name);
+    void AddName(std::string_view name);
+
+    // "hash,name" rows as written by extract_property_hashes.py; a non-numeric header row is skipped.
+    bool LoadCsv(const std::filesystem::path& path, std::string* error = nullptr);
+    // One name per line; blank lines and lines starting with '#' are skipped.
+    bool LoadWordlist(const std::filesystem::path& path, std::string* error = nullptr);
+
+    [[nodiscard]] std::size_t Size() const;
+    [[nodiscard]] std::vector<std::byte> Build() const;
+    bool Save(const std::filesystem::path& path, std::string* error = nullptr) const;
+
+private:
+    std::unordered_map<std::uint32_t, std::string> names_{};
+};
+
+// Read-only hash -> name table. Lookups are O(1) and thread-safe.
+class NameDictionary final {
+public:
+    // Maps a table built by NameDictionaryBuilder::Save, or builds one in memory from a CSV
+    // file (any file that does not start with the table magic).
+    static std::optional<NameDictionary> Load(const std::filesystem::path& path, std::string* error = nullptr);
+    static std::optional<NameDictionary> FromImage(std::vector<std::byte> image, std::string* error = nullptr);
+
+    // Empty when unknown. Non-empty results are NUL-terminated, so data() can go to printf.
+    [[nodiscard]] std::string_view Find(std::uint32_t hash) const;
+    [[nodiscard]] bool Contains(std::uint32_t hash) const;
+    [[nodiscard]] std::size_t Size() const;
+
+private:
+    NameDictionary() = default;
+    bool Attach(std::span<const std::byte> image, std::string* error);
+
+    std::optional<MappedFile> mapping_{};
+    std::vector<std::byte> ownedImage_{};
+    const NameTableHeader* header_ = nullptr;
+    const std::uint32_t* displacements_ = nullptr;
+    const NameTableSlot* slots_ = nullptr;
+    const char* strings_ = nullptr;
+};
+
+struct NameRecoveryOptions {
+    // Every word is tried bare and with each prefix/suffix combination.
+    std::vector<std::string> prefixes{};
+    std::vector<std::string> suffixes{};
+    // Worker count; 0 uses one per hardware thread.
+    std::size_t threadCount = 0;
+};
+
+struct RecoveredName {
+    std::uint32_t hash = 0;
+    std::string name{};
+};
+
+bool LoadWordlist(const std::filesystem::path& path, std::vector<std::string>* outWords, std::string* error = nullptr);
+
+// Distinct fileKtid/typeInfoKtid values that `known` (may be null) cannot name, sorted.
+[[nodiscard]] std::vector<std::uint32_t> CollectUnknownKtids(std::span<const RdbEntry> entries,
+                                                             const NameDictionary* known);
+
+// Tries every prefix + word + suffix candidate against `targets`. Candidate hashes are combined
+// from precomputed part hashes, so strings are only built for hits. Sorted by hash, then name.
+[[nodiscard]] std::vector<RecoveredName> RecoverNames(std::span<const std::uint32_t> targets,
+                                                      std::span<const std::string> words,
+                                                      const NameRecoveryOptions& options = {});
+
+// Optional dictionary used to annotate log lines; loaded once at plugin start.
+inline std::optional<NameDictionary> g_nameDictionary;
+
+}  // namespace LooseFileLoader
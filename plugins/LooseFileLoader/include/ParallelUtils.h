@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace LooseFileLoader {
+
+// Resolve a requested worker count: 0 means "one per hardware thread".
+[[nodiscard]] inline std::size_t ResolveThreadCount(std::size_t requested, std::size_t workItems) {
+    std::size_t count = requested;
+    if (count == 0) {
+        count = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+    return std::max<std::size_t>(1, std::min(count, workItems));
+}
+
+// Run fn(index) for every index in [0, count) on up to threadCount workers.
+// Indices are handed out in increasing order from a shared counter, so callers that
+// write results into per-index slots get a deterministic, in-order result set.
+// The first exception thrown by a worker is rethrown on the calling thread.
+template <class Fn>
+void ParallelFor(std::size_t count, std::size_t threadCount, Fn&& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    const std::size_t workers = ResolveThreadCount(threadCount, count);
+    if (workers == 1) {
+        for (std::size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr firstError{};
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        for (;;) {
+            const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= count) {
+                return;
+            }
+            try {
+                fn(index);
+            } catch (...) {
+                std::lock_guard lock(errorMutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+                next.store(count, std::memory_order_relaxed);
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (std::size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace LooseFileLoader {
+
+// Process-wide read-side bookkeeping for RcuCell.
+//
+// Every thread that reads gets a cache-line sized slot (registered lock-free on first use and
+// recycled when the thread exits). Entering a read section stores the current epoch into the
+// slot, leaving stores zero; neither touches a shared cache line. Synchronize advances the epoch
+// and waits until no slot is still inside a section that began before the call.
+class RcuDomain final {
+public:
+    // Read sections nest; only the outermost Enter/Leave pair touches the slot.
+    static void Enter();
+    static void Leave();
+    // Must not be called from inside a read section.
+    static void Synchronize();
+};
+
+// A pointer to an immutable T that readers load with one atomic load inside a read section and
+// writers replace wholesale. The old value is deleted once every reader that could still see it
+// has left its section.
+template <class T>
+class RcuCell final {
+public:
+    class ReadGuard final {
+    public:
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ~ReadGuard() {
+            RcuDomain::Leave();
+        }
+
+        [[nodiscard]] const T* get() const {
+            return value_;
+        }
+        const T& operator*() const {
+            return *value_;
+        }
+        const T* operator->() const {
+            return value_;
+        }
+
+    private:
+        friend class RcuCell;
+        explicit ReadGuard(const std::atomic<const T*>& cell) {
+            RcuDomain::Enter();
+            value_ = cell.load(std::memory_order_seq_cst);
+        }
+
+        const T* value_ = nullptr;
+    };
+
+    explicit RcuCell(std::unique_ptr<const T> initial) : value_(initial.release()) {}
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+    ~RcuCell() {
+        delete value_.load(std::memory_order_acquire);
+    }
+
+    // The value stays alive until the guard is destroyed.
+    [[nodiscard]] ReadGuard Read() const {
+        return ReadGuard(value_);
+    }
+
+    // Swaps in next and frees the previous value after a grace period. Writers must be
+    // serialized by the caller, and must not hold a ReadGuard.
+    void Publish(std::unique_ptr<const T> next) {
+        const T* previous = value_.exchange(next.release(), std::memory_order_seq_cst);
+        RcuDomain::Synchronize();
+        delete previous;
+    }
+
+private:
+    std::atomic<const T*> value_;
+};
+
+}  // namespace LooseFileLoader
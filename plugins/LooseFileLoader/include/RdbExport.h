@@ -0,0 +1,97 @@
+#pragma once
+
+#include "RdbTool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace LooseFileLoader {
+
+class NameDictionary;
+
+enum class RdbExportFormat : std::uint8_t {
+    Csv,        // Dump-compatible text: RDB header block followed by one CSV row per entry.
+    JsonLines,  // One JSON object per entry.
+    Columnar,   // Compact little-endian binary, one contiguous array per column.
+};
+
+// Column bits for RdbExportOptions::columns. Order matches the CSV column order.
+enum class RdbExportColumn : std::uint32_t {
+    Index = 1u << 0,
+    FileKtid = 1u << 1,
+    TypeInfoKtid = 1u << 2,
+    FileSize = 1u << 3,
+    Flags = 1u << 4,
+    DataSize = 1u << 5,
+    NewFlags = 1u << 6,
+    Offset = 1u << 7,
+    SizeInContainer = 1u << 8,
+    FdataId = 1u << 9,
+    Container = 1u << 10,
+    // Name columns are only written when RdbExportOptions::names is set, so the default
+    // selection stays Dump-compatible.
+    FileName = 1u << 11,
+    TypeName = 1u << 12,
+};
+
+inline constexpr std::uint32_t kRdbExportColumnCount = 13;
+inline constexpr std::uint32_t kRdbExportAllColumns = (1u << kRdbExportColumnCount) - 1;
+
+[[nodiscard]] constexpr std::uint32_t operator|(RdbExportColumn lhs, RdbExportColumn rhs) {
+    return static_cast<std::uint32_t>(lhs) | static_cast<std::uint32_t>(rhs);
+}
+[[nodiscard]] constexpr std::uint32_t operator|(std::uint32_t lhs, RdbExportColumn rhs) {
+    return lhs | static_cast<std::uint32_t>(rhs);
+}
+
+struct RdbExportOptions {
+    RdbExportFormat format = RdbExportFormat::Csv;
+    std::uint32_t columns = kRdbExportAllColumns;
+    // Only entries whose typeInfoKtid is listed are exported; empty exports every entry.
+    std::vector<std::uint32_t> typeInfoKtids{};
+    // Csv only: emit the "RDB Header" block before the column header line.
+    bool includeHeader = true;
+    // Row formatting workers; 0 uses one per hardware thread.
+    std::size_t threadCount = 0;
+    // Resolves fileKtid/typeInfoKtid for the FileName/TypeName columns. Unknown hashes export as
+    // an empty string (CSV, columnar) or null (JSON-lines).
+    const NameDictionary* names = nullptr;
+};
+
+// Columnar file layout (all values little-endian):
+//   RdbColumnarHeader
+//   RdbColumnarColumn[columnCount]
+//   column data, each column starting at its 8-byte aligned dataOffset.
+// Fixed-width columns are plain arrays of rowCount values. String columns (Container, FileName,
+// TypeName) store rowCount + 1 uint32 string offsets followed by the UTF-8 string blob. Rows without
+// location metadata store 0 / an empty string in location columns.
+#pragma pack(push, 1)
+struct RdbColumnarHeader {
+    char magic[4] = {'R', 'D', 'B', 'C'};
+    std::uint32_t version = 1;
+    std::uint64_t rowCount = 0;
+    std::uint32_t columnCount = 0;
+    std::uint32_t databaseId = 0;
+};
+
+struct RdbColumnarColumn {
+    std::uint32_t column = 0;      // RdbExportColumn bit
+    std::uint32_t valueSize = 0;   // bytes per value; 0 for the string column
+    std::uint64_t dataOffset = 0;  // from file start
+    std::uint64_t dataSize = 0;
+};
+#pragma pack(pop)
+static_assert(sizeof(RdbColumnarHeader) == 24);
+static_assert(sizeof(RdbColumnarColumn) == 24);
+
+bool ExportRdbEntries(const RdbHeader& header,
+                      std::span<const RdbEntry> entries,
+                      const std::filesystem::path& outputPath,
+                      const RdbExportOptions& options,
+                      std::string* error = nullptr);
+
+}  // namespace LooseFileLoader
@@ -4,13 +4,18 @@
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace LooseFileLoader {
 
+class NameDictionary;
+struct RdbExportOptions;
+
 enum class RdbLocationFlags : std::uint16_t {
     Internal = 0x401,
     External = 0xC01,
@@ -20,6 +25,8 @@ struct RdxEntry {
     std::uint16_t index = 0;
     std::uint16_t marker = 0;
     std::uint32_t fileId = 0;
+
+    bool operator==(const RdxEntry&) const = default;
 };
 
 struct RdbHeader {
@@ -61,20 +68,63 @@ struct RdbEntry {
     RdbLocation location{};
 };
 
+// Immutable, reference-counted view of one parsed root.rdb/root.rdx pair.
+// Any number of threads may read a catalog concurrently; it stays valid after the owning
+// RdbTool publishes a newer one.
+class RdbCatalog final {
+public:
+    [[nodiscard]] const RdbHeader& Header() const;
+    [[nodiscard]] const std::vector<RdxEntry>& RdxEntries() const;
+    [[nodiscard]] const std::vector<RdbEntry>& Entries() const;
+    [[nodiscard]] const RdbEntry* FindEntryByFileKtid(std::uint32_t fileKtid) const;
+
+private:
+    friend class RdbTool;
+
+    void IndexEntry(std::size_t position);
+
+    RdbHeader header_{};
+    std::vector<RdxEntry> rdxEntries_{};
+    std::vector<RdbEntry> entries_{};
+    std::unordered_map<std::uint32_t, std::size_t> entryIndexByKtid_{};
+};
+
+// Thread safety: Snapshot(), Extract(), Dump() and Export() may be called from any number of
+// threads, also while another thread runs Reload/Replace/Insert. Mutations are serialized
+// internally and publish a new catalog atomically when they succeed. Header(), Entries() and
+// FindEntryByFileKtid() read the current catalog and are only valid until the next mutation;
+// concurrent readers should hold a Snapshot() instead.
 class RdbTool final {
 public:
+    using CatalogPtr = std::shared_ptr<const RdbCatalog>;
+
+    RdbTool(RdbTool&& other) noexcept;
+    RdbTool& operator=(RdbTool&& other) noexcept;
+    ~RdbTool();
+
     static std::optional<RdbTool> Open(const std::filesystem::path& rootRdbPath,
                                        const std::filesystem::path& rootRdxPath,
                                        std::string* error = nullptr);
 
+    // Re-reads root.rdb/root.rdx only when their size or write time changed. If the RDB was
+    // only appended to (same header and identical bytes for every parsed entry), just the new
+    // tail entries are parsed and existing entry positions stay valid.
     bool Reload(std::string* error = nullptr);
 
+    [[nodiscard]] CatalogPtr Snapshot() const;
+
     [[nodiscard]] const RdbHeader& Header() const;
     [[nodiscard]] const std::vector<RdbEntry>& Entries() const;
     [[nodiscard]] const RdbEntry* FindEntryByFileKtid(std::uint32_t fileKtid) const;
 
     bool Dump(const std::filesystem::path& outputPath, std::string* error = nullptr) const;
+    // Same as Dump, with fileName/typeName columns resolved through `names`.
+    bool Dump(const std::filesystem::path& outputPath, const NameDictionary& names, std::string* error = nullptr) const;
+    bool Export(const std::filesystem::path& outputPath, const RdbExportOptions& options,
+                std::string* error = nullptr) const;
     bool Extract(std::uint32_t fileKtid, const std::filesystem::path& outputPath, std::string* error = nullptr) const;
+    // Decoded payload in memory. Only the entry's own block is read, not its whole container.
+    bool Extract(std::uint32_t fileKtid, std::vector<std::byte>* outPayload, std::string* error = nullptr) const;
 
     bool Replace(std::uint32_t fileKtid, std::span<const std::byte> replacementData, std::string* error = nullptr);
     bool Replace(std::uint32_t fileKtid, const std::filesystem::path& inputFilePath, std::string* error = nullptr);
@@ -115,15 +165,34 @@ private:
         std::uint64_t payloadOffset = 0;
     };
 
-    RdbTool() = default;
+    struct SourceFileState {
+        std::uint64_t size = 0;
+        std::filesystem::file_time_type writeTime{};
+
+        bool operator==(const SourceFileState&) const = default;
+    };
+
+    struct SharedState;
 
-    bool ReadRdx(std::string* error);
-    bool ReadRdb(std::string* error);
-    bool ResolveContainerPath(RdbEntry* entry) const;
+    RdbTool();
+
+    bool ReloadLocked(std::string* error);
+    void Publish(std::shared_ptr<const RdbCatalog> catalog);
+
+    bool ReadRdx(std::vector<RdxEntry>* outEntries, std::string* error) const;
+    bool ParseRdbHeader(std::span<const std::byte> rdbBytes, RdbHeader* outHeader, std::string* error) const;
+    bool ParseRdbEntries(RdbCatalog& catalog, std::span<const std::byte> rdbBytes, std::uint64_t startOffset,
+                         std::size_t count, std::uint64_t* outEndOffset, std::string* error) const;
+    [[nodiscard]] bool IsParsedRdbPrefixUnchanged(const RdbCatalog& catalog, std::span<const std::byte> rdbBytes,
+                                                  const RdbHeader& newHeader) const;
+    void RecordRdbState(std::span<const std::byte> rdbBytes, std::uint64_t parsedEnd);
+    bool ResolveContainerPath(const RdbCatalog& catalog, RdbEntry* entry) const;
     bool ParseEntryLocation(RdbEntry* entry) const;
 
     bool ReadContainer(const RdbEntry& entry, std::filesystem::path* resolvedPath,
                        std::vector<std::byte>* outBytes, std::string* error) const;
+    // Just the entry's KRDI block; it starts at offset 0 of outBytes.
+    bool ReadBlock(const RdbEntry& entry, std::vector<std::byte>* outBytes, std::string* error) const;
     bool ParseKrdiAt(const std::vector<std::byte>& containerBytes, std::uint64_t offset,
                      ParsedKrdi* outKrdi, std::string* error) const;
     bool ExtractPayload(const std::vector<std::byte>& containerBytes,
@@ -133,17 +202,25 @@ private:
                            std::vector<std::byte>* outBlock, std::string* error) const;
 
     bool PatchEntryLocation(RdbEntry* entry, std::uint64_t newOffset, std::uint32_t newSize, std::string* error) const;
-    bool SaveRdb(std::string* error);
+    bool SaveRdb(RdbCatalog& catalog, std::string* error);
 
+    static bool QuerySourceFileState(const std::filesystem::path& path, SourceFileState* outState, std::string* error);
     static bool ReadWholeFile(const std::filesystem::path& path, std::vector<std::byte>* outBytes, std::string* error);
     static bool WriteWholeFile(const std::filesystem::path& path, std::span<const std::byte> bytes, std::string* error);
 
     std::filesystem::path packageDir_{};
     std::filesystem::path rootRdbPath_{};
     std::filesystem::path rootRdxPath_{};
-    RdbHeader header_{};
-    std::vector<RdxEntry> rdxEntries_{};
-    std::vector<RdbEntry> entries_{};
+
+    // Mutexes and the published catalog live behind a pointer so RdbTool stays movable.
+    std::unique_ptr<SharedState> shared_{};
+
+    // Writer-side bookkeeping, only touched while holding SharedState::writeMutex.
+    bool loaded_ = false;
+    SourceFileState rdbFileState_{};
+    SourceFileState rdxFileState_{};
+    std::uint64_t rdbParsedEnd_ = 0;
+    std::uint64_t rdbPrefixHash_ = 0;
 };
 
 }  // namespace LooseFileLoader
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace LooseFileLoader {
+
+// Case-insensitive ordinal key with the ordering of CompareStringOrdinal(..., bIgnoreCase=TRUE):
+// every UTF-16 code unit is upper-cased on its own, then keys compare code unit by code unit.
+// Built once per name, so a sort compares plain arrays instead of folding on every comparison.
+using SortKey = std::u16string;
+
+// Upper-cases ASCII letters in place, eight code units per step where SSE2 is available. Returns
+// false when text also holds non-ASCII code units; those are left as they were.
+bool FoldAsciiUpper(std::span<char16_t> text);
+
+// ASCII takes the fast path above. Anything else goes through the OS uppercase table on Windows
+// (the one CompareStringOrdinal uses) and towupper elsewhere.
+[[nodiscard]] SortKey MakeSortKey(std::u16string_view text);
+// Key of the path's UTF-16 text; pass filename() for name ordering.
+[[nodiscard]] SortKey MakePathSortKey(const std::filesystem::path& path);
+
+}  // namespace LooseFileLoader
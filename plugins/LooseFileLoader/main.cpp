@@ -5,15 +5,20 @@
 #include <BranchTrampoline.h>
 #include <LogUtils.h>
 
+#include "AssetLoadTrace.h"
+#include "AssetTelemetry.h"
 #include "Common.h"
 #include "ModHooks.h"
 #include "ModAssetManager.h"
+#include "ModPrefetcher.h"
+#include "NameHash.h"
 
 namespace {
-    std::filesystem::path GetIniPath(const Nioh3PluginInitializeParam* param) {
+    // "<plugins_dir>/<PLUGIN_NAME><suffix>": the ini and every file the plugin keeps next to it.
+    std::filesystem::path GetPluginFilePath(const Nioh3PluginInitializeParam* param, std::string_view suffix) {
         std::filesystem::path pluginsDir = (param && param->plugins_dir) ? param->plugins_dir : "";
-        std::string moduleName = PLUGIN_NAME;
-        return pluginsDir / (moduleName + ".ini");
+        std::string fileName = PLUGIN_NAME;
+        return pluginsDir / fileName.append(suffix);
     }
 
     bool ReadIniBool(const std::filesystem::path& iniPath, const char* section, const char* key, bool defaultValue) {
@@ -23,6 +28,15 @@ namespace {
         int value = GetPrivateProfileIntA(section, key, defaultValue ? 1 : 0, iniPath.string().c_str());
         return value != 0;
     }
+
+    // Negative values read as 0.
+    std::uint64_t ReadIniUInt(const std::filesystem::path& iniPath, const char* section, const char* key, std::uint64_t defaultValue) {
+        if (!std::filesystem::exists(iniPath)) {
+            return defaultValue;
+        }
+        int value = GetPrivateProfileIntA(section, key, static_cast<int>(defaultValue), iniPath.string().c_str());
+        return value > 0 ? static_cast<std::uint64_t>(value) : 0;
+    }
 }
 
 
@@ -33,11 +47,67 @@ extern "C" __declspec(dllexport) bool nioh3_plugin_initialize(const Nioh3PluginI
     _MESSAGE("Game version: %s", param->game_version_string);
     _MESSAGE("Plugin dir: %s", param->plugins_dir);
 
-    auto iniPath = GetIniPath(param);
+    auto iniPath = GetPluginFilePath(param, ".ini");
     g_enableAssetLoadingLog = ReadIniBool(iniPath, PLUGIN_NAME, "EnableAssetLoadingLog", false);
     _MESSAGE("EnableAssetLoadingLog: %d", g_enableAssetLoadingLog ? 1 : 0);
+    g_validateAssetIdTable = ReadIniBool(iniPath, PLUGIN_NAME, "ValidateAssetIdTable", false);
+    if (ReadIniBool(iniPath, PLUGIN_NAME, "EnableAssetTelemetry", false)) {
+        const std::uint64_t interval = ReadIniUInt(iniPath, PLUGIN_NAME, "AssetTelemetryIntervalSec", 60);
+        // Per-type asset load counters and latency histograms, rewritten while the game runs.
+        const auto telemetryPath = GetPluginFilePath(param, ".telemetry.json");
+        std::string error;
+        if (g_assetTelemetry.StartDumping(telemetryPath, std::chrono::seconds(interval), GetAssetTypeNameResolver(), &error)) {
+            _MESSAGE("Asset telemetry: %s every %llus", telemetryPath.string().c_str(), static_cast<unsigned long long>(interval));
+        } else {
+            _MESSAGE("Asset telemetry disabled: %s", error.c_str());
+        }
+    }
+    if (ReadIniBool(iniPath, PLUGIN_NAME, "EnableAssetLoadTrace", false)) {
+        // Binary record of every asset load in this session, for tools/AssetTraceReplay.
+        const auto tracePath = GetPluginFilePath(param, ".lftrace");
+        std::string error;
+        if (g_assetLoadTrace.Start(tracePath, &error)) {
+            _MESSAGE("Asset load trace: %s", tracePath.string().c_str());
+        } else {
+            _MESSAGE("Asset load trace disabled: %s", error.c_str());
+        }
+    }
 
-    g_modAssetManager.Build(param->game_root_dir);
+    // Optional ktid name table (NameTool output or a "hash,name" CSV) next to the ini.
+    const auto namesPath = GetPluginFilePath(param, ".names");
+    if (std::filesystem::exists(namesPath)) {
+        std::string error;
+        g_nameDictionary = NameDictionary::Load(namesPath, &error);
+        if (g_nameDictionary.has_value()) {
+            _MESSAGE("Loaded %zu ktid names from %s", g_nameDictionary->Size(), namesPath.string().c_str());
+        } else {
+            _MESSAGE("Failed to load ktid names: %s", error.c_str());
+        }
+    }
+
+    // Small overrides can be served from memory instead of being opened on every load.
+    const std::uint64_t preloadBudgetMB = ReadIniUInt(iniPath, PLUGIN_NAME, "PreloadBudgetMB", 0);
+    const std::uint64_t preloadMaxFileKB = ReadIniUInt(iniPath, PLUGIN_NAME, "PreloadMaxFileKB", 256);
+    _MESSAGE("PreloadBudgetMB: %llu, PreloadMaxFileKB: %llu",
+        static_cast<unsigned long long>(preloadBudgetMB), static_cast<unsigned long long>(preloadMaxFileKB));
+    g_modAssetManager.SetPreloadBudget(preloadBudgetMB << 20, preloadMaxFileKB << 10);
+
+    // The binary index is rewritten whenever a mod folder changes.
+    g_modAssetManager.Build(param->game_root_dir, GetPluginFilePath(param, ".modcache"));
+    if (ReadIniBool(iniPath, PLUGIN_NAME, "EnableModHotReload", false)) {
+        std::string error;
+        if (!g_modAssetManager.StartWatching(&error)) {
+            _MESSAGE("Mod hot reload disabled: %s", error.c_str());
+        }
+    }
+    if (ReadIniBool(iniPath, PLUGIN_NAME, "EnableModPrefetch", false)) {
+        const std::uint64_t lookahead = ReadIniUInt(iniPath, PLUGIN_NAME, "PrefetchLookahead", ModPrefetcher::kDefaultLookahead);
+        std::string error;
+        // The order of override hits from earlier sessions, used to read ahead of the game.
+        if (!g_modPrefetcher.Start(g_modAssetManager, GetPluginFilePath(param, ".modprofile"), lookahead, &error)) {
+            _MESSAGE("Mod prefetch disabled: %s", error.c_str());
+        }
+    }
     if (!InstallHooks()) {
         _MESSAGE("Failed to install LooseFileLoader hooks");
         return false;
@@ -0,0 +1,181 @@
+#include "AssetDeserializer.h"
+#include "AssetLoadTrace.h"
+#include "AssetTelemetry.h"
+#include "ModAssetManager.h"
+#include "ModFileReader.h"
+#include "ModPrefetcher.h"
+#include "NameHash.h"
+
+#include <LogUtils.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace LooseFileLoader {
+namespace {
+
+std::string FormatDiskSize(std::uint64_t size) {
+    constexpr double kUnit = 1024.0;
+    constexpr const char* kUnits[] = {"B", "KB", "MB", "GB", "TB"};
+
+    double value = static_cast<double>(size);
+    std::size_t unitIndex = 0;
+    while (value >= kUnit && unitIndex < (std::size(kUnits) - 1)) {
+        value /= kUnit;
+        ++unitIndex;
+    }
+
+    if (unitIndex == 0) {
+        return std::to_string(size) + "B";
+    }
+
+    char buffer[32] = {};
+    std::snprintf(buffer, sizeof(buffer), "%.1f%s", value, kUnits[unitIndex]);
+    return buffer;
+}
+
+// "0x1234ABCD", or "0x1234ABCD (name)" when the name dictionary knows the ktid.
+std::string FormatKtid(std::uint32_t ktid) {
+    char buffer[16] = {};
+    std::snprintf(buffer, sizeof(buffer), "0x%08X", ktid);
+    std::string text = buffer;
+    if (g_nameDictionary.has_value()) {
+        const std::string_view name = g_nameDictionary->Find(ktid);
+        if (!name.empty()) {
+            text.append(" (").append(name).append(")");
+        }
+    }
+    return text;
+}
+
+// Telemetry and trace record for one Deserialize call that began at start.
+void RecordAssetLoad(AssetTelemetry::Clock::time_point start, const IBaseGameAssetHandler* assetHandler,
+                     const GameAsset* gameAsset, std::uint32_t fileKtid, std::uint64_t bytes, bool isOverride) {
+    const auto end = AssetTelemetry::Clock::now();
+    const std::uint32_t typeInfoKtid = gameAsset != nullptr ? gameAsset->typeInfoKtid : 0;
+    if (g_assetTelemetry.IsEnabled()) {
+        AssetLoadSample sample{};
+        sample.typeInfoKtid = typeInfoKtid;
+        sample.handler = assetHandler;
+        sample.bytes = bytes;
+        sample.nanoseconds = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        sample.isOverride = isOverride;
+        g_assetTelemetry.Record(sample);
+    }
+    if (g_assetLoadTrace.IsEnabled()) {
+        g_assetLoadTrace.Record(start, end, fileKtid, typeInfoKtid, bytes, isOverride);
+    }
+}
+
+[[nodiscard]] bool IsAssetLoadRecorded() {
+    return g_assetTelemetry.IsEnabled() || g_assetLoadTrace.IsEnabled();
+}
+
+}  // namespace
+
+const char* GetAssetHandlerTypeName(const IBaseGameAssetHandler* assetHandler) {
+    const char* typeName = nullptr;
+    if (assetHandler != nullptr) {
+        assetHandler->GetTypeName(typeName);
+    }
+    return typeName != nullptr ? typeName : "Unknown";
+}
+
+void* DeserializeAsset(IBaseGameAssetHandler* assetHandler, AssetLoadingContext* loadingContext,
+                       AssetReader* assetReader, void* param3, std::uint32_t fileKtid) {
+    auto *gameAsset = loadingContext->gameAsset;
+    auto assetFileSize = assetReader->assetFileSize;
+
+    do {
+        if (gameAsset == nullptr || fileKtid == kInvalidFileKtid) {
+            break;
+        }
+        const auto typeId = gameAsset->typeInfoKtid;
+
+        if (g_enableAssetLoadingLog) {
+            _MESSAGE("\tLoading asset: %s | Type: %s (0x%08X) | Size: %s", FormatKtid(fileKtid).c_str(), GetAssetHandlerTypeName(assetHandler), typeId, FormatDiskSize(assetFileSize).c_str());
+        }
+
+        // Size and validity were cached when the index was built: no stat, path copy or heap
+        // allocation here. Deserialize is synchronous, so the reader can live on this frame,
+        // and the snapshot guard keeps modOverride alive across a concurrent hot reload.
+        const auto overrides = g_modAssetManager.Acquire();
+        const ModOverride* modOverride = overrides->Find(fileKtid);
+        if (modOverride == nullptr || !modOverride->valid) {
+            break;
+        }
+        g_modPrefetcher.OnOverrideHit(fileKtid);
+
+        // Preloaded overrides are served from the index arena, compressed ones are inflated as
+        // they are read, deltas are applied to the game's own stream, and the rest stream from
+        // disk.
+        std::optional<ModMemoryReader> memoryReader;
+        std::optional<ModInflateReader> inflateReader;
+        std::optional<ModDeltaReader> deltaReader;
+        std::optional<ModFileReader> fileReader;
+        ModStreamReader* reader = nullptr;
+        if (modOverride->preloaded) {
+            reader = &memoryReader.emplace(*modOverride);
+        } else if (modOverride->compressed) {
+            reader = &inflateReader.emplace(*modOverride);
+        } else if (modOverride->delta) {
+            if (assetReader->streamReader == nullptr) {
+                break;
+            }
+            reader = &deltaReader.emplace(*modOverride, *assetReader->streamReader, assetFileSize);
+            if (!reader->IsOpen() && deltaReader->IsSourceMismatch()) {
+                if (deltaReader->GetSourceSize() != assetFileSize) {
+                    _MESSAGE("Mod delta expects a %llu-byte original, the game has %llu bytes; loading the original: %s",
+                             static_cast<unsigned long long>(deltaReader->GetSourceSize()),
+                             static_cast<unsigned long long>(assetFileSize), modOverride->displayPath.c_str());
+                } else {
+                    _MESSAGE("Mod delta was made for another original (CRC-32 differs); loading the original: %s",
+                             modOverride->displayPath.c_str());
+                }
+                break;
+            }
+        } else {
+            reader = &fileReader.emplace(*modOverride);
+        }
+        if (!reader->IsOpen()) {
+            _MESSAGE("Failed to open mod asset file: %s", modOverride->displayPath.c_str());
+            break;
+        }
+
+        assetReader->streamReader = reader;
+        assetReader->assetFileSize = reader->GetFileSize();
+        assetReader->archiveFileOffset = 0;
+
+        const bool recorded = IsAssetLoadRecorded();
+        const auto start = recorded ? AssetTelemetry::Clock::now() : AssetTelemetry::Clock::time_point{};
+        auto *assetData = assetHandler->Deserialize(loadingContext, assetReader, param3);
+        if (recorded) {
+            RecordAssetLoad(start, assetHandler, gameAsset, fileKtid, reader->GetFileSize(), true);
+        }
+
+        if (assetData) {
+            _MESSAGE("Loaded mod asset successfully: %s | Type: %s (0x%08X) | %s",
+                    FormatKtid(fileKtid).c_str(), GetAssetHandlerTypeName(assetHandler), typeId, modOverride->displayPath.c_str());
+        } else {
+            _MESSAGE("Failed to load mod asset: %s | Type: %s (0x%08X) | %s",
+                    FormatKtid(fileKtid).c_str(), GetAssetHandlerTypeName(assetHandler), typeId, modOverride->displayPath.c_str());
+        }
+        return assetData;
+    } while (false);
+
+    // call original deserialize function
+    const bool recorded = IsAssetLoadRecorded();
+    const auto start = recorded ? AssetTelemetry::Clock::now() : AssetTelemetry::Clock::time_point{};
+    auto *assetData = assetHandler->Deserialize(loadingContext, assetReader, param3);
+    if (recorded) {
+        RecordAssetLoad(start, assetHandler, gameAsset, fileKtid, assetFileSize, false);
+    }
+    return assetData;
+}
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,266 @@
+#include "AssetIdTable.h"
+#include "RdbTool.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <limits>
+#include <utility>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define LOOSEFILELOADER_ASSET_ID_SSE2 1
+#endif
+
+namespace LooseFileLoader {
+namespace {
+
+constexpr std::uint32_t kPadKey = std::numeric_limits<std::uint32_t>::max();
+
+[[nodiscard]] std::uint32_t CeilDiv(std::uint32_t value, std::uint32_t divisor) {
+    return (value + divisor - 1) / divisor;
+}
+
+[[nodiscard]] std::uint32_t DepthFor(std::uint32_t keyCount, std::uint32_t keysPerNode) {
+    if (keyCount == 0 || keysPerNode == 0) {
+        return 0;
+    }
+    std::uint32_t buckets = CeilDiv(keyCount, keysPerNode);
+    std::uint32_t depth = 1;
+    while (buckets > 1) {
+        buckets = CeilDiv(buckets, keysPerNode + 1);
+        ++depth;
+    }
+    return depth;
+}
+
+// LSD radix sort, 8 bits per pass, like RadixSortFileKtid.
+void RadixSort(std::vector<std::uint32_t>* keys) {
+    std::vector<std::uint32_t> scratch(keys->size());
+    std::vector<std::uint32_t>* src = keys;
+    std::vector<std::uint32_t>* dst = &scratch;
+    for (std::uint32_t shift = 0; shift < 32; shift += 8) {
+        std::array<std::size_t, 257> offsets{};
+        for (const std::uint32_t key : *src) {
+            ++offsets[((key >> shift) & 0xFFu) + 1];
+        }
+        for (std::size_t i = 1; i < offsets.size(); ++i) {
+            offsets[i] += offsets[i - 1];
+        }
+        for (const std::uint32_t key : *src) {
+            (*dst)[offsets[(key >> shift) & 0xFFu]++] = key;
+        }
+        std::swap(src, dst);
+    }
+    // Four passes end back in *keys.
+}
+
+// Number of keys in one 16-key bucket that are <= value. Buckets are sorted and padded with
+// kPadKey, so this is also the child index to descend into.
+[[nodiscard]] std::uint32_t CountLessOrEqual(const std::uint32_t* bucket, std::uint32_t value) {
+    static_assert(AssetIdTable::kKeysPerNode == 16);
+#ifdef LOOSEFILELOADER_ASSET_ID_SSE2
+    // SSE2 only has signed compares; flipping the sign bit orders unsigned values correctly.
+    const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i probe = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(value)), bias);
+    const auto* lanes = reinterpret_cast<const __m128i*>(bucket);
+    const __m128i gt0 = _mm_cmpgt_epi32(_mm_xor_si128(_mm_load_si128(lanes + 0), bias), probe);
+    const __m128i gt1 = _mm_cmpgt_epi32(_mm_xor_si128(_mm_load_si128(lanes + 1), bias), probe);
+    const __m128i gt2 = _mm_cmpgt_epi32(_mm_xor_si128(_mm_load_si128(lanes + 2), bias), probe);
+    const __m128i gt3 = _mm_cmpgt_epi32(_mm_xor_si128(_mm_load_si128(lanes + 3), bias), probe);
+    const __m128i packed = _mm_packs_epi16(_mm_packs_epi32(gt0, gt1), _mm_packs_epi32(gt2, gt3));
+    const auto greater = static_cast<std::uint32_t>(_mm_movemask_epi8(packed));
+    return AssetIdTable::kKeysPerNode - static_cast<std::uint32_t>(std::popcount(greater));
+#else
+    std::uint32_t count = 0;
+    for (std::uint32_t i = 0; i < AssetIdTable::kKeysPerNode; ++i) {
+        count += (bucket[i] <= value) ? 1u : 0u;
+    }
+    return count;
+#endif
+}
+
+}  // namespace
+
+AssetIdTable AssetIdTable::Build(std::span<const std::uint32_t> fileKtids) {
+    std::vector<std::uint32_t> keys(fileKtids.begin(), fileKtids.end());
+    RadixSort(&keys);
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    AssetIdTable table;
+    table.BuildLayers(std::move(keys));
+    return table;
+}
+
+AssetIdTable AssetIdTable::Build(std::span<const RdbEntry> entries) {
+    std::vector<std::uint32_t> fileKtids;
+    fileKtids.reserve(entries.size());
+    for (const RdbEntry& entry : entries) {
+        fileKtids.push_back(entry.fileKtid);
+    }
+    return Build(fileKtids);
+}
+
+void AssetIdTable::BuildLayers(std::vector<std::uint32_t> sortedUniqueKeys) {
+    keyCount_ = static_cast<std::uint32_t>(sortedUniqueKeys.size());
+    nodes_.clear();
+    layerOffsets_.clear();
+    if (keyCount_ == 0) {
+        return;
+    }
+
+    std::vector<std::uint32_t> bucketsPerLayer{CeilDiv(keyCount_, kKeysPerNode)};
+    while (bucketsPerLayer.back() > 1) {
+        bucketsPerLayer.push_back(CeilDiv(bucketsPerLayer.back(), kBranchFactor));
+    }
+
+    std::uint32_t total = 0;
+    for (const std::uint32_t buckets : bucketsPerLayer) {
+        layerOffsets_.push_back(total);
+        total += buckets * kKeysPerNode;
+    }
+    nodes_.assign(total, kPadKey);
+    std::copy(sortedUniqueKeys.begin(), sortedUniqueKeys.end(), nodes_.begin());
+
+    // Layer h, bucket t, key j separates child (t * kBranchFactor + j + 1); its value is the
+    // first layer-0 key below that child, i.e. at bucket child * kBranchFactor^(h - 1).
+    std::uint64_t leafBucketsPerChild = 1;
+    for (std::size_t layer = 1; layer < bucketsPerLayer.size(); ++layer) {
+        const std::uint32_t childBuckets = bucketsPerLayer[layer - 1];
+        for (std::uint32_t bucket = 0; bucket < bucketsPerLayer[layer]; ++bucket) {
+            for (std::uint32_t j = 0; j < kKeysPerNode; ++j) {
+                const std::uint64_t child = std::uint64_t{bucket} * kBranchFactor + j + 1;
+                const std::uint64_t leafIndex = child * leafBucketsPerChild * kKeysPerNode;
+                if (child < childBuckets && leafIndex < keyCount_) {
+                    nodes_[layerOffsets_[layer] + bucket * kKeysPerNode + j] =
+                        sortedUniqueKeys[static_cast<std::size_t>(leafIndex)];
+                }
+            }
+        }
+        leafBucketsPerChild *= kBranchFactor;
+    }
+}
+
+std::uint32_t AssetIdTable::LowerBound(std::uint32_t fileKtid) const {
+    if (keyCount_ == 0) {
+        return 0;
+    }
+    // The pad key compares equal to this probe, so the descent would walk into padding.
+    if (fileKtid == kPadKey) {
+        return nodes_[keyCount_ - 1] == kPadKey ? keyCount_ - 1 : keyCount_;
+    }
+
+    std::uint32_t bucket = 0;
+    for (std::size_t layer = layerOffsets_.size() - 1; layer > 0; --layer) {
+        const std::uint32_t* node = nodes_.data() + layerOffsets_[layer] + bucket * kKeysPerNode;
+        bucket = bucket * kBranchFactor + CountLessOrEqual(node, fileKtid);
+    }
+
+    const std::uint32_t* leaf = nodes_.data() + bucket * kKeysPerNode;
+    const std::uint32_t less = (fileKtid == 0) ? 0 : CountLessOrEqual(leaf, fileKtid - 1);
+    return bucket * kKeysPerNode + less;
+}
+
+std::uint32_t AssetIdTable::Find(std::uint32_t fileKtid) const {
+    const std::uint32_t position = LowerBound(fileKtid);
+    if (position < keyCount_ && nodes_[position] == fileKtid) {
+        return position;
+    }
+    return kInvalidResId;
+}
+
+std::span<const std::uint32_t> AssetIdTable::SortedKeys() const {
+    return {nodes_.data(), keyCount_};
+}
+
+std::uint32_t AssetIdTable::KeyCount() const {
+    return keyCount_;
+}
+
+std::uint32_t AssetIdTable::TreeDepth() const {
+    return static_cast<std::uint32_t>(layerOffsets_.size());
+}
+
+std::uint32_t AssetIdTable::BranchSpan() const {
+    std::uint32_t span = 1;
+    for (std::size_t layer = 2; layer < layerOffsets_.size(); ++layer) {
+        span *= kBranchFactor;
+    }
+    return span;
+}
+
+std::size_t AssetIdTable::MemoryBytes() const {
+    return nodes_.size() * sizeof(std::uint32_t) + layerOffsets_.size() * sizeof(std::uint32_t);
+}
+
+std::uint32_t AssetIdTable::DepthForKeyCount(std::uint32_t keyCount) {
+    return DepthFor(keyCount, kKeysPerNode);
+}
+
+AssetIdLayoutReport ValidateAssetIdManagerLayout(const AssetIdManagerLayout& layout,
+                                                 const std::function<std::uint32_t(std::uint32_t)>& gameLookup,
+                                                 std::size_t sampleCount) {
+    AssetIdLayoutReport report;
+    char buffer[192] = {};
+
+    if (layout.sortedFileKtid == nullptr || layout.keyCount == 0) {
+        report.issues.emplace_back("sortedFileKtid is null or keyCount is 0.");
+        return report;
+    }
+
+    report.keysSorted = true;
+    for (std::uint32_t i = 1; i < layout.keyCount; ++i) {
+        if (layout.sortedFileKtid[i - 1] >= layout.sortedFileKtid[i]) {
+            std::snprintf(buffer, sizeof(buffer), "sortedFileKtid is not strictly ascending at index %u.", i);
+            report.issues.emplace_back(buffer);
+            report.keysSorted = false;
+            break;
+        }
+    }
+
+    if (layout.keyCountCopy != layout.keyCount) {
+        std::snprintf(buffer, sizeof(buffer), "keyCountCopy=%u differs from keyCount=%u.", layout.keyCountCopy,
+                      layout.keyCount);
+        report.issues.emplace_back(buffer);
+    }
+
+    const std::uint32_t keysPerBucket = layout.branchFactor > 1 ? layout.branchFactor - 1 : 0;
+    report.strideMatchesBranchFactor =
+        keysPerBucket != 0 && layout.bucketStrideBytes == keysPerBucket * sizeof(std::uint32_t);
+    if (!report.strideMatchesBranchFactor) {
+        std::snprintf(buffer, sizeof(buffer), "bucketStrideBytes=%u does not hold branchFactor-1=%u keys.",
+                      layout.bucketStrideBytes, keysPerBucket);
+        report.issues.emplace_back(buffer);
+    }
+
+    const std::uint32_t expectedDepth = DepthFor(layout.keyCount, keysPerBucket);
+    report.depthMatchesKeyCount = expectedDepth == layout.treeDepth;
+    if (!report.depthMatchesKeyCount) {
+        std::snprintf(buffer, sizeof(buffer),
+                      "treeDepth=%u (stepPerDepth=%u, branchSpan=%u); a %u-key bucket tree needs %u layers.",
+                      layout.treeDepth, layout.stepPerDepth, layout.branchSpan, keysPerBucket, expectedDepth);
+        report.issues.emplace_back(buffer);
+    }
+
+    if (gameLookup && report.keysSorted) {
+        const std::size_t samples = std::min<std::size_t>(std::max<std::size_t>(sampleCount, 1), layout.keyCount);
+        for (std::size_t s = 0; s < samples; ++s) {
+            const auto index = static_cast<std::uint32_t>(s * (layout.keyCount - 1) / std::max<std::size_t>(samples - 1, 1));
+            const std::uint32_t resId = gameLookup(layout.sortedFileKtid[index]);
+            ++report.sampledLookups;
+            if (resId != index) {
+                if (report.lookupMismatches == 0) {
+                    std::snprintf(buffer, sizeof(buffer), "Game lookup of 0x%08X returned %u, expected rank %u.",
+                                  layout.sortedFileKtid[index], resId, index);
+                    report.issues.emplace_back(buffer);
+                }
+                ++report.lookupMismatches;
+            }
+        }
+    }
+
+    return report;
+}
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,209 @@
+#include "AssetLoadTrace.h"
+
+#include "MappedFile.h"
+
+#include "binary_io/binary_io.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace LooseFileLoader {
+namespace {
+
+constexpr std::array<char, 4> kTraceMagic{'L', 'F', 'A', 'T'};
+constexpr std::uint32_t kTraceVersion = 1;
+
+std::atomic<std::uint64_t> g_nextTraceId{1};
+
+void SetError(std::string* error, std::string_view message) {
+    if (error != nullptr) {
+        *error = std::string(message);
+    }
+}
+
+}  // namespace
+
+struct AssetLoadTrace::Writer {
+    std::mutex mutex{};
+    std::condition_variable wake{};
+    // Records are accepted while open; cleared by Stop or a failed write.
+    bool open = false;
+    bool stopping = false;
+    std::vector<AssetLoadTraceRecord> pending{};
+    std::thread thread{};
+    fs::path path{};
+    // Only touched by the writer thread while it runs.
+    std::optional<binary_io::file_ostream> out{};
+    std::uint64_t written = 0;
+    // Set by a failed write, which also stops recording.
+    std::string failure{};
+
+    void Run(AssetLoadTrace& trace) {
+        std::vector<AssetLoadTraceRecord> batch;
+        std::unique_lock lock(mutex);
+        while (true) {
+            wake.wait_for(lock, kFlushInterval, [this]() { return stopping; });
+            const bool last = stopping;
+            batch.swap(pending);
+            lock.unlock();
+            bool failed = false;
+            if (!batch.empty()) {
+                try {
+                    out->write_bytes(std::as_bytes(std::span(batch)));
+                    out->flush();
+                    written += batch.size();
+                } catch (const std::exception& ex) {
+                    failure = std::string("Failed to write asset load trace: ") + ex.what();
+                    failed = true;
+                }
+                batch.clear();
+            }
+            lock.lock();
+            if (failed) {
+                trace.enabled_.store(false, std::memory_order_relaxed);
+                open = false;
+                pending.clear();
+            }
+            if (last || failed) {
+                return;
+            }
+        }
+    }
+};
+
+AssetLoadTrace::AssetLoadTrace() : id_(g_nextTraceId.fetch_add(1)), writer_(std::make_unique<Writer>()) {}
+
+AssetLoadTrace::~AssetLoadTrace() {
+    Stop();
+}
+
+bool AssetLoadTrace::Start(const fs::path& path, std::string* error) {
+    Stop();
+    if (path.empty()) {
+        SetError(error, "Asset load trace path is empty.");
+        return false;
+    }
+
+    Writer& writer = *writer_;
+    try {
+        if (!path.parent_path().empty()) {
+            fs::create_directories(path.parent_path());
+        }
+        const AssetLoadTraceHeader header{};
+        writer.out.emplace(path, binary_io::write_mode::truncate);
+        writer.out->write_bytes(std::as_bytes(std::span(&header, 1)));
+        writer.out->flush();
+    } catch (const std::exception& ex) {
+        writer.out.reset();
+        SetError(error, std::string("Failed to create asset load trace: ") + ex.what());
+        return false;
+    }
+
+    std::lock_guard lock(writer.mutex);
+    writer.path = path;
+    writer.written = 0;
+    writer.failure.clear();
+    writer.pending.clear();
+    writer.stopping = false;
+    writer.open = true;
+    origin_ = Clock::now();
+    nextThreadIndex_.store(0, std::memory_order_relaxed);
+    writer.thread = std::thread([this, &writer]() { writer.Run(*this); });
+    enabled_.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+bool AssetLoadTrace::Stop(std::string* error) {
+    enabled_.store(false, std::memory_order_relaxed);
+    Writer& writer = *writer_;
+    {
+        std::lock_guard lock(writer.mutex);
+        writer.open = false;
+        writer.stopping = true;
+    }
+    writer.wake.notify_all();
+    if (writer.thread.joinable()) {
+        writer.thread.join();
+    }
+    writer.out.reset();
+    if (!writer.failure.empty()) {
+        SetError(error, writer.failure);
+        return false;
+    }
+    return true;
+}
+
+std::uint16_t AssetLoadTrace::LocalThreadIndex() {
+    struct Cache {
+        std::uint64_t owner = 0;
+        std::uint16_t index = 0;
+    };
+    thread_local Cache cache{};
+    if (cache.owner != id_) {
+        const std::uint32_t index = nextThreadIndex_.fetch_add(1, std::memory_order_relaxed);
+        cache = {id_, static_cast<std::uint16_t>(std::min<std::uint32_t>(index, std::numeric_limits<std::uint16_t>::max()))};
+    }
+    return cache.index;
+}
+
+void AssetLoadTrace::Record(Clock::time_point start, Clock::time_point end, std::uint32_t fileKtid,
+                            std::uint32_t typeInfoKtid, std::uint64_t size, bool isOverride) {
+    AssetLoadTraceRecord record{};
+    record.startNanoseconds = static_cast<std::uint64_t>(
+        std::max<std::int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin_).count()));
+    record.size = size;
+    record.fileKtid = fileKtid;
+    record.typeInfoKtid = typeInfoKtid;
+    const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    record.nanoseconds = static_cast<std::uint32_t>(
+        std::clamp<std::int64_t>(nanoseconds, 0, std::numeric_limits<std::uint32_t>::max()));
+    record.threadIndex = LocalThreadIndex();
+    record.flags = isOverride ? kAssetLoadTraceOverride : 0;
+
+    Writer& writer = *writer_;
+    std::lock_guard lock(writer.mutex);
+    if (writer.open) {
+        writer.pending.push_back(record);
+    }
+}
+
+std::optional<std::vector<AssetLoadTraceRecord>> AssetLoadTrace::Load(const fs::path& path, std::string* error) {
+    auto mapping = MappedFile::Open(path, error);
+    if (!mapping.has_value()) {
+        return std::nullopt;
+    }
+    const auto bytes = mapping->Bytes();
+    if (bytes.size() < sizeof(AssetLoadTraceHeader)) {
+        SetError(error, "Asset load trace is too small.");
+        return std::nullopt;
+    }
+    AssetLoadTraceHeader header{};
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, kTraceMagic.data(), kTraceMagic.size()) != 0 || header.version != kTraceVersion ||
+        header.recordSize != sizeof(AssetLoadTraceRecord)) {
+        SetError(error, "Unsupported asset load trace format.");
+        return std::nullopt;
+    }
+
+    // A trace cut short by a crash may end in part of a record; that record is dropped.
+    std::vector<AssetLoadTraceRecord> records((bytes.size() - sizeof(header)) / sizeof(AssetLoadTraceRecord));
+    if (!records.empty()) {
+        std::memcpy(records.data(), bytes.data() + sizeof(header), records.size() * sizeof(AssetLoadTraceRecord));
+    }
+    std::stable_sort(records.begin(), records.end(), [](const AssetLoadTraceRecord& lhs, const AssetLoadTraceRecord& rhs) {
+        return lhs.startNanoseconds < rhs.startNanoseconds;
+    });
+    return records;
+}
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,359 @@
+#include "AssetTelemetry.h"
+
+#include "binary_io/binary_io.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <condition_variable>
+#include <cstdio>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace LooseFileLoader {
+namespace {
+
+std::atomic<std::uint64_t> g_nextTelemetryId{1};
+
+void SetError(std::string* error, std::string_view message) {
+    if (error != nullptr) {
+        *error = std::string(message);
+    }
+}
+
+// Single-writer counter: a relaxed load and store, which is a plain add on x64 (no lock prefix).
+void Bump(std::atomic<std::uint64_t>& counter, std::uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+[[nodiscard]] std::size_t LatencyBucket(std::uint64_t nanoseconds) {
+    return std::min<std::size_t>(static_cast<std::size_t>(std::bit_width(nanoseconds)), kAssetLatencyBuckets - 1);
+}
+
+// AssetLoadStats as relaxed atomics, written only by the owning thread.
+struct CounterBlock {
+    std::atomic<std::uint64_t> count{};
+    std::atomic<std::uint64_t> bytes{};
+    std::atomic<std::uint64_t> totalNanoseconds{};
+    std::atomic<std::uint64_t> maxNanoseconds{};
+    std::array<std::atomic<std::uint64_t>, kAssetLatencyBuckets> histogram{};
+
+    void Add(const AssetLoadSample& sample) {
+        Bump(count, 1);
+        Bump(bytes, sample.bytes);
+        Bump(totalNanoseconds, sample.nanoseconds);
+        if (sample.nanoseconds > maxNanoseconds.load(std::memory_order_relaxed)) {
+            maxNanoseconds.store(sample.nanoseconds, std::memory_order_relaxed);
+        }
+        Bump(histogram[LatencyBucket(sample.nanoseconds)], 1);
+    }
+
+    void AddTo(AssetLoadStats& out) const {
+        out.count += count.load(std::memory_order_relaxed);
+        out.bytes += bytes.load(std::memory_order_relaxed);
+        out.totalNanoseconds += totalNanoseconds.load(std::memory_order_relaxed);
+        out.maxNanoseconds = std::max(out.maxNanoseconds, maxNanoseconds.load(std::memory_order_relaxed));
+        for (std::size_t i = 0; i < kAssetLatencyBuckets; ++i) {
+            out.histogram[i] += histogram[i].load(std::memory_order_relaxed);
+        }
+    }
+};
+
+struct TypeSlot {
+    // Set last (release) once typeInfoKtid and handler are in place.
+    std::atomic<bool> used{false};
+    std::atomic<std::uint32_t> typeInfoKtid{};
+    std::atomic<const void*> handler{};
+    CounterBlock vanilla{};
+    CounterBlock overrides{};
+};
+
+void AppendDec(std::string& out, std::uint64_t value) {
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// Nanoseconds as microseconds with three decimals.
+void AppendMicroseconds(std::string& out, std::uint64_t nanoseconds) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(nanoseconds) / 1000.0);
+    out.append(buffer);
+}
+
+void AppendJsonString(std::string& out, std::string_view text) {
+    out.push_back('"');
+    for (const char ch : text) {
+        if (ch == '"' || ch == '\\') {
+            out.push_back('\\');
+            out.push_back(ch);
+        } else if (static_cast<unsigned char>(ch) < 0x20) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(ch)));
+            out.append(buffer);
+        } else {
+            out.push_back(ch);
+        }
+    }
+    out.push_back('"');
+}
+
+void AppendStatsJson(std::string& out, const AssetLoadStats& stats) {
+    out.append("{\"count\":");
+    AppendDec(out, stats.count);
+    out.append(",\"bytes\":");
+    AppendDec(out, stats.bytes);
+    out.append(",\"totalUs\":");
+    AppendMicroseconds(out, stats.totalNanoseconds);
+    out.append(",\"maxUs\":");
+    AppendMicroseconds(out, stats.maxNanoseconds);
+    out.append(",\"p50Us\":");
+    AppendMicroseconds(out, stats.PercentileNanoseconds(0.5));
+    out.append(",\"p99Us\":");
+    AppendMicroseconds(out, stats.PercentileNanoseconds(0.99));
+    // Trailing empty buckets are dropped; index b is the [2^(b-1), 2^b) ns bucket.
+    out.append(",\"histogram\":[");
+    std::size_t used = kAssetLatencyBuckets;
+    while (used > 0 && stats.histogram[used - 1] == 0) {
+        --used;
+    }
+    for (std::size_t i = 0; i < used; ++i) {
+        if (i != 0) {
+            out.push_back(',');
+        }
+        AppendDec(out, stats.histogram[i]);
+    }
+    out.append("]}");
+}
+
+}  // namespace
+
+std::uint64_t AssetLoadStats::PercentileNanoseconds(double fraction) const {
+    if (count == 0) {
+        return 0;
+    }
+    const auto target = static_cast<std::uint64_t>(std::max(1.0, fraction * static_cast<double>(count) + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i + 1 < kAssetLatencyBuckets; ++i) {
+        seen += histogram[i];
+        if (seen >= target) {
+            return std::min(std::uint64_t{1} << i, maxNanoseconds);
+        }
+    }
+    return maxNanoseconds;
+}
+
+struct AssetTelemetry::ThreadTable {
+    std::thread::id owner{};
+    std::array<TypeSlot, kTypesPerThread> slots{};
+    CounterBlock untracked{};
+
+    // Linear probing from a multiplicative hash; slots are claimed and never released.
+    TypeSlot* Find(std::uint32_t typeInfoKtid, const void* handler) {
+        static_assert(std::has_single_bit(kTypesPerThread));
+        constexpr int kIndexBits = std::countr_zero(kTypesPerThread);
+        std::size_t index = (typeInfoKtid * 0x9E3779B1u) >> (32 - kIndexBits);
+        for (std::size_t probe = 0; probe < kTypesPerThread; ++probe) {
+            TypeSlot& slot = slots[index];
+            if (!slot.used.load(std::memory_order_relaxed)) {
+                slot.typeInfoKtid.store(typeInfoKtid, std::memory_order_relaxed);
+                slot.handler.store(handler, std::memory_order_relaxed);
+                slot.used.store(true, std::memory_order_release);
+                return &slot;
+            }
+            if (slot.typeInfoKtid.load(std::memory_order_relaxed) == typeInfoKtid) {
+                return &slot;
+            }
+            index = (index + 1) % kTypesPerThread;
+        }
+        return nullptr;
+    }
+};
+
+struct AssetTelemetry::Dumper {
+    std::mutex mutex{};
+    std::condition_variable wake{};
+    bool stopping = false;
+    std::thread thread{};
+    fs::path path{};
+    TypeNameResolver resolver{};
+};
+
+AssetTelemetry::AssetTelemetry() : id_(g_nextTelemetryId.fetch_add(1)), created_(Clock::now()) {}
+
+AssetTelemetry::~AssetTelemetry() {
+    StopDumping();
+}
+
+AssetTelemetry::ThreadTable& AssetTelemetry::LocalTable() {
+    struct Cache {
+        std::uint64_t owner = 0;
+        ThreadTable* table = nullptr;
+    };
+    thread_local Cache cache{};
+    if (cache.owner == id_) {
+        return *cache.table;
+    }
+
+    std::lock_guard lock(tablesMutex_);
+    const auto self = std::this_thread::get_id();
+    const auto it = std::find_if(tables_.begin(), tables_.end(), [self](const auto& table) { return table->owner == self; });
+    ThreadTable* table = nullptr;
+    if (it != tables_.end()) {
+        table = it->get();
+    } else {
+        table = tables_.emplace_back(std::make_unique<ThreadTable>()).get();
+        table->owner = self;
+    }
+    cache = {id_, table};
+    return *table;
+}
+
+void AssetTelemetry::Record(const AssetLoadSample& sample) {
+    ThreadTable& table = LocalTable();
+    TypeSlot* slot = table.Find(sample.typeInfoKtid, sample.handler);
+    if (slot == nullptr) {
+        table.untracked.Add(sample);
+        return;
+    }
+    (sample.isOverride ? slot->overrides : slot->vanilla).Add(sample);
+}
+
+AssetTelemetrySnapshot AssetTelemetry::Snapshot() const {
+    AssetTelemetrySnapshot snapshot;
+    std::unordered_map<std::uint32_t, std::size_t> typeIndex;
+    std::lock_guard lock(tablesMutex_);
+    snapshot.threadCount = tables_.size();
+    for (const auto& table : tables_) {
+        for (const TypeSlot& slot : table->slots) {
+            if (!slot.used.load(std::memory_order_acquire)) {
+                continue;
+            }
+            const std::uint32_t typeInfoKtid = slot.typeInfoKtid.load(std::memory_order_relaxed);
+            const auto [it, inserted] = typeIndex.try_emplace(typeInfoKtid, snapshot.types.size());
+            if (inserted) {
+                AssetTypeTelemetry& type = snapshot.types.emplace_back();
+                type.typeInfoKtid = typeInfoKtid;
+                type.handler = slot.handler.load(std::memory_order_relaxed);
+            }
+            AssetTypeTelemetry& type = snapshot.types[it->second];
+            slot.vanilla.AddTo(type.vanilla);
+            slot.overrides.AddTo(type.overrides);
+        }
+        table->untracked.AddTo(snapshot.untracked);
+    }
+    std::sort(snapshot.types.begin(), snapshot.types.end(),
+              [](const AssetTypeTelemetry& lhs, const AssetTypeTelemetry& rhs) { return lhs.typeInfoKtid < rhs.typeInfoKtid; });
+    return snapshot;
+}
+
+std::string AssetTelemetry::ToJson(const AssetTelemetrySnapshot& snapshot, const TypeNameResolver& resolver) {
+    std::string out;
+    out.reserve(256 + snapshot.types.size() * 512);
+    out.append("{\"uptimeMs\":");
+    AppendDec(out, static_cast<std::uint64_t>(
+                       std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - created_).count()));
+    out.append(",\"threads\":");
+    AppendDec(out, snapshot.threadCount);
+    out.append(",\"types\":[");
+
+    std::lock_guard lock(namesMutex_);
+    for (std::size_t i = 0; i < snapshot.types.size(); ++i) {
+        const AssetTypeTelemetry& type = snapshot.types[i];
+        out.append(i == 0 ? "\n" : ",\n");
+        char ktid[16];
+        std::snprintf(ktid, sizeof(ktid), "0x%08X", type.typeInfoKtid);
+        out.append("{\"typeInfoKtid\":\"").append(ktid).append("\"");
+        if (resolver && type.handler != nullptr) {
+            // Handlers of one type share a vtable, so each name is asked for once per process.
+            const void* vtable = *static_cast<const void* const*>(type.handler);
+            auto it = typeNames_.find(vtable);
+            if (it == typeNames_.end()) {
+                it = typeNames_.emplace(vtable, resolver(type.handler)).first;
+            }
+            out.append(",\"typeName\":");
+            AppendJsonString(out, it->second);
+        }
+        out.append(",\"vanilla\":");
+        AppendStatsJson(out, type.vanilla);
+        out.append(",\"override\":");
+        AppendStatsJson(out, type.overrides);
+        out.push_back('}');
+    }
+    out.append("],\n\"untracked\":");
+    AppendStatsJson(out, snapshot.untracked);
+    out.append("}\n");
+    return out;
+}
+
+bool AssetTelemetry::WriteJson(const fs::path& path, const TypeNameResolver& resolver, std::string* error) {
+    const std::string json = ToJson(Snapshot(), resolver);
+    // Write beside the target and swap it in, so a reader never sees half a file.
+    fs::path tempPath = path;
+    tempPath += ".tmp";
+    try {
+        if (!path.parent_path().empty()) {
+            fs::create_directories(path.parent_path());
+        }
+        {
+            binary_io::file_ostream out(tempPath, binary_io::write_mode::truncate);
+            out.write_bytes(std::as_bytes(std::span(json.data(), json.size())));
+            out.flush();
+        }
+        fs::rename(tempPath, path);
+    } catch (const std::exception& ex) {
+        std::error_code ec;
+        fs::remove(tempPath, ec);
+        SetError(error, std::string("Failed to write asset telemetry: ") + ex.what());
+        return false;
+    }
+    return true;
+}
+
+bool AssetTelemetry::StartDumping(const fs::path& path, std::chrono::seconds interval, TypeNameResolver resolver,
+                                  std::string* error) {
+    StopDumping();
+    if (path.empty()) {
+        SetError(error, "Asset telemetry path is empty.");
+        return false;
+    }
+    auto dumper = std::make_unique<Dumper>();
+    dumper->path = path;
+    dumper->resolver = std::move(resolver);
+    Dumper& state = *dumper;
+    dumper_ = std::move(dumper);
+    SetEnabled(true);
+    if (interval.count() > 0) {
+        state.thread = std::thread([this, &state, interval]() {
+            std::unique_lock lock(state.mutex);
+            while (!state.wake.wait_for(lock, interval, [&state]() { return state.stopping; })) {
+                lock.unlock();
+                WriteJson(state.path, state.resolver);
+                lock.lock();
+            }
+        });
+    }
+    return true;
+}
+
+void AssetTelemetry::StopDumping() {
+    if (!dumper_) {
+        return;
+    }
+    {
+        std::lock_guard lock(dumper_->mutex);
+        dumper_->stopping = true;
+    }
+    dumper_->wake.notify_all();
+    if (dumper_->thread.joinable()) {
+        dumper_->thread.join();
+    }
+    WriteJson(dumper_->path, dumper_->resolver);
+    dumper_.reset();
+}
+
+}  // namespace LooseFileLoader
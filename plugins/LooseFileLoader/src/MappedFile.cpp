@@ -0,0 +1,151 @@
+#include "MappedFile.h"
+
+#include <string_view>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace LooseFileLoader {
+namespace {
+
+void SetError(std::string* error, std::string_view message) {
+    if (error != nullptr) {
+        *error = std::string(message);
+    }
+}
+
+}  // namespace
+
+std::optional<MappedFile> MappedFile::Open(const fs::path& path, std::string* error) {
+    MappedFile file;
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        SetError(error, "Failed to open file for mapping: " + path.string());
+        return std::nullopt;
+    }
+    file.fileHandle_ = fileHandle;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(fileHandle, &size)) {
+        SetError(error, "Failed to query mapped file size: " + path.string());
+        return std::nullopt;
+    }
+    file.size_ = static_cast<std::size_t>(size.QuadPart);
+    if (file.size_ == 0) {
+        return file;
+    }
+
+    HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        SetError(error, "Failed to create file mapping: " + path.string());
+        return std::nullopt;
+    }
+    file.mappingHandle_ = mappingHandle;
+
+    const void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        SetError(error, "Failed to map file view: " + path.string());
+        return std::nullopt;
+    }
+    file.data_ = static_cast<const std::byte*>(view);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        SetError(error, "Failed to open file for mapping: " + path.string());
+        return std::nullopt;
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        SetError(error, "Failed to query mapped file size: " + path.string());
+        return std::nullopt;
+    }
+    file.size_ = static_cast<std::size_t>(st.st_size);
+    if (file.size_ == 0) {
+        ::close(fd);
+        return file;
+    }
+
+    void* view = ::mmap(nullptr, file.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        file.size_ = 0;
+        SetError(error, "Failed to map file view: " + path.string());
+        return std::nullopt;
+    }
+    file.data_ = static_cast<const std::byte*>(view);
+#endif
+    return file;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0))
+#ifdef _WIN32
+      ,
+      fileHandle_(std::exchange(other.fileHandle_, nullptr)),
+      mappingHandle_(std::exchange(other.mappingHandle_, nullptr))
+#endif
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+        fileHandle_ = std::exchange(other.fileHandle_, nullptr);
+        mappingHandle_ = std::exchange(other.mappingHandle_, nullptr);
+#endif
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+std::span<const std::byte> MappedFile::Bytes() const {
+    if (data_ == nullptr) {
+        return {};
+    }
+    return {data_, size_};
+}
+
+void MappedFile::Close() {
+#ifdef _WIN32
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mappingHandle_ != nullptr) {
+        CloseHandle(mappingHandle_);
+    }
+    if (fileHandle_ != nullptr) {
+        CloseHandle(fileHandle_);
+    }
+    mappingHandle_ = nullptr;
+    fileHandle_ = nullptr;
+#else
+    if (data_ != nullptr) {
+        ::munmap(const_cast<std::byte*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,108 @@
+#include "ModAccessProfile.h"
+
+#include "MappedFile.h"
+
+#include "binary_io/binary_io.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace LooseFileLoader {
+namespace {
+
+constexpr std::array<char, 4> kAccessProfileMagic{'L', 'F', 'A', 'P'};
+constexpr std::uint32_t kAccessProfileVersion = 1;
+
+void SetError(std::string* error, std::string_view message) {
+    if (error != nullptr) {
+        *error = std::string(message);
+    }
+}
+
+}  // namespace
+
+ModAccessProfile::ModAccessProfile(std::vector<std::uint32_t> order) {
+    order_.reserve(std::min(order.size(), kMaxEntries));
+    positions_.reserve(order_.capacity());
+    for (const std::uint32_t fileKtid : order) {
+        if (order_.size() == kMaxEntries) {
+            break;
+        }
+        if (positions_.try_emplace(fileKtid, static_cast<std::uint32_t>(order_.size())).second) {
+            order_.push_back(fileKtid);
+        }
+    }
+}
+
+std::optional<ModAccessProfile> ModAccessProfile::Load(const fs::path& path, std::string* error) {
+    auto mapping = MappedFile::Open(path, error);
+    if (!mapping.has_value()) {
+        return std::nullopt;
+    }
+    const auto bytes = mapping->Bytes();
+    if (bytes.size() < sizeof(ModAccessProfileHeader)) {
+        SetError(error, "Mod access profile is too small.");
+        return std::nullopt;
+    }
+    ModAccessProfileHeader header{};
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, kAccessProfileMagic.data(), kAccessProfileMagic.size()) != 0 ||
+        header.version != kAccessProfileVersion) {
+        SetError(error, "Unsupported mod access profile format.");
+        return std::nullopt;
+    }
+    if (sizeof(header) + std::uint64_t{header.entryCount} * sizeof(std::uint32_t) != bytes.size()) {
+        SetError(error, "Mod access profile size mismatch.");
+        return std::nullopt;
+    }
+
+    std::vector<std::uint32_t> order(header.entryCount);
+    std::memcpy(order.data(), bytes.data() + sizeof(header), order.size() * sizeof(std::uint32_t));
+    return ModAccessProfile(std::move(order));
+}
+
+bool ModAccessProfile::Save(const fs::path& path, std::string* error) const {
+    ModAccessProfileHeader header{};
+    header.entryCount = static_cast<std::uint32_t>(order_.size());
+
+    // Write beside the target and swap it in, like ModOverrideCache.
+    fs::path tempPath = path;
+    tempPath += ".tmp";
+    try {
+        if (!path.parent_path().empty()) {
+            fs::create_directories(path.parent_path());
+        }
+        {
+            binary_io::file_ostream out(tempPath, binary_io::write_mode::truncate);
+            out.write_bytes(std::as_bytes(std::span(&header, 1)));
+            out.write_bytes(std::as_bytes(std::span(order_)));
+            out.flush();
+        }
+        fs::rename(tempPath, path);
+    } catch (const std::exception& ex) {
+        std::error_code ec;
+        fs::remove(tempPath, ec);
+        SetError(error, std::string("Failed to write mod access profile: ") + ex.what());
+        return false;
+    }
+    return true;
+}
+
+ModAccessProfile ModAccessProfile::Merge(std::span<const std::uint32_t> session, const ModAccessProfile& previous) {
+    std::vector<std::uint32_t> order(session.begin(), session.end());
+    order.insert(order.end(), previous.order_.begin(), previous.order_.end());
+    // The constructor keeps the first occurrence, i.e. this session's position.
+    return ModAccessProfile(std::move(order));
+}
+
+std::size_t ModAccessProfile::Position(std::uint32_t fileKtid) const {
+    const auto it = positions_.find(fileKtid);
+    return it != positions_.end() ? it->second : kNotFound;
+}
+
+}  // namespace LooseFileLoader
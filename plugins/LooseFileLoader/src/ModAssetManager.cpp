@@ -1,15 +1,23 @@
-#define NOMINMAX
 #include "ModAssetManager.h"
-
-#include <Windows.h>
+#include "ModDirectoryWatcher.h"
+#include "ModOverrideCache.h"
+#include "NameHash.h"
+#include "ParallelUtils.h"
+#include "SortKey.h"
 
 #include <LogUtils.h>
 
 #include <algorithm>
-#include <cwctype>
-#include <limits>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <system_error>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -19,183 +27,573 @@ namespace LooseFileLoader {
 namespace {
 
 struct ModAssetCandidate {
-    std::uint32_t fileHash = 0;
-    fs::path filePath{};
-    bool fromModsRoot = false;
-    std::wstring parentSortKey{};
-    std::wstring fileSortKey{};
+    ModOverrideIndex::Record record{};
+    // Folded file name, built once when the candidate is created.
+    SortKey fileSortKey{};
 };
 
-int CompareWideOrdinal(const std::wstring& lhs, const std::wstring& rhs, bool ignoreCase) {
-    const int result = CompareStringOrdinal(lhs.c_str(), -1, rhs.c_str(), -1, ignoreCase ? TRUE : FALSE);
-    if (result == CSTR_LESS_THAN) {
-        return -1;
-    }
-    if (result == CSTR_GREATER_THAN) {
-        return 1;
-    }
-    if (result == CSTR_EQUAL) {
-        return 0;
-    }
+struct ModFileEntry {
+    fs::path path{};
+    std::uint64_t fileSize = 0;
+    bool sizeKnown = false;
+};
 
-    if (lhs < rhs) {
-        return -1;
-    }
-    if (lhs > rhs) {
-        return 1;
+// mods/ itself (slot 0) or one first-level mod folder. Each slot is filled by one worker, so the
+// scan needs no locking and the merge order only depends on the slot order.
+struct ModFolderScan {
+    fs::path dir{};
+    // Folder name as listed, and folded.
+    fs::path::string_type name{};
+    SortKey sortKey{};
+    ModFolderFingerprint fingerprint{};
+    // Folder index in the on-disk cache, if it has one.
+    std::optional<std::size_t> cacheSlot{};
+    bool listed = false;
+    bool reused = false;
+    // Touched by the change a reload is applying.
+    bool dirty = false;
+    std::vector<ModFileEntry> files{};
+    std::vector<ModAssetCandidate> candidates{};
+};
+
+using Clock = std::chrono::steady_clock;
+
+void SetError(std::string* error, std::string_view message) {
+    if (error != nullptr) {
+        *error = std::string(message);
     }
-    return 0;
 }
 
-bool LessWideNoCaseStable(const std::wstring& lhs, const std::wstring& rhs) {
-    const int ci = CompareWideOrdinal(lhs, rhs, true);
-    if (ci != 0) {
-        return ci < 0;
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+using PathChar = fs::path::value_type;
+
+int HexDigitValue(PathChar ch) {
+    if (ch >= '0' && ch <= '9') {
+        return ch - '0';
     }
-    return CompareWideOrdinal(lhs, rhs, false) < 0;
+    if (ch >= 'a' && ch <= 'f') {
+        return ch - 'a' + 10;
+    }
+    if (ch >= 'A' && ch <= 'F') {
+        return ch - 'A' + 10;
+    }
+    return -1;
 }
 
+// Accepts "0x1234ABCD.ext" and "1234ABCD.ext"; the stem must be exactly the hex digits. A ".gz",
+// ".zlib" or ".delta" suffix is stripped first. Works on the native string, so no conversion and no locale
+// is involved.
 bool TryParseAssetHashFromFileName(const fs::path& path, std::uint32_t& outHash) {
-    std::wstring fileName = path.stem().wstring();
-    if (fileName.empty()) {
+    const fs::path stem = IsCompressedOverridePath(path) || IsDeltaOverridePath(path) ? path.stem().stem() : path.stem();
+    std::basic_string_view<PathChar> hexText = stem.native();
+    if (hexText.size() == 10 && hexText[0] == '0' && (hexText[1] == 'x' || hexText[1] == 'X')) {
+        hexText.remove_prefix(2);
+    } else if (hexText.size() != 8) {
         return false;
     }
 
-    std::wstring hexText;
-    if (fileName.size() == 10 && fileName[0] == L'0' && (fileName[1] == L'x' || fileName[1] == L'X')) {
-        hexText = fileName.substr(2);
-    } else if (fileName.size() == 8) {
-        hexText = fileName;
-    } else {
-        return false;
+    std::uint32_t value = 0;
+    for (const PathChar ch : hexText) {
+        const int digit = HexDigitValue(ch);
+        if (digit < 0) {
+            return false;
+        }
+        value = (value << 4) | static_cast<std::uint32_t>(digit);
     }
+    outHash = value;
+    return true;
+}
 
-    if (!std::all_of(hexText.begin(), hexText.end(), [](wchar_t ch) { return std::iswxdigit(ch) != 0; })) {
-        return false;
+// Case-insensitive by file name, then case-sensitive by path. Candidates only meet within one
+// folder or across folders whose names fold the same, so their folded paths are equal whenever
+// the folded names are, and the full case-insensitive path comparison this replaces reduces to
+// the name keys.
+bool LessCandidateInFolder(const ModAssetCandidate& lhs, const ModAssetCandidate& rhs) {
+    const int fileCmp = lhs.fileSortKey.compare(rhs.fileSortKey);
+    if (fileCmp != 0) {
+        return fileCmp < 0;
     }
+    return lhs.record.path.native() < rhs.record.path.native();
+}
 
-    try {
-        const auto value = std::stoull(hexText, nullptr, 16);
-        if (value > std::numeric_limits<std::uint32_t>::max()) {
-            return false;
-        }
-        outHash = static_cast<std::uint32_t>(value);
-        return true;
-    } catch (...) {
-        return false;
+bool LessFolder(const ModFolderScan& lhs, const ModFolderScan& rhs) {
+    const int folderNameCmp = lhs.sortKey.compare(rhs.sortKey);
+    if (folderNameCmp != 0) {
+        return folderNameCmp < 0;
     }
+    return lhs.name < rhs.name;
 }
 
-void CollectModAssetCandidates(const fs::path& dir, bool fromModsRoot, const std::wstring& parentSortKey,
-    std::vector<ModAssetCandidate>& outCandidates) {
+void SetFolderDir(ModFolderScan& folder, fs::path dir) {
+    const fs::path name = dir.filename();
+    folder.sortKey = MakePathSortKey(name);
+    folder.name = name.native();
+    folder.dir = std::move(dir);
+}
+
+// 0 when the time cannot be read; such a folder never matches the cache.
+std::int64_t LastWriteTime(const fs::path& dir) {
     std::error_code ec;
-    if (!fs::exists(dir, ec) || !fs::is_directory(dir, ec)) {
-        return;
-    }
+    const auto time = fs::last_write_time(dir, ec);
+    return ec ? 0 : static_cast<std::int64_t>(time.time_since_epoch().count());
+}
+
+// Lists the regular files of folder.dir, and its subdirectories into subdirs when given. The
+// timestamp is read first, so a change made while listing shows up on the next launch.
+void EnumerateModFolder(ModFolderScan& folder, std::vector<fs::path>* subdirs) {
+    folder.listed = true;
+    folder.fingerprint = {};
+    folder.fingerprint.lastWriteTime = LastWriteTime(folder.dir);
 
-    for (const auto& entry : fs::directory_iterator(dir, fs::directory_options::skip_permission_denied, ec)) {
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(folder.dir, fs::directory_options::skip_permission_denied, ec)) {
         if (ec) {
-            _MESSAGE("Failed to iterate directory: %s", dir.string().c_str());
             break;
         }
+        ++folder.fingerprint.entryCount;
+        folder.fingerprint.nameHash += HashName(ToCachePath(entry.path().filename()));
 
         std::error_code fileEc;
+        if (subdirs != nullptr && entry.is_directory(fileEc)) {
+            subdirs->push_back(entry.path());
+            continue;
+        }
         if (!entry.is_regular_file(fileEc)) {
             continue;
         }
+        ModFileEntry& file = folder.files.emplace_back();
+        file.path = entry.path();
+        // directory_entry caches the size from the enumeration on Windows, so this costs no stat.
+        file.fileSize = entry.file_size(fileEc);
+        file.sizeKnown = !fileEc;
+    }
+    if (ec) {
+        _MESSAGE("Failed to iterate directory: %s", folder.dir.string().c_str());
+    }
+}
 
+void ParseModFolder(ModFolderScan& folder) {
+    for (auto& file : folder.files) {
         std::uint32_t fileHash = 0;
-        if (!TryParseAssetHashFromFileName(entry.path(), fileHash)) {
+        if (!TryParseAssetHashFromFileName(file.path, fileHash)) {
             continue;
         }
+        ModAssetCandidate& candidate = folder.candidates.emplace_back();
+        candidate.fileSortKey = MakePathSortKey(file.path.filename());
+        candidate.record.fileKtid = fileHash;
+        candidate.record.path = std::move(file.path);
+        candidate.record.fileSize = file.fileSize;
+        candidate.record.valid = file.sizeKnown;
+    }
+    folder.files = {};
+}
+
+std::optional<ModOverrideCache> OpenCache(const fs::path& cachePath, const fs::path& modsDir) {
+    std::error_code ec;
+    if (cachePath.empty() || !fs::exists(cachePath, ec)) {
+        return std::nullopt;
+    }
+    std::string error;
+    auto cache = ModOverrideCache::Open(cachePath, &error);
+    if (!cache.has_value()) {
+        _MESSAGE("Ignoring mod override cache: %s", error.c_str());
+        return std::nullopt;
+    }
+    if (cache->FolderCount() == 0 || cache->ModsDir() != ToCachePath(modsDir)) {
+        _MESSAGE("Ignoring mod override cache for another mods directory: %s", cachePath.string().c_str());
+        return std::nullopt;
+    }
+    return cache;
+}
+
+void PreloadOverrides(ModOverrideIndex& index, std::uint64_t budgetBytes, std::uint64_t maxFileBytes) {
+    if (budgetBytes == 0) {
+        return;
+    }
+    const auto start = Clock::now();
+    const ModPreloadStats stats = index.Preload(budgetBytes, maxFileBytes);
+    _MESSAGE("Mod override preload: files=%zu, bytes=%llu, failed=%zu, streaming=%zu | %.2fms",
+        stats.fileCount, static_cast<unsigned long long>(stats.bytes), stats.failedCount,
+        index.Size() - stats.fileCount, ElapsedMs(start));
+}
+
+void LogConflicts(const std::vector<ModOverrideConflict>& conflicts) {
+    for (const auto& conflict : conflicts) {
+        _MESSAGE("Mod override conflict for 0x%08X: keep=%s, skip=%s",
+            conflict.fileKtid, conflict.kept.string().c_str(), conflict.skipped.string().c_str());
+    }
+}
 
-        ModAssetCandidate candidate{};
-        candidate.fileHash = fileHash;
-        candidate.filePath = entry.path();
-        candidate.fromModsRoot = fromModsRoot;
-        candidate.parentSortKey = parentSortKey;
-        candidate.fileSortKey = entry.path().filename().wstring();
-        outCandidates.emplace_back(std::move(candidate));
+// Folder-local order, as stored in the cache.
+void LoadCachedCandidates(ModFolderScan& folder, const ModOverrideCache& cache) {
+    for (auto& record : cache.FolderCandidates(*folder.cacheSlot)) {
+        ModAssetCandidate& candidate = folder.candidates.emplace_back();
+        candidate.fileSortKey = MakePathSortKey(record.path.filename());
+        candidate.record = std::move(record);
+    }
+}
+
+void ResetFolder(ModFolderScan& folder) {
+    folder.listed = false;
+    folder.reused = false;
+    folder.files = {};
+    folder.candidates = {};
+}
+
+// Lists and parses a folder from scratch, leaving its candidates in folder-local order.
+void RescanFolder(ModFolderScan& folder, std::vector<fs::path>* subdirs) {
+    ResetFolder(folder);
+    EnumerateModFolder(folder, subdirs);
+    ParseModFolder(folder);
+    std::sort(folder.candidates.begin(), folder.candidates.end(), LessCandidateInFolder);
+}
+
+// Concatenates the sorted per-folder lists in folder order. Folders whose names only differ in
+// case share a precedence rank, so their lists are merged by file name instead. The folders keep
+// their lists, so a reload only has to redo the ones that changed.
+std::vector<ModOverrideIndex::Record> MergeFolders(const std::vector<ModFolderScan>& folders) {
+    std::size_t candidateCount = 0;
+    for (const auto& folder : folders) {
+        candidateCount += folder.candidates.size();
+    }
+    std::vector<const ModAssetCandidate*> order;
+    order.reserve(candidateCount);
+    const auto lessCandidate = [](const ModAssetCandidate* lhs, const ModAssetCandidate* rhs) {
+        return LessCandidateInFolder(*lhs, *rhs);
+    };
+    std::size_t rankBegin = 0;
+    for (std::size_t i = 0; i < folders.size(); ++i) {
+        const bool sameRank = i > 1 && folders[i - 1].sortKey == folders[i].sortKey;
+        const std::size_t middle = order.size();
+        if (!sameRank) {
+            rankBegin = middle;
+        }
+        for (const auto& candidate : folders[i].candidates) {
+            order.push_back(&candidate);
+        }
+        if (sameRank) {
+            std::inplace_merge(order.begin() + static_cast<std::ptrdiff_t>(rankBegin),
+                               order.begin() + static_cast<std::ptrdiff_t>(middle), order.end(), lessCandidate);
+        }
+    }
+
+    std::vector<ModOverrideIndex::Record> records;
+    records.reserve(order.size());
+    for (const ModAssetCandidate* candidate : order) {
+        records.push_back(candidate->record);
+    }
+    return records;
+}
+
+// The previous cache mapping has to be closed first: it cannot be replaced on Windows while mapped.
+void SaveCache(const fs::path& cachePath, const fs::path& modsDir, const std::vector<ModFolderScan>& folders,
+               const ModOverrideIndex& index, const std::vector<ModOverrideConflict>& conflicts) {
+    std::vector<ModCacheFolder> cacheFolders;
+    cacheFolders.reserve(folders.size());
+    for (const auto& folder : folders) {
+        ModCacheFolder& cacheFolder = cacheFolders.emplace_back();
+        cacheFolder.dir = folder.dir;
+        cacheFolder.fingerprint = folder.fingerprint;
+        cacheFolder.candidates.reserve(folder.candidates.size());
+        for (const auto& candidate : folder.candidates) {
+            cacheFolder.candidates.push_back(candidate.record);
+        }
+    }
+    std::string error;
+    if (!ModOverrideCache::Save(cachePath, modsDir, cacheFolders, index.Overrides(), conflicts, &error)) {
+        _MESSAGE("%s", error.c_str());
     }
 }
 
 }  // namespace
 
-void ModAssetManager::Build(const fs::path& gameRootDir) {
-    overrides_.clear();
+struct ModAssetManager::State {
+    // Serializes Build and reloads; readers never take it.
+    std::mutex mutex;
+    fs::path modsDir{};
+    fs::path cachePath{};
+    // mods/ first, then the mod folders in precedence order, each with its sorted candidates.
+    std::vector<ModFolderScan> folders{};
+    // Only still open after a Build that restored everything from it: the reused folders'
+    // candidates are read from it on the first reload.
+    std::optional<ModOverrideCache> cache{};
+    std::uint64_t preloadBudget = 0;
+    std::uint64_t preloadMaxFileBytes = 0;
+    ModDirectoryWatcher watcher{};
+};
+
+ModAssetManager::ModAssetManager()
+    : index_(std::make_unique<ModOverrideIndex>()), state_(std::make_unique<State>()) {}
+
+ModAssetManager::~ModAssetManager() {
+    StopWatching();
+}
+
+void ModAssetManager::Build(const fs::path& gameRootDir, const fs::path& cachePath) {
+    std::lock_guard lock(state_->mutex);
+    auto& folders = state_->folders;
+    auto& cache = state_->cache;
+    folders.clear();
+    cache.reset();
 
     const fs::path modsDir = gameRootDir / "mods";
+    state_->modsDir = modsDir;
+    state_->cachePath = cachePath;
     std::error_code ec;
     if (!fs::exists(modsDir, ec) || !fs::is_directory(modsDir, ec)) {
         _MESSAGE("Mods directory not found: %s", modsDir.string().c_str());
+        index_.Publish(std::make_unique<ModOverrideIndex>());
         return;
     }
 
-    std::vector<ModAssetCandidate> candidates;
-    CollectModAssetCandidates(modsDir, true, L"", candidates);
+    // Enumerate: loose files in mods/ come first; folders follow in case-insensitive name order.
+    // When mods/ itself is unchanged since the cache was written, the folder list comes from the
+    // cache; every folder whose timestamp still matches is reused without being listed.
+    auto phaseStart = Clock::now();
+    cache = OpenCache(cachePath, modsDir);
+    folders.resize(1);
+    folders[0].dir = modsDir;
+    folders[0].cacheSlot = cache.has_value() ? std::optional<std::size_t>(0) : std::nullopt;
+    const std::int64_t rootTime = LastWriteTime(modsDir);
+    if (cache.has_value() && rootTime != 0 && cache->FolderFingerprint(0).lastWriteTime == rootTime) {
+        for (std::size_t slot = 1; slot < cache->FolderCount(); ++slot) {
+            ModFolderScan& folder = folders.emplace_back();
+            SetFolderDir(folder, FromCachePath(cache->FolderPath(slot)));
+            folder.cacheSlot = slot;
+        }
+    } else {
+        std::vector<fs::path> subdirs;
+        EnumerateModFolder(folders[0], &subdirs);
 
-    std::vector<std::pair<std::wstring, fs::path>> firstLevelModDirs;
-    for (const auto& entry : fs::directory_iterator(modsDir, fs::directory_options::skip_permission_denied, ec)) {
-        if (ec) {
-            _MESSAGE("Failed to iterate mods root: %s", modsDir.string().c_str());
-            break;
+        std::unordered_map<std::string, std::size_t> cacheSlots;
+        for (std::size_t slot = 1; cache.has_value() && slot < cache->FolderCount(); ++slot) {
+            cacheSlots.emplace(cache->FolderPath(slot), slot);
+        }
+        for (auto& subdir : subdirs) {
+            ModFolderScan& folder = folders.emplace_back();
+            if (const auto it = cacheSlots.find(ToCachePath(subdir)); it != cacheSlots.end()) {
+                folder.cacheSlot = it->second;
+            }
+            SetFolderDir(folder, std::move(subdir));
         }
+        std::sort(folders.begin() + 1, folders.end(), LessFolder);
+    }
 
-        std::error_code dirEc;
-        if (!entry.is_directory(dirEc)) {
-            continue;
+    const std::size_t threadCount = ResolveThreadCount(0, folders.size());
+    ParallelFor(folders.size(), threadCount, [&folders, &cache](std::size_t index) {
+        ModFolderScan& folder = folders[index];
+        if (folder.listed) {
+            return;
+        }
+        if (folder.cacheSlot.has_value()) {
+            const ModFolderFingerprint cached = cache->FolderFingerprint(*folder.cacheSlot);
+            const std::int64_t time = LastWriteTime(folder.dir);
+            if (time != 0 && time == cached.lastWriteTime) {
+                folder.fingerprint = cached;
+                folder.reused = true;
+                return;
+            }
         }
+        EnumerateModFolder(folder, nullptr);
+    });
+    const double enumerateMs = ElapsedMs(phaseStart);
+
+    std::size_t fileCount = 0;
+    std::size_t reusedCount = 0;
+    std::size_t touchedCount = 0;
+    for (const auto& folder : folders) {
+        fileCount += folder.files.size();
+        reusedCount += folder.reused ? 1 : 0;
+        // Rescanned, but the same names as last time: only the timestamp moved.
+        if (!folder.reused && folder.cacheSlot.has_value()) {
+            const ModFolderFingerprint cached = cache->FolderFingerprint(*folder.cacheSlot);
+            touchedCount += (cached.entryCount == folder.fingerprint.entryCount &&
+                             cached.nameHash == folder.fingerprint.nameHash) ? 1 : 0;
+        }
+    }
 
-        firstLevelModDirs.emplace_back(entry.path().filename().wstring(), entry.path());
+    std::vector<ModOverrideConflict> conflicts;
+    if (cache.has_value() && reusedCount == folders.size()) {
+        // Nothing changed: take the resolved index straight from the cache. The mapping stays
+        // open; the per-folder candidates are only decoded if a reload ever needs them.
+        phaseStart = Clock::now();
+        auto index = std::make_unique<ModOverrideIndex>(ModOverrideIndex::Build(cache->Winners()));
+        PreloadOverrides(*index, state_->preloadBudget, state_->preloadMaxFileBytes);
+        conflicts = cache->Conflicts();
+        LogConflicts(conflicts);
+        _MESSAGE("Mod override index loaded from cache. unique=%zu, conflicts=%zu, bytes=%zu",
+            index->Size(), conflicts.size(), index->MemoryBytes());
+        index_.Publish(std::move(index));
+        _MESSAGE("Mod override scan: folders=%zu, reused=%zu | enumerate=%.2fms, load=%.2fms",
+            folders.size() - 1, reusedCount, enumerateMs, ElapsedMs(phaseStart));
+        return;
     }
 
-    std::sort(firstLevelModDirs.begin(), firstLevelModDirs.end(), [](const auto& lhs, const auto& rhs) {
-        const int folderNameCmp = CompareWideOrdinal(lhs.first, rhs.first, true);
-        if (folderNameCmp != 0) {
-            return folderNameCmp < 0;
+    phaseStart = Clock::now();
+    ParallelFor(folders.size(), threadCount, [&folders, &cache](std::size_t index) {
+        ModFolderScan& folder = folders[index];
+        if (folder.reused) {
+            LoadCachedCandidates(folder, *cache);
+        } else {
+            ParseModFolder(folder);
         }
-        return LessWideNoCaseStable(lhs.second.filename().wstring(), rhs.second.filename().wstring());
     });
+    const double parseMs = ElapsedMs(phaseStart);
+
+    // Sort: every folder on its own (cached folders are stored sorted), then merge in folder order.
+    phaseStart = Clock::now();
+    ParallelFor(folders.size(), threadCount, [&folders](std::size_t index) {
+        auto& candidates = folders[index].candidates;
+        if (!folders[index].reused) {
+            std::sort(candidates.begin(), candidates.end(), LessCandidateInFolder);
+        }
+    });
+    std::vector<ModOverrideIndex::Record> records = MergeFolders(folders);
+    const std::size_t candidateCount = records.size();
+    const double sortMs = ElapsedMs(phaseStart);
+
+    // Dedupe: the first candidate per fileKtid wins.
+    phaseStart = Clock::now();
+    auto index = std::make_unique<ModOverrideIndex>(ModOverrideIndex::Build(std::move(records), &conflicts));
+    const double dedupeMs = ElapsedMs(phaseStart);
+    LogConflicts(conflicts);
+
+    _MESSAGE("Mod override index built. candidates=%zu, unique=%zu, conflicts=%zu, bytes=%zu",
+        candidateCount, index->Size(), conflicts.size(), index->MemoryBytes());
+    _MESSAGE("Mod override scan: folders=%zu, files=%zu, threads=%zu, reused=%zu, rescanned=%zu (timestamp only=%zu) | enumerate=%.2fms, parse=%.2fms, sort=%.2fms, dedupe=%.2fms",
+        folders.size() - 1, fileCount, threadCount, reusedCount, folders.size() - reusedCount, touchedCount,
+        enumerateMs, parseMs, sortMs, dedupeMs);
+    PreloadOverrides(*index, state_->preloadBudget, state_->preloadMaxFileBytes);
+
+    // Only the writer replaces the snapshot, so it stays valid here after being published.
+    const ModOverrideIndex& published = *index;
+    index_.Publish(std::move(index));
+    if (!cachePath.empty()) {
+        cache.reset();
+        SaveCache(cachePath, modsDir, folders, published, conflicts);
+    }
+}
+
+void ModAssetManager::SetPreloadBudget(std::uint64_t budgetBytes, std::uint64_t maxFileBytes) {
+    std::lock_guard lock(state_->mutex);
+    state_->preloadBudget = budgetBytes;
+    state_->preloadMaxFileBytes = maxFileBytes;
+}
+
+RcuCell<ModOverrideIndex>::ReadGuard ModAssetManager::Acquire() const {
+    return index_.Read();
+}
 
-    for (const auto& [folderSortKey, folderPath] : firstLevelModDirs) {
-        CollectModAssetCandidates(folderPath, false, folderSortKey, candidates);
+bool ModAssetManager::StartWatching(std::string* error) {
+    // Read the folder state under the mutex, but start the watcher outside it: its callback takes
+    // the mutex in ApplyChanges.
+    fs::path modsDir;
+    bool loaded = false;
+    {
+        std::lock_guard lock(state_->mutex);
+        modsDir = state_->modsDir;
+        loaded = !state_->folders.empty();
+    }
+    if (!loaded) {
+        SetError(error, "Mods directory was not loaded: " + modsDir.string());
+        return false;
+    }
+    const bool started = state_->watcher.Start(modsDir, [this](ModDirectoryWatcher::Batch batch) {
+        ApplyChanges(batch.paths, batch.overflow);
+    }, error);
+    if (started) {
+        _MESSAGE("Watching for mod changes: %s", modsDir.string().c_str());
     }
+    return started;
+}
 
-    std::sort(candidates.begin(), candidates.end(), [](const ModAssetCandidate& lhs, const ModAssetCandidate& rhs) {
-        if (lhs.fromModsRoot != rhs.fromModsRoot) {
-            return lhs.fromModsRoot && !rhs.fromModsRoot;
-        }
-        if (!lhs.fromModsRoot) {
-            const int parentCmp = CompareWideOrdinal(lhs.parentSortKey, rhs.parentSortKey, true);
-            if (parentCmp != 0) {
-                return parentCmp < 0;
+void ModAssetManager::StopWatching() {
+    // Not under the mutex: the watcher thread may be waiting for it inside ApplyChanges.
+    state_->watcher.Stop();
+}
+
+void ModAssetManager::ApplyChanges(std::span<const fs::path> paths, bool overflow) {
+    std::lock_guard lock(state_->mutex);
+    auto& folders = state_->folders;
+    auto& cache = state_->cache;
+    if (folders.empty()) {
+        return;
+    }
+    const auto start = Clock::now();
+
+    if (cache.has_value()) {
+        for (auto& folder : folders) {
+            if (folder.reused) {
+                LoadCachedCandidates(folder, *cache);
             }
         }
-        const int fileCmp = CompareWideOrdinal(lhs.fileSortKey, rhs.fileSortKey, true);
-        if (fileCmp != 0) {
-            return fileCmp < 0;
+    }
+
+    // The first component names the mod folder a change belongs to. A change directly in mods/
+    // may also be a folder appearing, vanishing or being renamed, so mods/ is listed again too.
+    bool rescanRoot = overflow;
+    std::unordered_set<fs::path::string_type> changedFolders;
+    for (const auto& path : paths) {
+        const auto first = path.begin();
+        if (first == path.end()) {
+            continue;
         }
-        return LessWideNoCaseStable(lhs.filePath.wstring(), rhs.filePath.wstring());
-    });
+        changedFolders.insert(first->native());
+        rescanRoot = rescanRoot || std::next(first) == path.end();
+    }
+    for (auto& folder : folders) {
+        folder.dirty = overflow || changedFolders.contains(folder.dir.filename().native());
+    }
+    folders[0].dirty = rescanRoot;
 
-    std::size_t conflictCount = 0;
-    for (const auto& candidate : candidates) {
-        const auto [it, inserted] = overrides_.emplace(candidate.fileHash, candidate.filePath);
-        if (!inserted) {
-            ++conflictCount;
-            _MESSAGE("Mod override conflict for 0x%08X: keep=%s, skip=%s",
-                candidate.fileHash, it->second.string().c_str(), candidate.filePath.string().c_str());
+    if (rescanRoot) {
+        std::vector<fs::path> subdirs;
+        RescanFolder(folders[0], &subdirs);
+
+        std::unordered_map<fs::path::string_type, ModFolderScan> known;
+        for (std::size_t i = 1; i < folders.size(); ++i) {
+            known.emplace(folders[i].dir.native(), std::move(folders[i]));
         }
+        folders.resize(1);
+        for (auto& subdir : subdirs) {
+            if (auto it = known.find(subdir.native()); it != known.end()) {
+                folders.push_back(std::move(it->second));
+                continue;
+            }
+            ModFolderScan& folder = folders.emplace_back();
+            SetFolderDir(folder, std::move(subdir));
+            folder.dirty = true;
+        }
+        std::sort(folders.begin() + 1, folders.end(), LessFolder);
     }
 
-    _MESSAGE("Mod override index built. candidates=%zu, unique=%zu, conflicts=%zu",
-        candidates.size(), overrides_.size(), conflictCount);
-}
+    const std::size_t threadCount = ResolveThreadCount(0, folders.size());
+    ParallelFor(folders.size(), threadCount, [&folders](std::size_t index) {
+        if (index != 0 && folders[index].dirty) {
+            RescanFolder(folders[index], nullptr);
+        }
+    });
+    std::size_t rescannedCount = 0;
+    for (const auto& folder : folders) {
+        rescannedCount += folder.dirty ? 1 : 0;
+    }
 
-std::optional<fs::path> ModAssetManager::Find(std::uint32_t fileHash) const {
-    const auto it = overrides_.find(fileHash);
-    return (it != overrides_.end()) ? std::optional<fs::path>(it->second) : std::nullopt;
+    std::vector<ModOverrideConflict> conflicts;
+    auto index = std::make_unique<ModOverrideIndex>(ModOverrideIndex::Build(MergeFolders(folders), &conflicts));
+    LogConflicts(conflicts);
+    PreloadOverrides(*index, state_->preloadBudget, state_->preloadMaxFileBytes);
+    const ModOverrideIndex& published = *index;
+    index_.Publish(std::move(index));
+    _MESSAGE("Mod overrides reloaded: folders=%zu, rescanned=%zu, unique=%zu, conflicts=%zu | %.2fms",
+        folders.size() - 1, rescannedCount, published.Size(), conflicts.size(), ElapsedMs(start));
+
+    if (!state_->cachePath.empty()) {
+        cache.reset();
+        SaveCache(state_->cachePath, state_->modsDir, folders, published, conflicts);
+    }
 }
 
 }  // namespace LooseFileLoader
-
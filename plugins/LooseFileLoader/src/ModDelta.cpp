@@ -0,0 +1,230 @@
+#include "ModDelta.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <utility>
+
+#include <zlib.h>
+
+namespace LooseFileLoader {
+namespace {
+
+constexpr std::array<char, 4> kDeltaMagic{'L', 'F', 'D', 'T'};
+constexpr std::uint32_t kDeltaVersion = 1;
+
+// Source blocks are indexed at this stride, and a copy must be at least this long to beat the
+// literal bytes it replaces.
+constexpr std::size_t kBlockBytes = 16;
+// Hash hits per target position checked for the longest match.
+constexpr std::size_t kMaxCandidates = 4;
+
+void SetError(std::string* error, std::string_view message) {
+    if (error != nullptr) {
+        *error = std::string(message);
+    }
+}
+
+std::uint32_t Crc32(std::span<const std::byte> bytes) {
+    uLong crc = crc32(0, nullptr, 0);
+    while (!bytes.empty()) {
+        const auto chunk = static_cast<uInt>(std::min<std::size_t>(bytes.size(), std::numeric_limits<uInt>::max()));
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(bytes.data()), chunk);
+        bytes = bytes.subspan(chunk);
+    }
+    return static_cast<std::uint32_t>(crc);
+}
+
+std::uint64_t BlockHash(const std::byte* block) {
+    std::uint64_t low = 0;
+    std::uint64_t high = 0;
+    std::memcpy(&low, block, sizeof(low));
+    std::memcpy(&high, block + sizeof(low), sizeof(high));
+    const std::uint64_t mixed = (low * 0x9E3779B97F4A7C15ull) ^ (high * 0xC2B2AE3D27D4EB4Full);
+    return mixed ^ (mixed >> 29);
+}
+
+std::size_t MatchLength(std::span<const std::byte> source, std::size_t sourceOffset, std::span<const std::byte> target,
+                        std::size_t targetOffset) {
+    const std::size_t limit = std::min(source.size() - sourceOffset, target.size() - targetOffset);
+    std::size_t length = 0;
+    while (length + sizeof(std::uint64_t) <= limit) {
+        std::uint64_t lhs = 0;
+        std::uint64_t rhs = 0;
+        std::memcpy(&lhs, source.data() + sourceOffset + length, sizeof(lhs));
+        std::memcpy(&rhs, target.data() + targetOffset + length, sizeof(rhs));
+        if (lhs != rhs) {
+            break;
+        }
+        length += sizeof(std::uint64_t);
+    }
+    while (length < limit && source[sourceOffset + length] == target[targetOffset + length]) {
+        ++length;
+    }
+    return length;
+}
+
+void AppendVarint(std::vector<std::byte>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::byte>(value));
+}
+
+bool ReadVarint(std::span<const std::byte> bytes, std::size_t& offset, std::uint64_t& outValue) {
+    std::uint64_t value = 0;
+    for (unsigned shift = 0; shift < 64 && offset < bytes.size(); shift += 7) {
+        const auto byte = static_cast<std::uint8_t>(bytes[offset++]);
+        value |= std::uint64_t{byte & 0x7Fu} << shift;
+        if ((byte & 0x80) == 0) {
+            outValue = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+void AppendAdd(std::vector<std::byte>& out, std::span<const std::byte> literal) {
+    if (!literal.empty()) {
+        AppendVarint(out, (std::uint64_t{literal.size()} << 1) | kModDeltaAdd);
+        out.insert(out.end(), literal.begin(), literal.end());
+    }
+}
+
+}  // namespace
+
+std::optional<ModDeltaHeader> ReadModDeltaHeader(std::span<const std::byte> delta, std::string* error) {
+    if (delta.size() < sizeof(ModDeltaHeader)) {
+        SetError(error, "Mod delta is too small.");
+        return std::nullopt;
+    }
+    ModDeltaHeader header{};
+    std::memcpy(&header, delta.data(), sizeof(header));
+    if (std::memcmp(header.magic, kDeltaMagic.data(), kDeltaMagic.size()) != 0 || header.version != kDeltaVersion) {
+        SetError(error, "Unsupported mod delta format.");
+        return std::nullopt;
+    }
+    return header;
+}
+
+std::vector<std::byte> EncodeModDelta(std::span<const std::byte> source, std::span<const std::byte> target) {
+    ModDeltaHeader header{};
+    header.sourceSize = source.size();
+    header.targetSize = target.size();
+    header.sourceCrc32 = Crc32(source);
+    header.targetCrc32 = Crc32(target);
+    std::vector<std::byte> out(sizeof(header));
+    std::memcpy(out.data(), &header, sizeof(header));
+
+    // (hash, offset) of every aligned source block, sorted so the blocks at or after the source
+    // cursor are one lower_bound away.
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> blocks;
+    blocks.reserve(source.size() / kBlockBytes);
+    for (std::size_t offset = 0; offset + kBlockBytes <= source.size(); offset += kBlockBytes) {
+        blocks.emplace_back(BlockHash(source.data() + offset), offset);
+    }
+    std::sort(blocks.begin(), blocks.end());
+
+    // Source bytes before sourceCursor are behind the stream; target bytes from literalStart wait
+    // for the next ADD.
+    std::size_t sourceCursor = 0;
+    std::size_t literalStart = 0;
+    std::size_t position = 0;
+    while (position + kBlockBytes <= target.size()) {
+        std::size_t bestOffset = 0;
+        std::size_t bestLength = 0;
+        const auto consider = [&](std::size_t sourceOffset) {
+            if (sourceOffset >= sourceCursor && sourceOffset < source.size()) {
+                const std::size_t length = MatchLength(source, sourceOffset, target, position);
+                if (length > bestLength) {
+                    bestOffset = sourceOffset;
+                    bestLength = length;
+                }
+            }
+        };
+        // Bytes patched in place (the source moves on with the literals), then an insertion (it
+        // does not), then anything the block hash finds further ahead.
+        consider(sourceCursor + (position - literalStart));
+        consider(sourceCursor);
+        const std::uint64_t hash = BlockHash(target.data() + position);
+        auto it = std::lower_bound(blocks.begin(), blocks.end(), std::pair{hash, std::uint64_t{sourceCursor}});
+        for (std::size_t checked = 0; checked < kMaxCandidates && it != blocks.end() && it->first == hash; ++checked, ++it) {
+            consider(static_cast<std::size_t>(it->second));
+        }
+        if (bestLength < kBlockBytes) {
+            ++position;
+            continue;
+        }
+
+        // Pull the copy back over pending literals that match too.
+        while (position > literalStart && bestOffset > sourceCursor && source[bestOffset - 1] == target[position - 1]) {
+            --position;
+            --bestOffset;
+            ++bestLength;
+        }
+        AppendAdd(out, target.subspan(literalStart, position - literalStart));
+        AppendVarint(out, (std::uint64_t{bestLength} << 1) | kModDeltaCopy);
+        AppendVarint(out, bestOffset - sourceCursor);
+        sourceCursor = bestOffset + bestLength;
+        position += bestLength;
+        literalStart = position;
+    }
+    AppendAdd(out, target.subspan(literalStart));
+    return out;
+}
+
+bool ApplyModDelta(std::span<const std::byte> source, std::span<const std::byte> delta,
+                   std::vector<std::byte>* outTarget, std::string* error) {
+    const auto header = ReadModDeltaHeader(delta, error);
+    if (!header.has_value()) {
+        return false;
+    }
+    if (header->sourceSize != source.size() || header->sourceCrc32 != Crc32(source)) {
+        SetError(error, "Mod delta was made for a different source.");
+        return false;
+    }
+
+    std::vector<std::byte> target;
+    target.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(header->targetSize, std::uint64_t{1} << 32)));
+    std::size_t offset = sizeof(ModDeltaHeader);
+    std::uint64_t sourceCursor = 0;
+    while (target.size() < header->targetSize) {
+        std::uint64_t op = 0;
+        if (!ReadVarint(delta, offset, op) || (op >> 1) == 0 || (op >> 1) > header->targetSize - target.size()) {
+            SetError(error, "Mod delta op is malformed.");
+            return false;
+        }
+        const std::uint64_t length = op >> 1;
+        if ((op & 1) == kModDeltaAdd) {
+            if (length > delta.size() - offset) {
+                SetError(error, "Mod delta literal exceeds the file.");
+                return false;
+            }
+            const auto literal = delta.subspan(offset, static_cast<std::size_t>(length));
+            target.insert(target.end(), literal.begin(), literal.end());
+            offset += static_cast<std::size_t>(length);
+        } else {
+            std::uint64_t skip = 0;
+            if (!ReadVarint(delta, offset, skip) || skip > source.size() - sourceCursor ||
+                length > source.size() - sourceCursor - skip) {
+                SetError(error, "Mod delta copy exceeds the source.");
+                return false;
+            }
+            sourceCursor += skip;
+            const auto copied = source.subspan(static_cast<std::size_t>(sourceCursor), static_cast<std::size_t>(length));
+            target.insert(target.end(), copied.begin(), copied.end());
+            sourceCursor += length;
+        }
+    }
+    if (offset != delta.size() || Crc32(target) != header->targetCrc32) {
+        SetError(error, "Mod delta output does not match its checksum.");
+        return false;
+    }
+    *outTarget = std::move(target);
+    return true;
+}
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,283 @@
+#include "ModDirectoryWatcher.h"
+
+#include <atomic>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <unordered_map>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace LooseFileLoader {
+namespace {
+
+void SetError(std::string* error, std::string_view message) {
+    if (error != nullptr) {
+        *error = std::string(message);
+    }
+}
+
+}  // namespace
+
+#ifdef _WIN32
+
+struct ModDirectoryWatcher::Impl {
+    HANDLE directory = INVALID_HANDLE_VALUE;
+    HANDLE stopEvent = nullptr;
+    std::thread thread{};
+
+    ~Impl() {
+        if (directory != INVALID_HANDLE_VALUE) {
+            CloseHandle(directory);
+        }
+        if (stopEvent != nullptr) {
+            CloseHandle(stopEvent);
+        }
+    }
+
+    void Run(Callback callback, std::chrono::milliseconds quietPeriod) {
+        constexpr DWORD kNotifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                                        FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+        // DWORD elements keep the FILE_NOTIFY_INFORMATION records aligned.
+        std::vector<DWORD> buffer(64 * 1024 / sizeof(DWORD));
+        OVERLAPPED overlapped{};
+        overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (overlapped.hEvent == nullptr) {
+            return;
+        }
+
+        Batch pending;
+        bool issued = false;
+        for (;;) {
+            if (!issued) {
+                ResetEvent(overlapped.hEvent);
+                issued = ReadDirectoryChangesW(directory, buffer.data(), static_cast<DWORD>(buffer.size() * sizeof(DWORD)),
+                                               TRUE, kNotifyFilter, nullptr, &overlapped, nullptr) != FALSE;
+                if (!issued) {
+                    break;
+                }
+            }
+
+            const bool hasPending = pending.overflow || !pending.paths.empty();
+            const HANDLE handles[2] = {stopEvent, overlapped.hEvent};
+            const DWORD wait = WaitForMultipleObjects(2, handles, FALSE,
+                                                      hasPending ? static_cast<DWORD>(quietPeriod.count()) : INFINITE);
+            if (wait == WAIT_OBJECT_0 + 1) {
+                DWORD bytes = 0;
+                issued = false;
+                if (!GetOverlappedResult(directory, &overlapped, &bytes, FALSE) || bytes == 0) {
+                    pending.overflow = true;
+                    continue;
+                }
+                const auto* cursor = reinterpret_cast<const std::byte*>(buffer.data());
+                for (;;) {
+                    const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(cursor);
+                    pending.paths.emplace_back(std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR)));
+                    if (info->NextEntryOffset == 0) {
+                        break;
+                    }
+                    cursor += info->NextEntryOffset;
+                }
+            } else if (wait == WAIT_TIMEOUT) {
+                callback(std::exchange(pending, Batch{}));
+            } else {
+                break;
+            }
+        }
+
+        if (issued) {
+            CancelIoEx(directory, &overlapped);
+            DWORD bytes = 0;
+            GetOverlappedResult(directory, &overlapped, &bytes, TRUE);
+        }
+        CloseHandle(overlapped.hEvent);
+    }
+};
+
+bool ModDirectoryWatcher::Start(const fs::path& root, Callback callback, std::string* error,
+                                std::chrono::milliseconds quietPeriod) {
+    Stop();
+    auto impl = std::make_unique<Impl>();
+    impl->directory = CreateFileW(root.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                  nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (impl->directory == INVALID_HANDLE_VALUE) {
+        SetError(error, "Failed to open directory for watching: " + root.string());
+        return false;
+    }
+    impl->stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (impl->stopEvent == nullptr) {
+        SetError(error, "Failed to create watcher stop event.");
+        return false;
+    }
+
+    Impl* raw = impl.get();
+    impl->thread = std::thread([raw, callback = std::move(callback), quietPeriod]() mutable {
+        raw->Run(std::move(callback), quietPeriod);
+    });
+    impl_ = std::move(impl);
+    return true;
+}
+
+void ModDirectoryWatcher::Stop() {
+    if (!impl_) {
+        return;
+    }
+    SetEvent(impl_->stopEvent);
+    if (impl_->thread.joinable()) {
+        impl_->thread.join();
+    }
+    impl_.reset();
+}
+
+#else
+
+struct ModDirectoryWatcher::Impl {
+    int inotifyFd = -1;
+    int stopFd = -1;
+    fs::path root{};
+    // Watch descriptor -> directory relative to root.
+    std::unordered_map<int, fs::path> watches{};
+    std::thread thread{};
+
+    ~Impl() {
+        if (inotifyFd >= 0) {
+            close(inotifyFd);
+        }
+        if (stopFd >= 0) {
+            close(stopFd);
+        }
+    }
+
+    // inotify is not recursive: every directory below root gets its own watch.
+    void AddWatchTree(const fs::path& relative) {
+        constexpr std::uint32_t kMask =
+            IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF;
+        const fs::path absolute = relative.empty() ? root : root / relative;
+        const int wd = inotify_add_watch(inotifyFd, absolute.c_str(), kMask);
+        if (wd < 0) {
+            return;
+        }
+        watches[wd] = relative;
+
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(absolute, fs::directory_options::skip_permission_denied, ec)) {
+            std::error_code entryEc;
+            if (entry.is_directory(entryEc) && !entry.is_symlink(entryEc)) {
+                AddWatchTree(relative / entry.path().filename());
+            }
+        }
+    }
+
+    void Run(Callback callback, std::chrono::milliseconds quietPeriod) {
+        alignas(inotify_event) char buffer[64 * 1024];
+        Batch pending;
+        for (;;) {
+            const bool hasPending = pending.overflow || !pending.paths.empty();
+            pollfd fds[2] = {{stopFd, POLLIN, 0}, {inotifyFd, POLLIN, 0}};
+            const int ready = poll(fds, 2, hasPending ? static_cast<int>(quietPeriod.count()) : -1);
+            if (ready < 0) {
+                continue;
+            }
+            if ((fds[0].revents & POLLIN) != 0) {
+                break;
+            }
+            if (ready == 0) {
+                callback(std::exchange(pending, Batch{}));
+                continue;
+            }
+
+            const ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+            for (ssize_t offset = 0; length > 0 && offset < length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                if ((event->mask & IN_Q_OVERFLOW) != 0) {
+                    pending.overflow = true;
+                    continue;
+                }
+                const auto it = watches.find(event->wd);
+                if (it == watches.end()) {
+                    continue;
+                }
+                if ((event->mask & IN_IGNORED) != 0) {
+                    watches.erase(it);
+                    continue;
+                }
+                if (event->len == 0) {
+                    if (!it->second.empty()) {
+                        pending.paths.push_back(it->second);
+                    }
+                    continue;
+                }
+                const fs::path relative = it->second / event->name;
+                pending.paths.push_back(relative);
+                if ((event->mask & IN_ISDIR) != 0 && (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+                    AddWatchTree(relative);
+                }
+            }
+        }
+    }
+};
+
+bool ModDirectoryWatcher::Start(const fs::path& root, Callback callback, std::string* error,
+                                std::chrono::milliseconds quietPeriod) {
+    Stop();
+    auto impl = std::make_unique<Impl>();
+    impl->root = root;
+    impl->inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    impl->stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (impl->inotifyFd < 0 || impl->stopFd < 0) {
+        SetError(error, "Failed to create inotify instance.");
+        return false;
+    }
+    impl->AddWatchTree({});
+    if (impl->watches.empty()) {
+        SetError(error, "Failed to watch directory: " + root.string());
+        return false;
+    }
+
+    Impl* raw = impl.get();
+    impl->thread = std::thread([raw, callback = std::move(callback), quietPeriod]() mutable {
+        raw->Run(std::move(callback), quietPeriod);
+    });
+    impl_ = std::move(impl);
+    return true;
+}
+
+void ModDirectoryWatcher::Stop() {
+    if (!impl_) {
+        return;
+    }
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written = write(impl_->stopFd, &one, sizeof(one));
+    if (impl_->thread.joinable()) {
+        impl_->thread.join();
+    }
+    impl_.reset();
+}
+
+#endif
+
+ModDirectoryWatcher::ModDirectoryWatcher() = default;
+
+ModDirectoryWatcher::~ModDirectoryWatcher() {
+    Stop();
+}
+
+bool ModDirectoryWatcher::IsRunning() const {
+    return impl_ != nullptr;
+}
+
+}  // namespace LooseFileLoader
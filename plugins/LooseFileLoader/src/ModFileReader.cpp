@@ -1,104 +1,776 @@
 #include "ModFileReader.h"
 
+#include "ModDelta.h"
+
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 #include <span>
-#include <utility>
 
-namespace fs = std::filesystem;
+#include <zlib.h>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace LooseFileLoader {
+namespace {
+
+// Output kept by the inflate and delta readers for short backward skips.
+constexpr std::size_t kOutputWindowBytes = 64 * 1024;
+constexpr std::size_t kInflateInputBytes = 64 * 1024;
+// inflateInit2: 15-bit window, gzip or zlib header detected automatically.
+constexpr int kInflateWindowBits = 15 + 32;
+
+// A ring of the last kOutputWindowBytes bytes a streaming reader produced: logical offset p lives
+// at bytes[p % kOutputWindowBytes] while it is within [Begin(), produced).
+struct OutputWindow {
+    std::uint64_t produced = 0;
+    std::size_t fill = 0;
+    std::unique_ptr<std::byte[]> bytes = std::make_unique_for_overwrite<std::byte[]>(kOutputWindowBytes);
+
+    [[nodiscard]] std::uint64_t Begin() const {
+        return produced - fill;
+    }
+
+    void Clear() {
+        produced = 0;
+        fill = 0;
+    }
+
+    // Marks size bytes just produced into src as produced and keeps their tail.
+    void Remember(const std::byte* src, std::size_t size) {
+        const std::size_t keep = std::min(size, kOutputWindowBytes);
+        std::uint64_t offset = produced + size - keep;
+        const std::byte* from = src + size - keep;
+        for (std::size_t left = keep; left != 0;) {
+            const auto slot = static_cast<std::size_t>(offset % kOutputWindowBytes);
+            const std::size_t count = std::min(left, kOutputWindowBytes - slot);
+            std::memcpy(bytes.get() + slot, from, count);
+            from += count;
+            offset += count;
+            left -= count;
+        }
+        Advance(size);
+    }
+
+    // Copies [offset, offset + size) out of the window; the range must lie within it.
+    void Recall(std::uint64_t offset, std::byte* dst, std::size_t size) const {
+        while (size != 0) {
+            const auto slot = static_cast<std::size_t>(offset % kOutputWindowBytes);
+            const std::size_t count = std::min(size, kOutputWindowBytes - slot);
+            std::memcpy(dst, bytes.get() + slot, count);
+            dst += count;
+            offset += count;
+            size -= count;
+        }
+    }
+
+    void Advance(std::size_t size) {
+        produced += size;
+        fill = static_cast<std::size_t>(std::min<std::uint64_t>(fill + size, kOutputWindowBytes));
+    }
+};
+
+// Produces and drops up to count bytes, straight into the producer's window. Returns the bytes
+// produced. Producer has an OutputWindow window and std::size_t Produce(std::byte*, std::size_t).
+template <class Producer>
+std::uint64_t DiscardThroughWindow(Producer& producer, std::uint64_t count) {
+    OutputWindow& window = producer.window;
+    std::uint64_t total = 0;
+    while (total < count) {
+        const auto slot = static_cast<std::size_t>(window.produced % kOutputWindowBytes);
+        const auto chunk = static_cast<std::size_t>(std::min<std::uint64_t>(count - total, kOutputWindowBytes - slot));
+        const std::size_t got = producer.Produce(window.bytes.get() + slot, chunk);
+        if (got == 0) {
+            break;
+        }
+        window.Advance(got);
+        total += got;
+    }
+    return total;
+}
+
+// Serves size bytes at position from a forward-only producer: from its window when they are
+// still there, by restarting it (bool Reset()) when they are older, and by producing straight
+// into out otherwise. Returns the bytes served; position moves past them.
+template <class Producer>
+std::uint64_t ReadThroughWindow(Producer& producer, std::uint64_t& position, std::byte* out, std::uint64_t size) {
+    OutputWindow& window = producer.window;
+    std::uint64_t done = 0;
+    while (done < size) {
+        const std::uint64_t want = size - done;
+        if (position < window.Begin()) {
+            // Too far back for the window: start over.
+            if (!producer.Reset()) {
+                break;
+            }
+        } else if (position < window.produced) {
+            const auto count = static_cast<std::size_t>(std::min(want, window.produced - position));
+            window.Recall(position, out + done, count);
+            done += count;
+            position += count;
+        } else if (position > window.produced) {
+            if (DiscardThroughWindow(producer, position - window.produced) == 0) {
+                break;
+            }
+        } else {
+            const std::size_t count = producer.Produce(out + done, static_cast<std::size_t>(want));
+            if (count == 0) {
+                break;
+            }
+            window.Remember(out + done, count);
+            done += count;
+            position += count;
+        }
+    }
+    return done;
+}
 
-ModFileReader::ModFileReader(fs::path filePath) {
-    Open(std::move(filePath));
+// One spare ModFileReader read-ahead buffer per thread: taken on a reader's first small read and
+// handed back on Close, so back-to-back loads on a loader thread do not allocate.
+thread_local std::unique_ptr<std::byte[]> t_spareReadAhead;
+
+}  // namespace
+
+std::uint64_t ModStreamReader::GetID() const {
+    return kModFileReaderId;
+}
+
+std::uint64_t ModStreamReader::GetFileSize() const {
+    return fileSize_;
+}
+
+const std::string& ModStreamReader::GetFilePath() const {
+    static const std::string kEmpty;
+    return override_ != nullptr ? override_->displayPath : kEmpty;
+}
+
+ModFileReader::ModFileReader(const ModOverride& modOverride) {
+    Open(modOverride);
 }
 
 ModFileReader::~ModFileReader() {
     Close();
 }
 
-bool ModFileReader::Open(fs::path filePath) {
-    if (stream_.is_open()) {
-        Close();
+bool ModFileReader::Open(const ModOverride& modOverride) {
+    Close();
+    override_ = &modOverride;
+    fileSize_ = modOverride.fileSize;
+    position_ = 0;
+    if (!modOverride.valid || modOverride.path.empty()) {
+        return false;
     }
 
-    filePath_ = std::move(filePath);
-    if (filePath_.empty() || !fs::exists(filePath_) || !fs::is_regular_file(filePath_)) {
+#ifdef _WIN32
+    // Same sharing as the CRT's fopen, so editing a mod while it is read is not blocked.
+    HANDLE handle = CreateFileW(modOverride.path.c_str(), GENERIC_READ,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    handle_ = handle;
+    if (modOverride.verifySizeOnOpen) {
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(handle, &size)) {
+            Close();
+            return false;
+        }
+        fileSize_ = static_cast<std::uint64_t>(size.QuadPart);
+    }
+#else
+    fd_ = ::open(modOverride.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        return false;
+    }
+    if (modOverride.verifySizeOnOpen) {
+        struct stat st {};
+        if (::fstat(fd_, &st) != 0) {
+            Close();
+            return false;
+        }
+        fileSize_ = static_cast<std::uint64_t>(st.st_size);
+    }
+#endif
+    return true;
+}
+
+void ModFileReader::Close() {
+#ifdef _WIN32
+    if (handle_ != nullptr) {
+        CloseHandle(handle_);
+        handle_ = nullptr;
+    }
+#else
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+    if (buffer_ && !t_spareReadAhead) {
+        t_spareReadAhead = std::move(buffer_);
+    }
+    buffer_.reset();
+    bufferBegin_ = 0;
+    bufferFill_ = 0;
+}
+
+// Only moves the position; the next Read goes to the new offset.
+std::int64_t ModFileReader::Skip(std::int64_t deltaBytes) {
+    if (!IsOpen()) {
+        return 0;
+    }
+
+    const std::int64_t current = static_cast<std::int64_t>(position_);
+    const std::int64_t target = std::clamp(current + deltaBytes, std::int64_t{0}, static_cast<std::int64_t>(fileSize_));
+    position_ = static_cast<std::uint64_t>(target);
+    return target - current;
+}
+
+std::uint64_t ModFileReader::ReadByte(std::uint8_t* outByte) {
+    if (outByte == nullptr) {
+        return 0;
+    }
+    if (position_ >= bufferBegin_ && position_ - bufferBegin_ < bufferFill_) {
+        *outByte = static_cast<std::uint8_t>(buffer_[static_cast<std::size_t>(position_ - bufferBegin_)]);
+        ++position_;
+        return 1;
+    }
+    return Read(outByte, 0, 1);
+}
+
+std::uint64_t ModFileReader::Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) {
+    if (!IsOpen() || dst == nullptr || size == 0 || position_ >= fileSize_) {
+        return 0;
+    }
+
+    auto* out = static_cast<std::byte*>(dst) + dstOffset;
+    const std::uint64_t toRead = std::min(size, fileSize_ - position_);
+    std::uint64_t done = 0;
+    if (position_ >= bufferBegin_ && position_ - bufferBegin_ < bufferFill_) {
+        const auto from = static_cast<std::size_t>(position_ - bufferBegin_);
+        const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(toRead, bufferFill_ - from));
+        std::memcpy(out, buffer_.get() + from, count);
+        done = count;
+        position_ += count;
+    }
+
+    const std::uint64_t want = toRead - done;
+    if (want >= kReadAheadBytes) {
+        const std::uint64_t got = ReadAt(position_, out + done, want);
+        done += got;
+        position_ += got;
+    } else if (want != 0) {
+        if (!buffer_) {
+            buffer_ = t_spareReadAhead ? std::move(t_spareReadAhead)
+                                       : std::make_unique_for_overwrite<std::byte[]>(kReadAheadBytes);
+        }
+        bufferBegin_ = position_;
+        bufferFill_ = static_cast<std::size_t>(
+            ReadAt(position_, buffer_.get(), std::min<std::uint64_t>(kReadAheadBytes, fileSize_ - position_)));
+        const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(want, bufferFill_));
+        std::memcpy(out + done, buffer_.get(), count);
+        done += count;
+        position_ += count;
+    }
+    return done;
+}
+
+bool ModFileReader::IsOpen() const {
+#ifdef _WIN32
+    return handle_ != nullptr;
+#else
+    return fd_ >= 0;
+#endif
+}
+
+bool ModFileReader::IsRedirectable() const {
+    return true;
+}
+
+std::uint64_t ModFileReader::ReadAt(std::uint64_t offset, std::byte* dst, std::uint64_t size) {
+    std::uint64_t total = 0;
+    while (total < size) {
+#ifdef _WIN32
+        // A synchronous handle reads at the OVERLAPPED offset, without touching its file pointer.
+        OVERLAPPED overlapped{};
+        const std::uint64_t at = offset + total;
+        overlapped.Offset = static_cast<DWORD>(at);
+        overlapped.OffsetHigh = static_cast<DWORD>(at >> 32);
+        const auto chunk = static_cast<DWORD>(std::min<std::uint64_t>(size - total, 1u << 30));
+        DWORD got = 0;
+        if (!ReadFile(handle_, dst + total, chunk, &got, &overlapped) || got == 0) {
+            break;
+        }
+#else
+        const auto chunk = static_cast<std::size_t>(std::min<std::uint64_t>(size - total, 1u << 30));
+        const ssize_t got = ::pread(fd_, dst + total, chunk, static_cast<off_t>(offset + total));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            break;
+        }
+#endif
+        total += static_cast<std::uint64_t>(got);
+    }
+    return total;
+}
+
+ModMemoryReader::ModMemoryReader(const ModOverride& modOverride) {
+    Open(modOverride);
+}
+
+bool ModMemoryReader::Open(const ModOverride& modOverride) {
+    override_ = &modOverride;
+    data_ = modOverride.preloadedData;
+    fileSize_ = data_.size();
+    position_ = 0;
+    open_ = modOverride.valid && modOverride.preloaded;
+    return open_;
+}
+
+void ModMemoryReader::Close() {
+    open_ = false;
+}
+
+std::int64_t ModMemoryReader::Skip(std::int64_t deltaBytes) {
+    if (!open_) {
+        return 0;
+    }
+
+    const std::int64_t current = static_cast<std::int64_t>(position_);
+    const std::int64_t target = std::clamp(current + deltaBytes, std::int64_t{0}, static_cast<std::int64_t>(fileSize_));
+    position_ = static_cast<std::uint64_t>(target);
+    return target - current;
+}
+
+std::uint64_t ModMemoryReader::ReadByte(std::uint8_t* outByte) {
+    if (outByte == nullptr) {
+        return 0;
+    }
+    return Read(outByte, 0, 1);
+}
+
+std::uint64_t ModMemoryReader::Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) {
+    if (!open_ || dst == nullptr || size == 0) {
+        return 0;
+    }
+
+    const std::uint64_t toRead = std::min(size, fileSize_ - position_);
+    if (toRead != 0) {
+        std::memcpy(static_cast<std::byte*>(dst) + dstOffset, data_.data() + position_, static_cast<std::size_t>(toRead));
+        position_ += toRead;
+    }
+    return toRead;
+}
+
+bool ModMemoryReader::IsOpen() const {
+    return open_;
+}
+
+bool ModMemoryReader::IsRedirectable() const {
+    return true;
+}
+
+// The inflate state and its output window.
+struct ModInflateReader::Inflater {
+    z_stream zs{};
+    bool initialized = false;
+    // Z_STREAM_END, a truncated file or corrupt data: nothing more will be produced.
+    bool finished = false;
+    // Finished at Z_STREAM_END, rather than short of it.
+    bool ended = false;
+    std::FILE* file = nullptr;
+    OutputWindow window{};
+    std::unique_ptr<std::byte[]> input = std::make_unique_for_overwrite<std::byte[]>(kInflateInputBytes);
+
+    ~Inflater() {
+        if (initialized) {
+            inflateEnd(&zs);
+        }
+    }
+
+    // Back to the first byte of the stream.
+    bool Reset() {
+        if (std::fseek(file, 0, SEEK_SET) != 0) {
+            return false;
+        }
+        zs.next_in = nullptr;
+        zs.avail_in = 0;
+        if (!initialized) {
+            if (inflateInit2(&zs, kInflateWindowBits) != Z_OK) {
+                return false;
+            }
+            initialized = true;
+        } else if (inflateReset(&zs) != Z_OK) {
+            return false;
+        }
+        finished = false;
+        ended = false;
+        window.Clear();
+        return true;
+    }
+
+    // Inflates up to size bytes into dst without touching the window; 0 once finished.
+    std::size_t Produce(std::byte* dst, std::size_t size) {
+        std::size_t total = 0;
+        while (total < size && !finished) {
+            if (zs.avail_in == 0) {
+                const std::size_t got = std::fread(input.get(), 1, kInflateInputBytes, file);
+                if (got == 0) {
+                    finished = true;
+                    break;
+                }
+                zs.next_in = reinterpret_cast<Bytef*>(input.get());
+                zs.avail_in = static_cast<uInt>(got);
+            }
+            const auto chunk = static_cast<uInt>(std::min<std::size_t>(size - total, std::numeric_limits<uInt>::max()));
+            zs.next_out = reinterpret_cast<Bytef*>(dst + total);
+            zs.avail_out = chunk;
+            const int result = inflate(&zs, Z_NO_FLUSH);
+            total += chunk - zs.avail_out;
+            if (result != Z_OK && result != Z_BUF_ERROR) {
+                finished = true;
+                ended = result == Z_STREAM_END;
+            }
+        }
+        return total;
+    }
+};
+
+ModInflateReader::ModInflateReader(const ModOverride& modOverride) {
+    Open(modOverride);
+}
+
+ModInflateReader::~ModInflateReader() {
+    Close();
+}
+
+bool ModInflateReader::Open(const ModOverride& modOverride) {
+    Close();
+    override_ = &modOverride;
+    fileSize_ = 0;
+    position_ = 0;
+    if (!modOverride.valid || modOverride.path.empty()) {
         return false;
     }
 
     try {
-        fileSize_ = fs::file_size(filePath_);
-        stream_.open(filePath_);
+        stream_.open(modOverride.path);
     } catch (...) {
         Close();
         return false;
     }
-    return stream_.is_open();
+    if (!stream_.is_open()) {
+        return false;
+    }
+
+    auto inflater = std::make_unique<Inflater>();
+    inflater->file = stream_.rdbuf();
+    std::uint8_t header[2] = {};
+    if (std::fread(header, 1, sizeof(header), inflater->file) != sizeof(header)) {
+        Close();
+        return false;
+    }
+    const bool gzip = header[0] == 0x1F && header[1] == 0x8B;
+    const bool zlib = (header[0] & 0x0F) == Z_DEFLATED && ((header[0] << 8) | header[1]) % 31 == 0;
+    if (gzip) {
+        // ISIZE: the inflated size modulo 2^32, little-endian, in the last four bytes.
+        std::uint8_t trailer[4] = {};
+        if (std::fseek(inflater->file, -4, SEEK_END) != 0 ||
+            std::fread(trailer, 1, sizeof(trailer), inflater->file) != sizeof(trailer)) {
+            Close();
+            return false;
+        }
+        fileSize_ = std::uint64_t{trailer[0]} | (std::uint64_t{trailer[1]} << 8) | (std::uint64_t{trailer[2]} << 16) |
+                    (std::uint64_t{trailer[3]} << 24);
+    } else if (zlib) {
+        if (!inflater->Reset()) {
+            Close();
+            return false;
+        }
+        // A zlib stream has no size field: inflate it through, and refuse one that stops short.
+        fileSize_ = DiscardThroughWindow(*inflater, std::numeric_limits<std::uint64_t>::max());
+        if (!inflater->ended) {
+            Close();
+            return false;
+        }
+    } else {
+        Close();
+        return false;
+    }
+
+    if (!inflater->Reset()) {
+        Close();
+        return false;
+    }
+    inflater_ = std::move(inflater);
+    return true;
 }
 
-void ModFileReader::Close() {
+void ModInflateReader::Close() {
+    inflater_.reset();
     if (stream_.is_open()) {
         stream_.close();
     }
 }
 
-std::int64_t ModFileReader::Skip(std::int64_t deltaBytes) {
-    if (!stream_.is_open()) {
+// Only moves the position; the stream catches up on the next Read.
+std::int64_t ModInflateReader::Skip(std::int64_t deltaBytes) {
+    if (!inflater_) {
         return 0;
     }
 
-    const std::int64_t current = static_cast<std::int64_t>(stream_.tell());
-    const std::int64_t end = static_cast<std::int64_t>(fileSize_);
-    const std::int64_t target = std::clamp(current + deltaBytes, std::int64_t{0}, end);
-    stream_.seek_absolute(static_cast<binary_io::streamoff>(target));
+    const std::int64_t current = static_cast<std::int64_t>(position_);
+    const std::int64_t target = std::clamp(current + deltaBytes, std::int64_t{0}, static_cast<std::int64_t>(fileSize_));
+    position_ = static_cast<std::uint64_t>(target);
     return target - current;
 }
 
-std::uint64_t ModFileReader::ReadByte(std::uint8_t* outByte) {
+std::uint64_t ModInflateReader::ReadByte(std::uint8_t* outByte) {
     if (outByte == nullptr) {
         return 0;
     }
     return Read(outByte, 0, 1);
 }
 
-std::uint64_t ModFileReader::Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) {
-    if (!stream_.is_open() || dst == nullptr || size == 0) {
+std::uint64_t ModInflateReader::Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) {
+    if (!inflater_ || dst == nullptr || size == 0 || position_ >= fileSize_) {
+        return 0;
+    }
+
+    const std::uint64_t toRead = std::min(size, fileSize_ - position_);
+    return ReadThroughWindow(*inflater_, position_, static_cast<std::byte*>(dst) + dstOffset, toRead);
+}
+
+bool ModInflateReader::IsOpen() const {
+    return inflater_ != nullptr;
+}
+
+bool ModInflateReader::IsRedirectable() const {
+    return false;
+}
+
+// The delta op being applied, the source and delta streams, and the output window.
+struct ModDeltaReader::Applier {
+    explicit Applier(const ModOverride& modOverride) : delta(modOverride) {}
+
+    ModFileReader delta;
+    IFileStreamReader* source = nullptr;
+    ModDeltaHeader header{};
+    // Source bytes consumed through Skip and Read, for rewinding it.
+    std::uint64_t sourceConsumed = 0;
+    // Output produced since the last Reset; the ops end at header.targetSize.
+    std::uint64_t output = 0;
+    std::uint64_t opRemaining = 0;
+    bool opIsCopy = false;
+    // The end of the ops, a short source or a malformed op: nothing more will be produced.
+    bool finished = false;
+    OutputWindow window{};
+
+    bool ReadVarint(std::uint64_t& outValue) {
+        std::uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            std::uint8_t byte = 0;
+            if (delta.ReadByte(&byte) != 1) {
+                return false;
+            }
+            value |= std::uint64_t{byte & 0x7Fu} << shift;
+            if ((byte & 0x80) == 0) {
+                outValue = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Decodes the next op and moves the source to its first byte.
+    bool NextOp() {
+        std::uint64_t op = 0;
+        if (!ReadVarint(op)) {
+            return false;
+        }
+        opRemaining = op >> 1;
+        opIsCopy = (op & 1) == kModDeltaCopy;
+        if (opRemaining == 0 || opRemaining > header.targetSize - output) {
+            return false;
+        }
+        if (opIsCopy) {
+            std::uint64_t skip = 0;
+            if (!ReadVarint(skip) || skip > header.sourceSize - sourceConsumed ||
+                opRemaining > header.sourceSize - sourceConsumed - skip) {
+                return false;
+            }
+            if (skip != 0 && static_cast<std::uint64_t>(source->Skip(static_cast<std::int64_t>(skip))) != skip) {
+                return false;
+            }
+            sourceConsumed += skip;
+        }
+        return true;
+    }
+
+    // Back to the first op and the first source byte.
+    bool Reset() {
+        if (sourceConsumed != 0 &&
+            source->Skip(-static_cast<std::int64_t>(sourceConsumed)) != -static_cast<std::int64_t>(sourceConsumed)) {
+            return false;
+        }
+        sourceConsumed = 0;
+        delta.Skip(-static_cast<std::int64_t>(delta.GetFileSize()));
+        delta.Skip(static_cast<std::int64_t>(sizeof(ModDeltaHeader)));
+        output = 0;
+        opRemaining = 0;
+        finished = false;
+        window.Clear();
+        return true;
+    }
+
+    // Applies ops into up to size bytes of dst without touching the window; 0 once finished.
+    std::size_t Produce(std::byte* dst, std::size_t size) {
+        std::size_t total = 0;
+        while (total < size && !finished) {
+            if (opRemaining == 0 && (output == header.targetSize || !NextOp())) {
+                finished = true;
+                break;
+            }
+            const std::uint64_t chunk = std::min<std::uint64_t>(size - total, opRemaining);
+            const std::uint64_t got = opIsCopy ? source->Read(dst, total, chunk) : delta.Read(dst, total, chunk);
+            if (got == 0) {
+                finished = true;
+                break;
+            }
+            total += static_cast<std::size_t>(got);
+            output += got;
+            opRemaining -= got;
+            sourceConsumed += opIsCopy ? got : 0;
+        }
+        return total;
+    }
+};
+
+ModDeltaReader::ModDeltaReader(const ModOverride& modOverride, IFileStreamReader& source, std::uint64_t sourceSize) {
+    Open(modOverride, source, sourceSize);
+}
+
+ModDeltaReader::~ModDeltaReader() {
+    Close();
+}
+
+bool ModDeltaReader::Open(const ModOverride& modOverride, IFileStreamReader& source, std::uint64_t sourceSize) {
+    Close();
+    override_ = &modOverride;
+    fileSize_ = 0;
+    position_ = 0;
+    expectedSourceSize_ = 0;
+    sourceMismatch_ = false;
+    if (!modOverride.valid || modOverride.path.empty()) {
+        return false;
+    }
+
+    auto applier = std::make_unique<Applier>(modOverride);
+    std::array<std::byte, sizeof(ModDeltaHeader)> headerBytes{};
+    if (!applier->delta.IsOpen() || applier->delta.Read(headerBytes.data(), 0, headerBytes.size()) != headerBytes.size()) {
+        return false;
+    }
+    const auto header = ReadModDeltaHeader(headerBytes);
+    if (!header.has_value()) {
+        return false;
+    }
+    expectedSourceSize_ = header->sourceSize;
+    if (header->sourceSize != sourceSize) {
+        sourceMismatch_ = true;
+        return false;
+    }
+
+    // A payload of the same size can still be another one (a game patch editing it in place), so
+    // the whole source goes through crc32 once, through the still unused window, and is rewound.
+    // A copy skips source bytes, so the ops alone could not check it.
+    std::byte* scratch = applier->window.bytes.get();
+    uLong crc = crc32(0, nullptr, 0);
+    std::uint64_t checked = 0;
+    while (checked < sourceSize) {
+        const auto chunk = static_cast<uInt>(std::min<std::uint64_t>(sourceSize - checked, kOutputWindowBytes));
+        const std::uint64_t got = source.Read(scratch, 0, chunk);
+        if (got == 0) {
+            break;
+        }
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(scratch), static_cast<uInt>(got));
+        checked += got;
+    }
+    if (checked != 0 && source.Skip(-static_cast<std::int64_t>(checked)) != -static_cast<std::int64_t>(checked)) {
+        return false;
+    }
+    if (checked != sourceSize || static_cast<std::uint32_t>(crc) != header->sourceCrc32) {
+        sourceMismatch_ = true;
+        return false;
+    }
+
+    applier->header = *header;
+    applier->source = &source;
+    fileSize_ = header->targetSize;
+    applier_ = std::move(applier);
+    return true;
+}
+
+// The source stream belongs to the game, so it is left open.
+void ModDeltaReader::Close() {
+    applier_.reset();
+}
+
+// Only moves the position; the streams catch up on the next Read.
+std::int64_t ModDeltaReader::Skip(std::int64_t deltaBytes) {
+    if (!applier_) {
         return 0;
     }
 
-    const std::uint64_t current = static_cast<std::uint64_t>(stream_.tell());
-    const std::uint64_t remain = (current < fileSize_) ? (fileSize_ - current) : 0;
-    const std::uint64_t toRead = std::min(size, remain);
-    if (toRead == 0) {
+    const std::int64_t current = static_cast<std::int64_t>(position_);
+    const std::int64_t target = std::clamp(current + deltaBytes, std::int64_t{0}, static_cast<std::int64_t>(fileSize_));
+    position_ = static_cast<std::uint64_t>(target);
+    return target - current;
+}
+
+std::uint64_t ModDeltaReader::ReadByte(std::uint8_t* outByte) {
+    if (outByte == nullptr) {
         return 0;
     }
+    return Read(outByte, 0, 1);
+}
 
-    auto* out = static_cast<std::byte*>(dst) + dstOffset;
-    const auto before = stream_.tell();
-    try {
-        stream_.read_bytes(std::span<std::byte>(out, static_cast<std::size_t>(toRead)));
-    } catch (const binary_io::buffer_exhausted&) {
+std::uint64_t ModDeltaReader::Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) {
+    if (!applier_ || dst == nullptr || size == 0 || position_ >= fileSize_) {
+        return 0;
     }
-    const auto after = stream_.tell();
-    return (after > before) ? static_cast<std::uint64_t>(after - before) : 0;
+
+    const std::uint64_t toRead = std::min(size, fileSize_ - position_);
+    return ReadThroughWindow(*applier_, position_, static_cast<std::byte*>(dst) + dstOffset, toRead);
 }
 
-std::uint64_t ModFileReader::GetID() const {
-    return kModFileReaderId;
+bool ModDeltaReader::IsOpen() const {
+    return applier_ != nullptr;
 }
 
-bool ModFileReader::IsOpen() const {
-    return stream_.is_open();
+bool ModDeltaReader::IsRedirectable() const {
+    return false;
 }
 
-std::uint64_t ModFileReader::GetFileSize() const {
-    return fileSize_;
+std::uint64_t ModDeltaReader::GetSourceSize() const {
+    return expectedSourceSize_;
 }
 
-std::string ModFileReader::GetFilePath() const {
-    return filePath_.generic_string();
+bool ModDeltaReader::IsSourceMismatch() const {
+    return sourceMismatch_;
 }
 
 }  // namespace LooseFileLoader
-
@@ -1,19 +1,19 @@
 #include "ModHooks.h"
+#include "AssetDeserializer.h"
+#include "AssetIdTable.h"
 #include "Common.h"
 #include "ModFileReader.h"
-#include "ModAssetManager.h"
 
 #include <HookUtils.h>
 #include <LogUtils.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
-
-#include <cstdio>
 #include <memory>
-#include <optional>
+#include <mutex>
 #include <string>
-#include <system_error>
 
 namespace fs = std::filesystem;
 
@@ -27,31 +27,56 @@ using FnLoadAssetFromFile =
 
 using FnRegisterAssetHandler = bool (*)(void*, std::uint32_t, IBaseGameAssetHandler*);
 
-std::string FormatDiskSize(std::uint64_t size) {
-    constexpr double kUnit = 1024.0;
-    constexpr const char* kUnits[] = {"B", "KB", "MB", "GB", "TB"};
-
-    double value = static_cast<double>(size);
-    std::size_t unitIndex = 0;
-    while (value >= kUnit && unitIndex < (std::size(kUnits) - 1)) {
-        value /= kUnit;
-        ++unitIndex;
-    }
-
-    if (unitIndex == 0) {
-        return std::to_string(size) + "B";
-    }
-
-    char buffer[32] = {};
-    std::snprintf(buffer, sizeof(buffer), "%.1f%s", value, kUnits[unitIndex]);
-    return buffer;
+// Checks our offline model of the live fileKtid index once, when the first asset is deserialized.
+void ValidateLiveAssetIdTable(const GameManager::AssetIdManager& assetIdManager) {
+    static std::once_flag once;
+    std::call_once(once, [&assetIdManager]() {
+        AssetIdManagerLayout layout{};
+        layout.sortedFileKtid = assetIdManager.sortedFileKtid;
+        layout.keyCount = assetIdManager.keyCount;
+        layout.keyCountCopy = assetIdManager.keyCountCopy;
+        layout.treeDepth = assetIdManager.treeDepth;
+        layout.stepPerDepth = assetIdManager.stepPerDepth;
+        layout.branchFactor = assetIdManager.branchFactor;
+        layout.branchSpan = assetIdManager.branchSpan;
+        layout.bucketStrideBytes = assetIdManager.bucketStrideBytes;
+
+        const auto report = ValidateAssetIdManagerLayout(layout, [&assetIdManager](std::uint32_t fileKtid) {
+            return assetIdManager.GetResIdByFileKtid(fileKtid);
+        });
+        _MESSAGE("AssetIdManager: keys=%u depth=%u step=%u branch=%u span=%u stride=%u | sorted=%d stride=%d depth=%d lookups=%zu mismatches=%zu",
+                 layout.keyCount, layout.treeDepth, layout.stepPerDepth, layout.branchFactor, layout.branchSpan,
+                 layout.bucketStrideBytes, report.keysSorted ? 1 : 0, report.strideMatchesBranchFactor ? 1 : 0,
+                 report.depthMatchesKeyCount ? 1 : 0, report.sampledLookups, report.lookupMismatches);
+        for (const auto& issue : report.issues) {
+            _MESSAGE("AssetIdManager: %s", issue.c_str());
+        }
+    });
 }
 
+// Hook sites, resolved together by InstallHooks in one pass over the game image. The
+// RegisterAssetHandler hook only exists in debug builds, so release builds neither scan nor
+// cache its site: a miss is never cached and would send every launch back to a full scan.
+enum HookSite : std::size_t {
+    kDeserializeAssetSite,
+    kGetArchiveInfoSite,
+#ifdef _DEBUG
+    kRegisterAssetHandlerSite,
+#endif
+    kHookSiteCount,
+};
 
+constexpr HookUtils::IDAPattern kHookSitePatterns[kHookSiteCount] = {
+    {"FF 93 B0 ? ? ? 48 8D 4D ? 49 89 45"},
+    {"E8 ? ? ? ? 85 C0 0F 85 ? ? ? ? 4C 8B 7E", 0, 1, 5},
+#ifdef _DEBUG
+    {"E8 ? ? ? ? 84 C0 0F 84 ? ? ? ? 83 65 ? 00 48 8D 15", 0, 1, 5},
+#endif
+};
 
-bool InstallGetArchiveInfoFromAssetLoaderHook() {
+bool InstallGetArchiveInfoFromAssetLoaderHook(std::uintptr_t address) {
     using FnGetArchiveInfo = int32_t (*)(AssetReader*, AssetReader::ArchiveInfo*);
-    auto func = (FnGetArchiveInfo)HookUtils::ScanIDAPattern("E8 ? ? ? ? 85 C0 0F 85 ? ? ? ? 4C 8B 7E", 0, 1, 5);
+    auto func = (FnGetArchiveInfo)address;
     if (func == nullptr) {
         _MESSAGE("Failed to resolve GetArchiveInfo");
         return false;
@@ -62,12 +87,19 @@ bool InstallGetArchiveInfoFromAssetLoaderHook() {
 
         // _MESSAGE("GetArchiveInfo result: %d, fileHandle: %p, path: %s", errorCode, assetReader->archiveFileHandle, archiveInfo->filePath);
         auto *streamReader = assetReader->streamReader;
-        if (errorCode == 0 && streamReader != nullptr && streamReader->GetID() == ModFileReader::kModFileReaderId) {
-            auto *modFileReader = (ModFileReader*)streamReader;
+        if (errorCode == 0 && streamReader != nullptr && streamReader->GetID() == ModStreamReader::kModFileReaderId) {
+            auto *modFileReader = (ModStreamReader*)streamReader;
+            if (!modFileReader->IsRedirectable()) {
+                // Reopening a .gz/.zlib/.delta file by path would hand the handler encoded bytes.
+                _MESSAGE("Not redirecting streaming file path for compressed or delta override %s; ship it uncompressed to stream it",
+                    modFileReader->GetFilePath().c_str());
+                return errorCode;
+            }
             std::string vanillaFilePath = archiveInfo->filePath;
-            auto filePath = modFileReader->GetFilePath();
-            std::strncpy(archiveInfo->filePath, filePath.c_str(), filePath.size());
-            archiveInfo->filePath[filePath.size()] = '\0';
+            const auto& filePath = modFileReader->GetFilePath();
+            const std::size_t length = std::min(filePath.size(), sizeof(archiveInfo->filePath) - 1);
+            std::memcpy(archiveInfo->filePath, filePath.data(), length);
+            archiveInfo->filePath[length] = '\0';
             _MESSAGE("Redirect streaming file path: %s -> %s", vanillaFilePath.c_str(), filePath.c_str());
         }
         return errorCode;
@@ -76,9 +108,8 @@ bool InstallGetArchiveInfoFromAssetLoaderHook() {
 }
 
 #ifdef _DEBUG
-bool InstallRegisterAssetHandlerHook() {
-    auto registerAssetHandler = reinterpret_cast<FnRegisterAssetHandler>(
-        HookUtils::ScanIDAPattern("E8 ? ? ? ? 84 C0 0F 84 ? ? ? ? 83 65 ? 00 48 8D 15", 0, 1, 5));
+bool InstallRegisterAssetHandlerHook(std::uintptr_t address) {
+    auto registerAssetHandler = reinterpret_cast<FnRegisterAssetHandler>(address);
     if (registerAssetHandler == nullptr) {
         _MESSAGE("Failed to resolve RegisterAssetHandler");
         return false;
@@ -110,9 +141,7 @@ bool InstallRegisterAssetHandlerHook() {
 
 }  // namespace
 
-
-bool InstallDeserializeAssetHook() {
-    auto patchAddress = HookUtils::ScanIDAPattern("FF 93 B0 ? ? ? 48 8D 4D ? 49 89 45");
+bool InstallDeserializeAssetHook(std::uintptr_t patchAddress) {
     if (patchAddress == 0) {
         _MESSAGE("Failed to resolve DeserializeAsset");
         return false;
@@ -129,91 +158,45 @@ bool InstallDeserializeAssetHook() {
         auto *assetReader = (AssetReader*)ctx.r8;
         auto *archiveManager = assetReader->archiveManager;
         auto *gameAsset = loadingContext->gameAsset;
-        auto assetFileSize = assetReader->assetFileSize;
-
-        // _MESSAGE("assetHandler: %p, loadingContext: %p, assetReader: %p, archiveManager: %p, gameAsset: %p, assetFileSize: %llu",
-        //         assetHandler, loadingContext, assetReader, archiveManager, gameAsset, assetFileSize);
 
-        do {
-            if (gameAsset == nullptr || archiveManager == nullptr) {
-                break;
-            }
-            auto fileKtid = archiveManager->assetManager.assetIdManager.GetFileKtIdFromRes(gameAsset);
-            if (fileKtid == 0xFFFFFFFF) {
-                break;
-            }
-            const auto typeId = gameAsset->typeInfoKtid;
-            const std::string typeName = assetHandler ? assetHandler->GetTypeName() : "Unknown";
-        
-            if (g_enableAssetLoadingLog) {
-                _MESSAGE("\tLoading asset: 0x%08X | Type: %s (0x%08X) | Size: %s", fileKtid, typeName.c_str(), typeId, FormatDiskSize(assetFileSize).c_str());
+        std::uint32_t fileKtid = kInvalidFileKtid;
+        if (gameAsset != nullptr && archiveManager != nullptr) {
+            if (g_validateAssetIdTable) {
+                ValidateLiveAssetIdTable(archiveManager->assetManager.assetIdManager);
             }
-            // auto resId = archiveManager->assetManager.assetIdManager.GetResIdByFileKtid(fileKtid);
-            // _MESSAGE("ResId: %u, fileKtid: %08X, typeId: %08X", resId, fileKtid, typeId);
-
-            // auto *resItem = archiveManager->assetManager.assetIdManager.GetResItemById(resId);
-            // _MESSAGE("ResItem: %p, targetAsset: %p", resItem, targetAsset);
-            const auto overridePath = g_modAssetManager.Find(fileKtid);
-            if (!overridePath.has_value()) {
-                break;
-            }
-
-            std::error_code ec;
-            if (!fs::exists(*overridePath, ec) || !fs::is_regular_file(*overridePath, ec)) {
-                break;
-            }
-
-            auto reader = std::make_unique<ModFileReader>(*overridePath);
-            if (!reader->IsOpen()) {
-                _MESSAGE("Failed to open mod asset file: %s", overridePath->string().c_str());
-                break;
-            }
-
-            assetReader->streamReader = reader.get();
-            assetReader->assetFileSize = reader->GetFileSize();
-            assetReader->archiveFileOffset = 0;
-
-            auto *assetData = assetHandler->Deserialize(loadingContext, assetReader, (void*)ctx.r9);
-
-            if (assetData) {
-                _MESSAGE("Loaded mod asset successfully: 0x%08X | Type: %s (0x%08X) | %s",
-                        fileKtid, typeName.c_str(), typeId, overridePath->string().c_str());
-            } else {
-                _MESSAGE("Failed to load mod asset: 0x%08X | Type: %s (0x%08X) | %s",
-                        fileKtid, typeName.c_str(), typeId, overridePath->string().c_str());
-            }
-
-            ctx.rax = (uintptr_t)assetData;
-            return;
-
-        } while (false);
-
-        
-        // call original deserialize function
-        auto *assetData = assetHandler->Deserialize(loadingContext, assetReader, (void*)ctx.r9);
-        ctx.rax = (uintptr_t)assetData;
+            fileKtid = archiveManager->assetManager.assetIdManager.GetFileKtIdFromRes(gameAsset);
+        }
+        ctx.rax = (uintptr_t)DeserializeAsset(assetHandler, loadingContext, assetReader, (void*)ctx.r9, fileKtid);
     });
 
     return true;
 }
 
+AssetTelemetry::TypeNameResolver GetAssetTypeNameResolver() {
+    return [](const void* handler) {
+        return std::string(GetAssetHandlerTypeName(static_cast<const IBaseGameAssetHandler*>(handler)));
+    };
+}
+
 bool InstallHooks() {
-    if (!InstallDeserializeAssetHook()) {
+    const auto sites = HookUtils::ScanIDAPatterns(kHookSitePatterns);
+    // Every signature is resolved by now, the REL::Pattern globals included.
+    HookUtils::SaveSignatureCache();
+    if (!InstallDeserializeAssetHook(sites[kDeserializeAssetSite])) {
         _MESSAGE("Failed to install DeserializeAsset hook");
         return false;
     }
-    if (!InstallGetArchiveInfoFromAssetLoaderHook()) {
+    if (!InstallGetArchiveInfoFromAssetLoaderHook(sites[kGetArchiveInfoSite])) {
         _MESSAGE("Failed to install GetArchiveInfoFromAssetLoader hook");
         return false;
     }
 #ifdef _DEBUG
-    if (!InstallRegisterAssetHandlerHook()) {
+    if (!InstallRegisterAssetHandlerHook(sites[kRegisterAssetHandlerSite])) {
         _MESSAGE("Failed to install RegisterAssetHandlerHook");
         return false;
     }
 #endif
     return true;
-
 }
 
 }  // namespace LooseFileLoader
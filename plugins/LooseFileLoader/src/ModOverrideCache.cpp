@@ -0,0 +1,291 @@
+#include "ModOverrideCache.h"
+
+#include "binary_io/binary_io.hpp"
+
+#include <array>
+#include <cstring>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace LooseFileLoader {
+namespace {
+
+constexpr std::array<char, 4> kModCacheMagic{'L', 'F', 'M', 'C'};
+constexpr std::uint32_t kModCacheVersion = 1;
+
+void SetError(std::string* error, std::string_view message) {
+    if (error != nullptr) {
+        *error = std::string(message);
+    }
+}
+
+// Deduplicated UTF-8 string blob; most paths appear both as a candidate and as a winner.
+class StringPool final {
+public:
+    std::pair<std::uint32_t, std::uint32_t> Add(const std::string& text) {
+        const auto [it, inserted] = offsets_.try_emplace(text, static_cast<std::uint32_t>(blob_.size()));
+        if (inserted) {
+            blob_ += text;
+        }
+        return {it->second, static_cast<std::uint32_t>(text.size())};
+    }
+    std::pair<std::uint32_t, std::uint32_t> Add(const fs::path& path) {
+        return Add(ToCachePath(path));
+    }
+
+    [[nodiscard]] const std::string& Blob() const {
+        return blob_;
+    }
+
+private:
+    std::string blob_{};
+    std::unordered_map<std::string, std::uint32_t> offsets_{};
+};
+
+template <class T>
+void AppendPod(std::vector<std::byte>& out, const T& value) {
+    const auto* bytes = reinterpret_cast<const std::byte*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+ModCacheFileEntry EncodeFile(StringPool& strings, std::uint32_t fileKtid, const fs::path& path,
+                             std::uint64_t fileSize, bool valid) {
+    ModCacheFileEntry entry{};
+    entry.fileSize = fileSize;
+    entry.fileKtid = fileKtid;
+    std::tie(entry.pathOffset, entry.pathLength) = strings.Add(path);
+    entry.valid = valid ? 1u : 0u;
+    return entry;
+}
+
+}  // namespace
+
+std::string ToCachePath(const fs::path& path) {
+    const std::u8string utf8 = path.u8string();
+    return std::string(reinterpret_cast<const char*>(utf8.data()), utf8.size());
+}
+
+fs::path FromCachePath(std::string_view utf8) {
+    return fs::path(std::u8string_view(reinterpret_cast<const char8_t*>(utf8.data()), utf8.size()));
+}
+
+ModOverrideCache::ModOverrideCache(MappedFile mapping) : mapping_(std::move(mapping)) {}
+
+std::optional<ModOverrideCache> ModOverrideCache::Open(const fs::path& path, std::string* error) {
+    auto mapping = MappedFile::Open(path, error);
+    if (!mapping.has_value()) {
+        return std::nullopt;
+    }
+    ModOverrideCache cache(std::move(*mapping));
+    if (!cache.Attach(error)) {
+        return std::nullopt;
+    }
+    return cache;
+}
+
+bool ModOverrideCache::Attach(std::string* error) {
+    const auto bytes = mapping_.Bytes();
+    if (bytes.size() < sizeof(ModCacheHeader)) {
+        SetError(error, "Mod override cache is too small.");
+        return false;
+    }
+    header_ = reinterpret_cast<const ModCacheHeader*>(bytes.data());
+    if (std::memcmp(header_->magic, kModCacheMagic.data(), kModCacheMagic.size()) != 0 ||
+        header_->version != kModCacheVersion) {
+        SetError(error, "Unsupported mod override cache format.");
+        return false;
+    }
+
+    const std::uint64_t folderBytes = std::uint64_t{header_->folderCount} * sizeof(ModCacheFolderEntry);
+    const std::uint64_t fileBytes =
+        (std::uint64_t{header_->candidateCount} + header_->winnerCount) * sizeof(ModCacheFileEntry);
+    const std::uint64_t conflictBytes = std::uint64_t{header_->conflictCount} * sizeof(ModCacheConflictEntry);
+    if (sizeof(ModCacheHeader) + folderBytes + fileBytes + conflictBytes + header_->stringBytes != bytes.size() ||
+        header_->modsDirLength > header_->stringBytes) {
+        SetError(error, "Mod override cache size mismatch.");
+        return false;
+    }
+
+    const std::byte* cursor = bytes.data() + sizeof(ModCacheHeader);
+    folders_ = reinterpret_cast<const ModCacheFolderEntry*>(cursor);
+    cursor += folderBytes;
+    candidates_ = reinterpret_cast<const ModCacheFileEntry*>(cursor);
+    winners_ = candidates_ + header_->candidateCount;
+    cursor += fileBytes;
+    conflicts_ = reinterpret_cast<const ModCacheConflictEntry*>(cursor);
+    cursor += conflictBytes;
+    strings_ = reinterpret_cast<const char*>(cursor);
+
+    // Bounds-check every reference once, so the accessors below can trust the image.
+    const auto stringInRange = [this](std::uint32_t offset, std::uint32_t length) {
+        return std::uint64_t{offset} + length <= header_->stringBytes;
+    };
+    for (std::uint32_t i = 0; i < header_->folderCount; ++i) {
+        const auto& folder = folders_[i];
+        if (!stringInRange(folder.pathOffset, folder.pathLength) ||
+            std::uint64_t{folder.firstCandidate} + folder.candidateCount > header_->candidateCount) {
+            SetError(error, "Mod override cache has a corrupt folder entry.");
+            return false;
+        }
+    }
+    const std::uint64_t fileCount = std::uint64_t{header_->candidateCount} + header_->winnerCount;
+    for (std::uint64_t i = 0; i < fileCount; ++i) {
+        if (!stringInRange(candidates_[i].pathOffset, candidates_[i].pathLength)) {
+            SetError(error, "Mod override cache has a corrupt file entry.");
+            return false;
+        }
+    }
+    for (std::uint32_t i = 0; i < header_->conflictCount; ++i) {
+        const auto& conflict = conflicts_[i];
+        if (!stringInRange(conflict.keptOffset, conflict.keptLength) ||
+            !stringInRange(conflict.skippedOffset, conflict.skippedLength)) {
+            SetError(error, "Mod override cache has a corrupt conflict entry.");
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ModOverrideCache::Save(const fs::path& path, const fs::path& modsDir, std::span<const ModCacheFolder> folders,
+                            std::span<const ModOverride> winners, std::span<const ModOverrideConflict> conflicts,
+                            std::string* error) {
+    StringPool strings;
+    ModCacheHeader header{};
+    header.modsDirLength = strings.Add(modsDir).second;
+
+    std::vector<ModCacheFolderEntry> folderEntries;
+    std::vector<ModCacheFileEntry> fileEntries;
+    folderEntries.reserve(folders.size());
+    for (const ModCacheFolder& folder : folders) {
+        ModCacheFolderEntry& entry = folderEntries.emplace_back();
+        entry.lastWriteTime = folder.fingerprint.lastWriteTime;
+        entry.entryCount = folder.fingerprint.entryCount;
+        entry.nameHash = folder.fingerprint.nameHash;
+        std::tie(entry.pathOffset, entry.pathLength) = strings.Add(folder.dir);
+        entry.firstCandidate = static_cast<std::uint32_t>(fileEntries.size());
+        entry.candidateCount = static_cast<std::uint32_t>(folder.candidates.size());
+        for (const auto& record : folder.candidates) {
+            fileEntries.push_back(EncodeFile(strings, record.fileKtid, record.path, record.fileSize, record.valid));
+        }
+    }
+    header.candidateCount = static_cast<std::uint32_t>(fileEntries.size());
+    for (const ModOverride& winner : winners) {
+        fileEntries.push_back(EncodeFile(strings, winner.fileKtid, winner.path, winner.fileSize, winner.valid));
+    }
+    header.winnerCount = static_cast<std::uint32_t>(winners.size());
+
+    std::vector<ModCacheConflictEntry> conflictEntries;
+    conflictEntries.reserve(conflicts.size());
+    for (const ModOverrideConflict& conflict : conflicts) {
+        ModCacheConflictEntry& entry = conflictEntries.emplace_back();
+        entry.fileKtid = conflict.fileKtid;
+        std::tie(entry.keptOffset, entry.keptLength) = strings.Add(conflict.kept);
+        std::tie(entry.skippedOffset, entry.skippedLength) = strings.Add(conflict.skipped);
+    }
+    header.folderCount = static_cast<std::uint32_t>(folderEntries.size());
+    header.conflictCount = static_cast<std::uint32_t>(conflictEntries.size());
+    header.stringBytes = static_cast<std::uint32_t>(strings.Blob().size());
+
+    std::vector<std::byte> image;
+    image.reserve(sizeof(header) + folderEntries.size() * sizeof(ModCacheFolderEntry) +
+                  fileEntries.size() * sizeof(ModCacheFileEntry) +
+                  conflictEntries.size() * sizeof(ModCacheConflictEntry) + strings.Blob().size());
+    AppendPod(image, header);
+    for (const auto& entry : folderEntries) {
+        AppendPod(image, entry);
+    }
+    for (const auto& entry : fileEntries) {
+        AppendPod(image, entry);
+    }
+    for (const auto& entry : conflictEntries) {
+        AppendPod(image, entry);
+    }
+    const auto* blob = reinterpret_cast<const std::byte*>(strings.Blob().data());
+    image.insert(image.end(), blob, blob + strings.Blob().size());
+
+    // Write beside the target and swap it in, so a crash never leaves a torn cache behind.
+    fs::path tempPath = path;
+    tempPath += ".tmp";
+    try {
+        if (!path.parent_path().empty()) {
+            fs::create_directories(path.parent_path());
+        }
+        {
+            binary_io::file_ostream out(tempPath, binary_io::write_mode::truncate);
+            out.write_bytes(image);
+            out.flush();
+        }
+        fs::rename(tempPath, path);
+    } catch (const std::exception& ex) {
+        std::error_code ec;
+        fs::remove(tempPath, ec);
+        SetError(error, std::string("Failed to write mod override cache: ") + ex.what());
+        return false;
+    }
+    return true;
+}
+
+std::string_view ModOverrideCache::String(std::uint32_t offset, std::uint32_t length) const {
+    return {strings_ + offset, length};
+}
+
+ModOverrideIndex::Record ModOverrideCache::DecodeFile(const ModCacheFileEntry& entry) const {
+    ModOverrideIndex::Record record{};
+    record.fileKtid = entry.fileKtid;
+    record.path = FromCachePath(String(entry.pathOffset, entry.pathLength));
+    record.fileSize = entry.fileSize;
+    record.valid = entry.valid != 0;
+    record.verifySizeOnOpen = true;
+    return record;
+}
+
+std::string_view ModOverrideCache::ModsDir() const {
+    return String(0, header_->modsDirLength);
+}
+
+std::size_t ModOverrideCache::FolderCount() const {
+    return header_->folderCount;
+}
+
+std::string_view ModOverrideCache::FolderPath(std::size_t index) const {
+    return String(folders_[index].pathOffset, folders_[index].pathLength);
+}
+
+ModFolderFingerprint ModOverrideCache::FolderFingerprint(std::size_t index) const {
+    return {folders_[index].lastWriteTime, folders_[index].entryCount, folders_[index].nameHash};
+}
+
+std::vector<ModOverrideIndex::Record> ModOverrideCache::FolderCandidates(std::size_t index) const {
+    const auto& folder = folders_[index];
+    std::vector<ModOverrideIndex::Record> records;
+    records.reserve(folder.candidateCount);
+    for (std::uint32_t i = 0; i < folder.candidateCount; ++i) {
+        records.push_back(DecodeFile(candidates_[folder.firstCandidate + i]));
+    }
+    return records;
+}
+
+std::vector<ModOverrideIndex::Record> ModOverrideCache::Winners() const {
+    std::vector<ModOverrideIndex::Record> records;
+    records.reserve(header_->winnerCount);
+    for (std::uint32_t i = 0; i < header_->winnerCount; ++i) {
+        records.push_back(DecodeFile(winners_[i]));
+    }
+    return records;
+}
+
+std::vector<ModOverrideConflict> ModOverrideCache::Conflicts() const {
+    std::vector<ModOverrideConflict> conflicts;
+    conflicts.reserve(header_->conflictCount);
+    for (std::uint32_t i = 0; i < header_->conflictCount; ++i) {
+        const auto& entry = conflicts_[i];
+        conflicts.push_back({entry.fileKtid, FromCachePath(String(entry.keptOffset, entry.keptLength)),
+                             FromCachePath(String(entry.skippedOffset, entry.skippedLength))});
+    }
+    return conflicts;
+}
+
+}  // namespace LooseFileLoader
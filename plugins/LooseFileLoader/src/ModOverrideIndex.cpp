@@ -0,0 +1,161 @@
+#include "ModOverrideIndex.h"
+#include "ParallelUtils.h"
+
+#include "binary_io/binary_io.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace LooseFileLoader {
+namespace {
+
+// Filter bits per override; about 1/16 of misses reach the table once the filter is full size.
+constexpr std::size_t kFilterBitsPerOverride = 16;
+constexpr std::size_t kMinFilterBits = 4096;
+constexpr std::size_t kMaxFilterBits = std::size_t{1} << 22;
+
+// False unless the file still has exactly out.size() bytes and all of them were read.
+bool ReadWholeFile(const std::filesystem::path& path, std::span<std::byte> out) {
+    std::error_code ec;
+    const std::uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec || size != out.size()) {
+        return false;
+    }
+    try {
+        binary_io::file_istream stream(path);
+        stream.read_bytes(out);
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+// Case-insensitive; expected is lower-case.
+bool ExtensionEquals(const std::filesystem::path& extension, std::string_view expected) {
+    const auto& native = extension.native();
+    return native.size() == expected.size() &&
+           std::equal(native.begin(), native.end(), expected.begin(), [](auto ch, char want) {
+               return (ch >= 'A' && ch <= 'Z' ? ch + ('a' - 'A') : ch) == want;
+           });
+}
+
+}  // namespace
+
+bool IsCompressedOverridePath(const std::filesystem::path& path) {
+    const std::filesystem::path extension = path.extension();
+    return ExtensionEquals(extension, ".gz") || ExtensionEquals(extension, ".zlib");
+}
+
+bool IsDeltaOverridePath(const std::filesystem::path& path) {
+    return ExtensionEquals(path.extension(), ".delta");
+}
+
+ModOverrideIndex ModOverrideIndex::Build(std::vector<Record> records, std::vector<ModOverrideConflict>* conflicts) {
+    // Sorting by fileKtid keeps precedence order within a key, so the winner is the first of a run.
+    std::stable_sort(records.begin(), records.end(),
+                     [](const Record& lhs, const Record& rhs) { return lhs.fileKtid < rhs.fileKtid; });
+
+    ModOverrideIndex index;
+    std::vector<std::uint32_t> keys;
+    keys.reserve(records.size());
+    index.overrides_.reserve(records.size());
+    for (Record& record : records) {
+        if (!index.overrides_.empty() && index.overrides_.back().fileKtid == record.fileKtid) {
+            if (conflicts != nullptr) {
+                conflicts->push_back({record.fileKtid, index.overrides_.back().path, std::move(record.path)});
+            }
+            continue;
+        }
+
+        ModOverride& entry = index.overrides_.emplace_back();
+        entry.displayPath = record.path.generic_string();
+        entry.path = std::move(record.path);
+        entry.fileSize = record.fileSize;
+        entry.fileKtid = record.fileKtid;
+        entry.valid = record.valid;
+        entry.verifySizeOnOpen = record.verifySizeOnOpen;
+        entry.compressed = IsCompressedOverridePath(entry.path);
+        entry.delta = IsDeltaOverridePath(entry.path);
+        keys.push_back(record.fileKtid);
+    }
+    index.keys_ = AssetIdTable::Build(keys);
+
+    const std::size_t filterBits =
+        std::clamp(std::bit_ceil(keys.size() * kFilterBitsPerOverride), kMinFilterBits, kMaxFilterBits);
+    index.filter_.assign(filterBits / 64, 0);
+    index.filterMask_ = static_cast<std::uint32_t>(filterBits - 1);
+    for (const std::uint32_t key : keys) {
+        const std::uint32_t bit = key & index.filterMask_;
+        index.filter_[bit >> 6] |= std::uint64_t{1} << (bit & 63);
+    }
+    return index;
+}
+
+ModPreloadStats ModOverrideIndex::Preload(std::uint64_t budgetBytes, std::uint64_t maxFileBytes,
+                                          std::size_t threadCount) {
+    ModPreloadStats stats;
+    if (preloadArena_ != nullptr || budgetBytes == 0) {
+        return stats;
+    }
+
+    // Smallest first: per-file open/close is what preloading saves, so the budget buys the most
+    // files that way. The stable sort keeps the choice deterministic among equal sizes.
+    std::vector<ModOverride*> selected;
+    for (ModOverride& entry : overrides_) {
+        if (entry.valid && !entry.compressed && !entry.delta && entry.fileSize <= maxFileBytes) {
+            selected.push_back(&entry);
+        }
+    }
+    std::stable_sort(selected.begin(), selected.end(),
+                     [](const ModOverride* lhs, const ModOverride* rhs) { return lhs->fileSize < rhs->fileSize; });
+    std::vector<std::uint64_t> offsets;
+    std::uint64_t total = 0;
+    for (const ModOverride* entry : selected) {
+        if (total + entry->fileSize > budgetBytes) {
+            break;
+        }
+        offsets.push_back(total);
+        total += entry->fileSize;
+    }
+    selected.resize(offsets.size());
+    if (selected.empty()) {
+        return stats;
+    }
+
+    preloadArena_ = std::make_unique_for_overwrite<std::byte[]>(static_cast<std::size_t>(total));
+    preloadBytes_ = static_cast<std::size_t>(total);
+    std::vector<std::uint8_t> loaded(selected.size(), 0);
+    ParallelFor(selected.size(), ResolveThreadCount(threadCount, selected.size()), [this, &selected, &offsets, &loaded](std::size_t i) {
+        const std::span<std::byte> out(preloadArena_.get() + offsets[i], static_cast<std::size_t>(selected[i]->fileSize));
+        loaded[i] = ReadWholeFile(selected[i]->path, out) ? 1 : 0;
+    });
+
+    for (std::size_t i = 0; i < selected.size(); ++i) {
+        ModOverride& entry = *selected[i];
+        if (loaded[i] == 0) {
+            ++stats.failedCount;
+            continue;
+        }
+        entry.preloaded = true;
+        entry.preloadedData = {preloadArena_.get() + offsets[i], static_cast<std::size_t>(entry.fileSize)};
+        // The size was just checked against the file that was read.
+        entry.verifySizeOnOpen = false;
+        ++stats.fileCount;
+        stats.bytes += entry.fileSize;
+    }
+    return stats;
+}
+
+std::size_t ModOverrideIndex::MemoryBytes() const {
+    std::size_t bytes = keys_.MemoryBytes() + filter_.size() * sizeof(std::uint64_t) +
+                        overrides_.capacity() * sizeof(ModOverride) + preloadBytes_;
+    for (const ModOverride& entry : overrides_) {
+        bytes += entry.displayPath.capacity() + entry.path.native().capacity() * sizeof(std::filesystem::path::value_type);
+    }
+    return bytes;
+}
+
+}  // namespace LooseFileLoader
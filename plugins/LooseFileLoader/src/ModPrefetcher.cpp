@@ -0,0 +1,379 @@
+#include "ModPrefetcher.h"
+#include "ModAccessProfile.h"
+#include "ModAssetManager.h"
+
+#include <LogUtils.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace LooseFileLoader {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// A load sequence is over once no new override was hit for this long; the profile is saved then.
+constexpr std::chrono::seconds kSaveDelay{5};
+constexpr std::size_t kWarmBufferBytes = 256 * 1024;
+// Hits the hook can queue before the thread drains them; further hits are dropped and counted.
+constexpr std::size_t kHitRingCapacity = 8192;
+static_assert((kHitRingCapacity & (kHitRingCapacity - 1)) == 0);
+
+void SetError(std::string* error, std::string_view message) {
+    if (error != nullptr) {
+        *error = std::string(message);
+    }
+}
+
+// Reads the whole file and drops the data, leaving it in the OS file cache. Returns the bytes read.
+std::uint64_t WarmFile(const fs::path& path, std::vector<std::byte>& buffer) {
+    std::uint64_t total = 0;
+#ifdef _WIN32
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                    nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return 0;
+    }
+    DWORD bytesRead = 0;
+    while (ReadFile(file, buffer.data(), static_cast<DWORD>(buffer.size()), &bytesRead, nullptr) && bytesRead != 0) {
+        total += bytesRead;
+    }
+    CloseHandle(file);
+#else
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return 0;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    ssize_t bytesRead = 0;
+    while ((bytesRead = read(fd, buffer.data(), buffer.size())) > 0) {
+        total += static_cast<std::uint64_t>(bytesRead);
+    }
+    close(fd);
+#endif
+    return total;
+}
+
+// Bounded multi-producer, single-consumer queue of hit fileKtids, allocated once. A slot holds
+// (sequence << 32 | fileKtid), the sequence being its write index + 1, so the consumer can tell a
+// written slot from one that is only reserved.
+class HitRing {
+public:
+    HitRing() : slots_(std::make_unique<std::atomic<std::uint64_t>[]>(kHitRingCapacity)) {}
+
+    // Consumer side only, with no producers running.
+    void Reset() {
+        for (std::size_t i = 0; i < kHitRingCapacity; ++i) {
+            slots_[i].store(0, std::memory_order_relaxed);
+        }
+        readIndex_.store(0, std::memory_order_relaxed);
+        writeIndex_.store(0, std::memory_order_release);
+    }
+
+    // Lock-free and allocation-free; false when the ring is full.
+    bool Push(std::uint32_t fileKtid) {
+        // The seq_cst reservation pairs with the thread's store to `sleeping` before it checks
+        // HasPending(): either the thread sees this hit or the hook sees it sleeping.
+        std::uint64_t index = writeIndex_.load(std::memory_order_relaxed);
+        do {
+            if (index - readIndex_.load(std::memory_order_acquire) >= kHitRingCapacity) {
+                return false;
+            }
+        } while (!writeIndex_.compare_exchange_weak(index, index + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed));
+        slots_[index & (kHitRingCapacity - 1)].store(Slot(index, fileKtid), std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] bool HasPending() const {
+        return writeIndex_.load(std::memory_order_seq_cst) != readIndex_.load(std::memory_order_relaxed);
+    }
+
+    // Consumer side: hands every written hit to onHit in push order. Stops at a slot that is
+    // reserved but not written yet; HasPending() then stays true until the producer finishes.
+    template <class OnHit>
+    void Drain(OnHit&& onHit) {
+        std::uint64_t index = readIndex_.load(std::memory_order_relaxed);
+        const std::uint64_t end = writeIndex_.load(std::memory_order_acquire);
+        for (; index != end; ++index) {
+            const std::uint64_t slot = slots_[index & (kHitRingCapacity - 1)].load(std::memory_order_acquire);
+            if ((slot >> 32) != Slot(index, 0) >> 32) {
+                break;
+            }
+            onHit(static_cast<std::uint32_t>(slot));
+        }
+        readIndex_.store(index, std::memory_order_release);
+    }
+
+private:
+    [[nodiscard]] static std::uint64_t Slot(std::uint64_t index, std::uint32_t fileKtid) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(index + 1)) << 32) | fileKtid;
+    }
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots_;
+    std::atomic<std::uint64_t> readIndex_{0};
+    std::atomic<std::uint64_t> writeIndex_{0};
+};
+
+}  // namespace
+
+struct ModPrefetcher::State {
+    std::mutex mutex{};
+    std::condition_variable wake{};
+    // Checked first by the hook, so a disabled prefetcher costs it one relaxed load.
+    std::atomic<bool> running{false};
+    bool stopping = false;
+    std::thread thread{};
+
+    // Filled by the hook without the mutex; everything below it belongs to the thread (and to
+    // Start/Stop while it is not running) and is guarded by the mutex.
+    HitRing hits{};
+    // Set by the thread, under the mutex, right before it sleeps. A hook that clears it takes the
+    // mutex once before notifying, so the wakeup cannot land between the thread's check and its wait.
+    std::atomic<bool> sleeping{false};
+    std::atomic<std::size_t> droppedHitCount{0};
+
+    const ModAssetManager* overrides = nullptr;
+    fs::path profilePath{};
+    std::size_t lookahead = 0;
+    // Order from earlier sessions; this session's order only takes effect on the next launch.
+    ModAccessProfile profile{};
+    // Per profile position: already read ahead, or already loaded by the game.
+    std::vector<std::uint8_t> warmed{};
+    std::size_t windowBegin = 0;
+    std::size_t windowEnd = 0;
+
+    std::vector<std::uint32_t> session{};
+    std::unordered_set<std::uint32_t> seen{};
+    bool dirty = false;
+    Clock::time_point lastNewHit{};
+
+    std::size_t hitCount = 0;
+    // First hits on an override the thread had already read ahead.
+    std::size_t warmHitCount = 0;
+    std::size_t warmedFiles = 0;
+    std::uint64_t warmedBytes = 0;
+
+    [[nodiscard]] std::size_t NextToWarm() const {
+        const std::size_t end = std::min(windowEnd, warmed.size());
+        for (std::size_t i = windowBegin; i < end; ++i) {
+            if (warmed[i] == 0) {
+                return i;
+            }
+        }
+        return ModAccessProfile::kNotFound;
+    }
+
+    // Only the path is copied under the snapshot guard, so a hot reload is not held up by the read.
+    [[nodiscard]] std::uint64_t WarmOverride(std::uint32_t fileKtid, std::vector<std::byte>& buffer) const {
+        fs::path path;
+        {
+            const auto index = overrides->Acquire();
+            const ModOverride* modOverride = index->Find(fileKtid);
+            if (modOverride == nullptr || !modOverride->valid || modOverride->preloaded) {
+                return 0;
+            }
+            path = modOverride->path;
+        }
+        return WarmFile(path, buffer);
+    }
+
+    // Applies one hit from the ring: records a first hit and moves the read-ahead window past it.
+    void ApplyHit(std::uint32_t fileKtid) {
+        ++hitCount;
+        const bool firstHit = seen.insert(fileKtid).second;
+        if (firstHit) {
+            session.push_back(fileKtid);
+            dirty = true;
+            lastNewHit = Clock::now();
+        }
+        const std::size_t position = profile.Position(fileKtid);
+        if (position != ModAccessProfile::kNotFound) {
+            if (firstHit) {
+                warmHitCount += warmed[position];
+            }
+            warmed[position] = 1;
+            windowBegin = position + 1;
+            windowEnd = position + 1 + lookahead;
+        }
+    }
+
+    void DrainHits() {
+        hits.Drain([this](std::uint32_t fileKtid) { ApplyHit(fileKtid); });
+    }
+
+    void SaveProfile(std::unique_lock<std::mutex>& lock) {
+        const ModAccessProfile merged = ModAccessProfile::Merge(session, profile);
+        const std::size_t hits = hitCount;
+        const std::size_t warmHits = warmHitCount;
+        const std::size_t files = warmedFiles;
+        const std::uint64_t bytes = warmedBytes;
+        dirty = false;
+        lock.unlock();
+        std::string error;
+        if (merged.Save(profilePath, &error)) {
+            _MESSAGE("Mod prefetch profile saved: entries=%zu | hits=%zu, warm hits=%zu, warmed=%zu files, %llu bytes",
+                     merged.Size(), hits, warmHits, files, static_cast<unsigned long long>(bytes));
+        } else {
+            _MESSAGE("%s", error.c_str());
+        }
+        lock.lock();
+    }
+
+    void Run() {
+        std::vector<std::byte> buffer(kWarmBufferBytes);
+        std::unique_lock lock(mutex);
+        while (!stopping) {
+            DrainHits();
+            const std::size_t next = NextToWarm();
+            if (next != ModAccessProfile::kNotFound) {
+                warmed[next] = 1;
+                const std::uint32_t fileKtid = profile.Order()[next];
+                lock.unlock();
+                const std::uint64_t bytes = WarmOverride(fileKtid, buffer);
+                lock.lock();
+                if (bytes != 0) {
+                    ++warmedFiles;
+                    warmedBytes += bytes;
+                }
+                continue;
+            }
+            const auto saveAt = lastNewHit + kSaveDelay;
+            if (dirty && Clock::now() >= saveAt) {
+                SaveProfile(lock);
+                continue;
+            }
+            sleeping.store(true);
+            if (hits.HasPending()) {
+                sleeping.store(false);
+                if (hits.HasPending()) {
+                    // A hook reserved a slot and is still writing it.
+                    lock.unlock();
+                    std::this_thread::yield();
+                    lock.lock();
+                }
+                continue;
+            }
+            if (dirty) {
+                wake.wait_until(lock, saveAt);
+            } else {
+                wake.wait(lock);
+            }
+            sleeping.store(false);
+        }
+    }
+};
+
+ModPrefetcher::ModPrefetcher() : state_(std::make_unique<State>()) {}
+
+ModPrefetcher::~ModPrefetcher() {
+    Stop();
+}
+
+bool ModPrefetcher::Start(const ModAssetManager& overrides, const fs::path& profilePath, std::size_t lookahead,
+                          std::string* error) {
+    Stop();
+    if (lookahead == 0) {
+        SetError(error, "Prefetch lookahead must be at least 1.");
+        return false;
+    }
+
+    ModAccessProfile profile;
+    if (fs::exists(profilePath)) {
+        std::string loadError;
+        if (auto loaded = ModAccessProfile::Load(profilePath, &loadError)) {
+            profile = std::move(*loaded);
+        } else {
+            _MESSAGE("Ignoring mod access profile: %s", loadError.c_str());
+        }
+    }
+
+    State& state = *state_;
+    std::lock_guard lock(state.mutex);
+    state.hits.Reset();
+    state.sleeping = false;
+    state.droppedHitCount = 0;
+    state.overrides = &overrides;
+    state.profilePath = profilePath;
+    state.lookahead = lookahead;
+    state.warmed.assign(profile.Size(), 0);
+    state.profile = std::move(profile);
+    // The first overrides of the previous session are the likeliest first hits of this one.
+    state.windowBegin = 0;
+    state.windowEnd = lookahead;
+    state.session.clear();
+    state.seen.clear();
+    state.dirty = false;
+    state.hitCount = 0;
+    state.warmHitCount = 0;
+    state.warmedFiles = 0;
+    state.warmedBytes = 0;
+    state.stopping = false;
+    state.running.store(true, std::memory_order_release);
+    state.thread = std::thread([&state]() { state.Run(); });
+    _MESSAGE("Mod prefetch started: profile=%zu entries, lookahead=%zu", state.profile.Size(), lookahead);
+    return true;
+}
+
+void ModPrefetcher::Stop() {
+    State& state = *state_;
+    {
+        std::lock_guard lock(state.mutex);
+        if (!state.running.exchange(false)) {
+            return;
+        }
+        state.stopping = true;
+    }
+    state.wake.notify_all();
+    if (state.thread.joinable()) {
+        state.thread.join();
+    }
+    std::unique_lock lock(state.mutex);
+    state.DrainHits();
+    if (const std::size_t dropped = state.droppedHitCount.load()) {
+        _MESSAGE("Mod prefetch dropped %zu hits the thread could not keep up with.", dropped);
+    }
+    if (state.dirty) {
+        state.SaveProfile(lock);
+    }
+}
+
+bool ModPrefetcher::IsRunning() const {
+    return state_->running.load(std::memory_order_acquire);
+}
+
+void ModPrefetcher::OnOverrideHit(std::uint32_t fileKtid) {
+    State& state = *state_;
+    if (!state.running.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (!state.hits.Push(fileKtid)) {
+        state.droppedHitCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // Only the first hit after the thread went idle pays for the wakeup.
+    if (state.sleeping.load() && state.sleeping.exchange(false)) {
+        { std::lock_guard lock(state.mutex); }
+        state.wake.notify_one();
+    }
+}
+
+}  // namespace LooseFileLoader
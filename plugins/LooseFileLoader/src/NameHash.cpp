@@ -0,0 +1,480 @@
+#include "NameHash.h"
+#include "ParallelUtils.h"
+#include "RdbTool.h"
+
+#include "binary_io/binary_io.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace LooseFileLoader {
+namespace {
+
+constexpr std::array<char, 4> kNameTableMagic{'L', 'F', 'N', 'H'};
+constexpr std::uint32_t kNameTableVersion = 1;
+// Average keys per displacement bucket, and how many seeds a bucket may try before the
+// slot table is grown and the build restarts.
+constexpr std::size_t kKeysPerBucket = 4;
+constexpr std::uint32_t kMaxDisplacement = 1u << 16;
+// Words per recovery task.
+constexpr std::size_t kWordsPerChunk = 1024;
+// Low hash bits used by the recovery prefilter bitmap.
+constexpr std::uint32_t kFilterBits = 20;
+
+void SetError(std::string* error, std::string_view message) {
+    if (error != nullptr) {
+        *error = std::string(message);
+    }
+}
+
+// murmur3 finalizer; bijective, so distinct keys never collide before the modulo.
+[[nodiscard]] std::uint32_t Mix(std::uint32_t key, std::uint32_t seed) {
+    std::uint32_t h = key ^ (seed * 0x9E3779B9u);
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+[[nodiscard]] std::string_view Trim(std::string_view text) {
+    constexpr std::string_view kSpace = " \t\r\n";
+    const std::size_t begin = text.find_first_not_of(kSpace);
+    if (begin == std::string_view::npos) {
+        return {};
+    }
+    const std::size_t end = text.find_last_not_of(kSpace);
+    return text.substr(begin, end - begin + 1);
+}
+
+[[nodiscard]] bool ParseHash(std::string_view text, std::uint32_t* outHash) {
+    text = Trim(text);
+    if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        text.remove_prefix(2);
+    }
+    if (text.empty()) {
+        return false;
+    }
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), *outHash, 16);
+    return result.ec == std::errc{} && result.ptr == text.data() + text.size();
+}
+
+template <class LineFn>
+bool ForEachLine(const fs::path& path, std::string* error, LineFn&& onLine) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        SetError(error, "Failed to open file: " + path.string());
+        return false;
+    }
+    std::string line;
+    bool first = true;
+    while (std::getline(in, line)) {
+        std::string_view view = line;
+        // Files written by the Python tooling may carry a UTF-8 BOM.
+        if (first && view.starts_with("\xEF\xBB\xBF")) {
+            view.remove_prefix(3);
+        }
+        first = false;
+        onLine(Trim(view));
+    }
+    return true;
+}
+
+void AppendU32(std::vector<std::byte>& out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<std::byte>((value >> (i * 8)) & 0xFFu));
+    }
+}
+
+// Bit-per-bucket prefilter over the low hash bits, then a binary search to confirm.
+class TargetSet final {
+public:
+    explicit TargetSet(std::span<const std::uint32_t> targets)
+        : sorted_(targets.begin(), targets.end()), filter_((std::size_t{1} << kFilterBits) / 64) {
+        std::sort(sorted_.begin(), sorted_.end());
+        sorted_.erase(std::unique(sorted_.begin(), sorted_.end()), sorted_.end());
+        for (const std::uint32_t hash : sorted_) {
+            const std::uint32_t bit = hash & ((1u << kFilterBits) - 1);
+            filter_[bit >> 6] |= std::uint64_t{1} << (bit & 63);
+        }
+    }
+
+    [[nodiscard]] bool Empty() const {
+        return sorted_.empty();
+    }
+
+    [[nodiscard]] bool Contains(std::uint32_t hash) const {
+        const std::uint32_t bit = hash & ((1u << kFilterBits) - 1);
+        if ((filter_[bit >> 6] & (std::uint64_t{1} << (bit & 63))) == 0) {
+            return false;
+        }
+        return std::binary_search(sorted_.begin(), sorted_.end(), hash);
+    }
+
+private:
+    std::vector<std::uint32_t> sorted_;
+    std::vector<std::uint64_t> filter_;
+};
+
+struct NamePart {
+    std::string_view text;
+    std::uint32_t hash = 0;
+    std::uint32_t power = 1;  // 31^text.size()
+};
+
+[[nodiscard]] std::vector<NamePart> MakeParts(std::span<const std::string> texts, bool includeEmpty) {
+    std::vector<NamePart> parts;
+    parts.reserve(texts.size() + 1);
+    if (includeEmpty) {
+        parts.push_back({});
+    }
+    for (const std::string& text : texts) {
+        if (!text.empty()) {
+            parts.push_back({text, HashName(text), HashNamePower(text.size())});
+        }
+    }
+    return parts;
+}
+
+}  // namespace
+
+void NameDictionaryBuilder::Add(std::uint32_t hash, std::string_view name) {
+    if (!name.empty()) {
+        names_.try_emplace(hash, name);
+    }
+}
+
+void NameDictionaryBuilder::AddName(std::string_view name) {
+    Add(HashName(name), name);
+}
+
+bool NameDictionaryBuilder::LoadCsv(const fs::path& path, std::string* error) {
+    return ForEachLine(path, error, [this](std::string_view line) {
+        const std::size_t comma = line.find(',');
+        std::uint32_t hash = 0;
+        if (comma == std::string_view::npos || !ParseHash(line.substr(0, comma), &hash)) {
+            return;
+        }
+        Add(hash, Trim(line.substr(comma + 1)));
+    });
+}
+
+bool NameDictionaryBuilder::LoadWordlist(const fs::path& path, std::string* error) {
+    return ForEachLine(path, error, [this](std::string_view line) {
+        if (!line.empty() && line.front() != '#') {
+            AddName(line);
+        }
+    });
+}
+
+std::size_t NameDictionaryBuilder::Size() const {
+    return names_.size();
+}
+
+std::vector<std::byte> NameDictionaryBuilder::Build() const {
+    std::vector<std::pair<std::uint32_t, const std::string*>> keys;
+    keys.reserve(names_.size());
+    for (const auto& [hash, name] : names_) {
+        keys.emplace_back(hash, &name);
+    }
+    // Deterministic output regardless of unordered_map iteration order.
+    std::sort(keys.begin(), keys.end());
+
+    const std::uint32_t entryCount = static_cast<std::uint32_t>(keys.size());
+    const std::uint32_t bucketCount = static_cast<std::uint32_t>(std::max<std::size_t>(1, keys.size() / kKeysPerBucket));
+    std::uint32_t slotCount = std::max<std::uint32_t>(1, entryCount + entryCount / 4);
+
+    std::vector<std::vector<std::uint32_t>> buckets(bucketCount);
+    for (std::uint32_t i = 0; i < entryCount; ++i) {
+        buckets[Mix(keys[i].first, 0) % bucketCount].push_back(i);
+    }
+    std::vector<std::uint32_t> bucketOrder(bucketCount);
+    std::iota(bucketOrder.begin(), bucketOrder.end(), 0u);
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&](std::uint32_t lhs, std::uint32_t rhs) {
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    std::vector<std::uint32_t> displacements(bucketCount, 0);
+    std::vector<std::uint32_t> slotKey;
+    std::vector<std::uint32_t> candidate;
+    for (;;) {
+        slotKey.assign(slotCount, kEmptyNameSlot);
+        bool placedAll = true;
+        for (const std::uint32_t bucket : bucketOrder) {
+            const auto& members = buckets[bucket];
+            if (members.empty()) {
+                break;
+            }
+            bool placed = false;
+            for (std::uint32_t seed = 1; seed < kMaxDisplacement && !placed; ++seed) {
+                candidate.clear();
+                placed = true;
+                for (const std::uint32_t key : members) {
+                    const std::uint32_t slot = Mix(keys[key].first, seed) % slotCount;
+                    if (slotKey[slot] != kEmptyNameSlot ||
+                        std::find(candidate.begin(), candidate.end(), slot) != candidate.end()) {
+                        placed = false;
+                        break;
+                    }
+                    candidate.push_back(slot);
+                }
+                if (placed) {
+                    for (std::size_t i = 0; i < members.size(); ++i) {
+                        slotKey[candidate[i]] = members[i];
+                    }
+                    displacements[bucket] = seed;
+                }
+            }
+            if (!placed) {
+                placedAll = false;
+                break;
+            }
+        }
+        if (placedAll) {
+            break;
+        }
+        slotCount += slotCount / 8 + 1;
+    }
+
+    std::vector<NameTableSlot> slots(slotCount, NameTableSlot{0, kEmptyNameSlot, 0});
+    std::string strings;
+    for (std::uint32_t slot = 0; slot < slotCount; ++slot) {
+        if (slotKey[slot] == kEmptyNameSlot) {
+            continue;
+        }
+        const auto& [hash, name] = keys[slotKey[slot]];
+        slots[slot] = {hash, static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(name->size())};
+        strings.append(*name);
+        strings.push_back('\0');
+    }
+
+    std::vector<std::byte> image;
+    image.reserve(sizeof(NameTableHeader) + displacements.size() * 4 + slots.size() * sizeof(NameTableSlot) +
+                  strings.size());
+    for (const char ch : kNameTableMagic) {
+        image.push_back(static_cast<std::byte>(ch));
+    }
+    AppendU32(image, kNameTableVersion);
+    AppendU32(image, entryCount);
+    AppendU32(image, bucketCount);
+    AppendU32(image, slotCount);
+    AppendU32(image, static_cast<std::uint32_t>(strings.size()));
+    for (const std::uint32_t displacement : displacements) {
+        AppendU32(image, displacement);
+    }
+    for (const NameTableSlot& slot : slots) {
+        AppendU32(image, slot.hash);
+        AppendU32(image, slot.nameOffset);
+        AppendU32(image, slot.nameLength);
+    }
+    const auto blob = std::as_bytes(std::span(strings.data(), strings.size()));
+    image.insert(image.end(), blob.begin(), blob.end());
+    return image;
+}
+
+bool NameDictionaryBuilder::Save(const fs::path& path, std::string* error) const {
+    const std::vector<std::byte> image = Build();
+    try {
+        if (!path.parent_path().empty()) {
+            fs::create_directories(path.parent_path());
+        }
+        binary_io::file_ostream out(path, binary_io::write_mode::truncate);
+        out.write_bytes(image);
+        out.flush();
+    } catch (const std::exception& ex) {
+        SetError(error, std::string("Failed to write name table: ") + ex.what());
+        return false;
+    }
+    return true;
+}
+
+std::optional<NameDictionary> NameDictionary::Load(const fs::path& path, std::string* error) {
+    auto mapping = MappedFile::Open(path, error);
+    if (!mapping.has_value()) {
+        return std::nullopt;
+    }
+
+    const auto bytes = mapping->Bytes();
+    if (bytes.size() >= kNameTableMagic.size() &&
+        std::memcmp(bytes.data(), kNameTableMagic.data(), kNameTableMagic.size()) == 0) {
+        NameDictionary dictionary;
+        if (!dictionary.Attach(bytes, error)) {
+            return std::nullopt;
+        }
+        dictionary.mapping_ = std::move(mapping);
+        return dictionary;
+    }
+
+    mapping.reset();
+    NameDictionaryBuilder builder;
+    if (!builder.LoadCsv(path, error)) {
+        return std::nullopt;
+    }
+    return FromImage(builder.Build(), error);
+}
+
+std::optional<NameDictionary> NameDictionary::FromImage(std::vector<std::byte> image, std::string* error) {
+    NameDictionary dictionary;
+    dictionary.ownedImage_ = std::move(image);
+    if (!dictionary.Attach(dictionary.ownedImage_, error)) {
+        return std::nullopt;
+    }
+    return dictionary;
+}
+
+bool NameDictionary::Attach(std::span<const std::byte> image, std::string* error) {
+    if (image.size() < sizeof(NameTableHeader)) {
+        SetError(error, "Name table is too small.");
+        return false;
+    }
+    // Mapped views and vector storage are at least 4-byte aligned, and every section size is a
+    // multiple of 4, so the tables below can be read in place.
+    const auto* header = reinterpret_cast<const NameTableHeader*>(image.data());
+    if (std::memcmp(header->magic, kNameTableMagic.data(), kNameTableMagic.size()) != 0 ||
+        header->version != kNameTableVersion) {
+        SetError(error, "Unsupported name table format.");
+        return false;
+    }
+    if (header->bucketCount == 0 || header->slotCount == 0) {
+        SetError(error, "Name table has no slots.");
+        return false;
+    }
+
+    const std::uint64_t displacementBytes = std::uint64_t{header->bucketCount} * 4;
+    const std::uint64_t slotBytes = std::uint64_t{header->slotCount} * sizeof(NameTableSlot);
+    const std::uint64_t expected = sizeof(NameTableHeader) + displacementBytes + slotBytes + header->stringBytes;
+    if (expected != image.size()) {
+        SetError(error, "Name table size mismatch.");
+        return false;
+    }
+
+    const std::byte* cursor = image.data() + sizeof(NameTableHeader);
+    const auto* displacements = reinterpret_cast<const std::uint32_t*>(cursor);
+    cursor += displacementBytes;
+    const auto* slots = reinterpret_cast<const NameTableSlot*>(cursor);
+    cursor += slotBytes;
+    const auto* strings = reinterpret_cast<const char*>(cursor);
+
+    for (std::uint32_t i = 0; i < header->slotCount; ++i) {
+        const NameTableSlot& slot = slots[i];
+        if (slot.nameOffset == kEmptyNameSlot) {
+            continue;
+        }
+        if (std::uint64_t{slot.nameOffset} + slot.nameLength >= header->stringBytes ||
+            strings[slot.nameOffset + slot.nameLength] != '\0') {
+            SetError(error, "Name table string reference is out of range.");
+            return false;
+        }
+    }
+
+    header_ = header;
+    displacements_ = displacements;
+    slots_ = slots;
+    strings_ = strings;
+    return true;
+}
+
+std::string_view NameDictionary::Find(std::uint32_t hash) const {
+    if (header_ == nullptr) {
+        return {};
+    }
+    const std::uint32_t bucket = Mix(hash, 0) % header_->bucketCount;
+    const NameTableSlot& slot = slots_[Mix(hash, displacements_[bucket]) % header_->slotCount];
+    if (slot.nameOffset == kEmptyNameSlot || slot.hash != hash) {
+        return {};
+    }
+    return {strings_ + slot.nameOffset, slot.nameLength};
+}
+
+bool NameDictionary::Contains(std::uint32_t hash) const {
+    return !Find(hash).empty();
+}
+
+std::size_t NameDictionary::Size() const {
+    return header_ != nullptr ? header_->entryCount : 0;
+}
+
+bool LoadWordlist(const fs::path& path, std::vector<std::string>* outWords, std::string* error) {
+    outWords->clear();
+    return ForEachLine(path, error, [outWords](std::string_view line) {
+        if (!line.empty() && line.front() != '#') {
+            outWords->emplace_back(line);
+        }
+    });
+}
+
+std::vector<std::uint32_t> CollectUnknownKtids(std::span<const RdbEntry> entries, const NameDictionary* known) {
+    std::vector<std::uint32_t> unknown;
+    unknown.reserve(entries.size() * 2);
+    for (const RdbEntry& entry : entries) {
+        for (const std::uint32_t ktid : {entry.fileKtid, entry.typeInfoKtid}) {
+            if (known == nullptr || !known->Contains(ktid)) {
+                unknown.push_back(ktid);
+            }
+        }
+    }
+    std::sort(unknown.begin(), unknown.end());
+    unknown.erase(std::unique(unknown.begin(), unknown.end()), unknown.end());
+    return unknown;
+}
+
+std::vector<RecoveredName> RecoverNames(std::span<const std::uint32_t> targets,
+                                        std::span<const std::string> words,
+                                        const NameRecoveryOptions& options) {
+    const TargetSet targetSet(targets);
+    if (targetSet.Empty() || words.empty()) {
+        return {};
+    }
+
+    const std::vector<NamePart> prefixes = MakeParts(options.prefixes, true);
+    const std::vector<NamePart> suffixes = MakeParts(options.suffixes, true);
+
+    const std::size_t chunkCount = (words.size() + kWordsPerChunk - 1) / kWordsPerChunk;
+    std::vector<std::vector<RecoveredName>> chunkHits(chunkCount);
+    ParallelFor(chunkCount, options.threadCount, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * kWordsPerChunk;
+        const std::size_t end = std::min(begin + kWordsPerChunk, words.size());
+        for (std::size_t w = begin; w < end; ++w) {
+            const std::string& word = words[w];
+            const std::uint32_t wordHash = HashName(word);
+            const std::uint32_t wordPower = HashNamePower(word.size());
+            for (const NamePart& prefix : prefixes) {
+                const std::uint32_t headHash = prefix.hash + prefix.power * wordHash;
+                const std::uint32_t headPower = prefix.power * wordPower;
+                for (const NamePart& suffix : suffixes) {
+                    const std::uint32_t hash = headHash + headPower * suffix.hash;
+                    if (targetSet.Contains(hash)) {
+                        std::string name;
+                        name.reserve(prefix.text.size() + word.size() + suffix.text.size());
+                        name.append(prefix.text).append(word).append(suffix.text);
+                        chunkHits[chunk].push_back({hash, std::move(name)});
+                    }
+                }
+            }
+        }
+    });
+
+    std::vector<RecoveredName> hits;
+    for (auto& chunk : chunkHits) {
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(hits));
+    }
+    std::sort(hits.begin(), hits.end(), [](const RecoveredName& lhs, const RecoveredName& rhs) {
+        return lhs.hash != rhs.hash ? lhs.hash < rhs.hash : lhs.name < rhs.name;
+    });
+    hits.erase(std::unique(hits.begin(), hits.end(),
+                           [](const RecoveredName& lhs, const RecoveredName& rhs) {
+                               return lhs.hash == rhs.hash && lhs.name == rhs.name;
+                           }),
+               hits.end());
+    return hits;
+}
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,86 @@
+#include "RcuCell.h"
+
+#include <cstdint>
+#include <thread>
+
+namespace LooseFileLoader {
+namespace {
+
+// state: 0 when idle, otherwise (epoch << 1) | 1.
+struct alignas(64) ReaderSlot {
+    std::atomic<std::uint64_t> state{0};
+    std::atomic<bool> owned{true};
+    ReaderSlot* next = nullptr;
+};
+
+// Slots are never freed, so Synchronize can walk the list without coordination.
+std::atomic<ReaderSlot*> g_slotHead{nullptr};
+std::atomic<std::uint64_t> g_epoch{1};
+
+ReaderSlot* AcquireSlot() {
+    for (ReaderSlot* slot = g_slotHead.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+        bool expected = false;
+        if (slot->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return slot;
+        }
+    }
+    auto* slot = new ReaderSlot();
+    slot->next = g_slotHead.load(std::memory_order_relaxed);
+    while (!g_slotHead.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return slot;
+}
+
+struct ThreadReader {
+    ReaderSlot* slot = nullptr;
+    std::uint32_t depth = 0;
+
+    ~ThreadReader() {
+        if (slot != nullptr) {
+            slot->state.store(0, std::memory_order_release);
+            slot->owned.store(false, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadReader t_reader;
+
+}  // namespace
+
+void RcuDomain::Enter() {
+    ThreadReader& reader = t_reader;
+    if (reader.depth++ != 0) {
+        return;
+    }
+    if (reader.slot == nullptr) {
+        reader.slot = AcquireSlot();
+    }
+    // Acquire pairs with the epoch bump, so a reader that sees the new epoch also sees the new
+    // pointer. seq_cst on the store makes the slot visible to Synchronize before the caller
+    // loads the pointer.
+    reader.slot->state.store((g_epoch.load(std::memory_order_acquire) << 1) | 1, std::memory_order_seq_cst);
+}
+
+void RcuDomain::Leave() {
+    ThreadReader& reader = t_reader;
+    if (--reader.depth == 0) {
+        reader.slot->state.store(0, std::memory_order_release);
+    }
+}
+
+void RcuDomain::Synchronize() {
+    // Readers that entered with an older epoch may hold the previous value; readers that see
+    // the new epoch entered after the caller's exchange and can only see the new one.
+    const std::uint64_t target = g_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    for (ReaderSlot* slot = g_slotHead.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+        for (;;) {
+            const std::uint64_t state = slot->state.load(std::memory_order_seq_cst);
+            if ((state & 1) == 0 || (state >> 1) >= target) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+}
+
+}  // namespace LooseFileLoader
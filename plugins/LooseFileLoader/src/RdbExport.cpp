@@ -0,0 +1,534 @@
+#include "RdbExport.h"
+#include "NameHash.h"
+#include "ParallelUtils.h"
+
+#include "binary_io/binary_io.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace LooseFileLoader {
+namespace {
+
+// Rows per formatting task, and how many tasks are formatted ahead of the writer.
+constexpr std::size_t kRowsPerChunk = 2048;
+constexpr std::size_t kChunksPerWorkerInFlight = 4;
+
+struct ColumnInfo {
+    RdbExportColumn column;
+    std::string_view name;
+    std::uint32_t valueSize;  // columnar width, 0 = string
+    bool needsLocation;
+};
+
+constexpr std::array<ColumnInfo, kRdbExportColumnCount> kColumns{{
+    {RdbExportColumn::Index, "index", 4, false},
+    {RdbExportColumn::FileKtid, "fileKtid", 4, false},
+    {RdbExportColumn::TypeInfoKtid, "typeInfoKtid", 4, false},
+    {RdbExportColumn::FileSize, "fileSize", 8, false},
+    {RdbExportColumn::Flags, "flags", 4, false},
+    {RdbExportColumn::DataSize, "dataSize", 8, false},
+    {RdbExportColumn::NewFlags, "newFlags", 2, true},
+    {RdbExportColumn::Offset, "offset", 8, true},
+    {RdbExportColumn::SizeInContainer, "sizeInContainer", 4, true},
+    {RdbExportColumn::FdataId, "fdataId", 2, true},
+    {RdbExportColumn::Container, "container", 0, true},
+    {RdbExportColumn::FileName, "fileName", 0, false},
+    {RdbExportColumn::TypeName, "typeName", 0, false},
+}};
+
+void SetError(std::string* error, std::string_view message) {
+    if (error != nullptr) {
+        *error = std::string(message);
+    }
+}
+
+[[nodiscard]] bool HasColumn(std::uint32_t columns, RdbExportColumn column) {
+    return (columns & static_cast<std::uint32_t>(column)) != 0;
+}
+
+void AppendDec(std::string& out, std::uint64_t value) {
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// Lowercase hex; zero-padded to minWidth digits.
+void AppendHex(std::string& out, std::uint64_t value, std::size_t minWidth) {
+    char buffer[16];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, 16);
+    const std::size_t digits = static_cast<std::size_t>(result.ptr - buffer);
+    if (digits < minWidth) {
+        out.append(minWidth - digits, '0');
+    }
+    out.append(buffer, result.ptr);
+}
+
+void AppendJsonString(std::string& out, std::string_view text) {
+    out.push_back('"');
+    for (const char ch : text) {
+        switch (ch) {
+        case '"':
+            out.append("\\\"");
+            break;
+        case '\\':
+            out.append("\\\\");
+            break;
+        case '\n':
+            out.append("\\n");
+            break;
+        case '\r':
+            out.append("\\r");
+            break;
+        case '\t':
+            out.append("\\t");
+            break;
+        default:
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                out.append("\\u00");
+                AppendHex(out, static_cast<unsigned char>(ch), 2);
+            } else {
+                out.push_back(ch);
+            }
+            break;
+        }
+    }
+    out.push_back('"');
+}
+
+// RFC 4180: a field holding a comma, quote or line break is quoted, with embedded quotes doubled.
+// Other fields are written as-is so ordinary rows stay Dump-compatible.
+void AppendCsvField(std::string& out, std::string_view text) {
+    if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out.append(text);
+        return;
+    }
+    out.push_back('"');
+    for (const char ch : text) {
+        if (ch == '"') {
+            out.push_back('"');
+        }
+        out.push_back(ch);
+    }
+    out.push_back('"');
+}
+
+// Text of a string column; empty when the value is unknown.
+[[nodiscard]] std::string StringColumnValue(const RdbEntry& entry, RdbExportColumn column, const NameDictionary* names) {
+    switch (column) {
+    case RdbExportColumn::Container:
+        return entry.hasLocation ? entry.location.containerPath.generic_string() : std::string{};
+    case RdbExportColumn::FileName:
+        return names != nullptr ? std::string(names->Find(entry.fileKtid)) : std::string{};
+    case RdbExportColumn::TypeName:
+        return names != nullptr ? std::string(names->Find(entry.typeInfoKtid)) : std::string{};
+    default:
+        return {};
+    }
+}
+
+// Appends the CSV/JSON text form of one column value (without separators).
+void AppendColumnText(std::string& out, const RdbEntry& entry, RdbExportColumn column, bool json,
+                      const NameDictionary* names) {
+    const auto hex = [&](std::uint64_t value, std::size_t width) {
+        if (json) {
+            out.push_back('"');
+        }
+        out.append("0x");
+        AppendHex(out, value, width);
+        if (json) {
+            out.push_back('"');
+        }
+    };
+
+    switch (column) {
+    case RdbExportColumn::Index:
+        AppendDec(out, entry.index);
+        return;
+    case RdbExportColumn::FileKtid:
+        hex(entry.fileKtid, 8);
+        return;
+    case RdbExportColumn::TypeInfoKtid:
+        hex(entry.typeInfoKtid, 8);
+        return;
+    case RdbExportColumn::FileSize:
+        AppendDec(out, entry.fileSize);
+        return;
+    case RdbExportColumn::Flags:
+        hex(entry.flags, 8);
+        return;
+    case RdbExportColumn::DataSize:
+        AppendDec(out, entry.dataSize);
+        return;
+    case RdbExportColumn::FileName:
+    case RdbExportColumn::TypeName: {
+        const std::string_view name =
+            names->Find(column == RdbExportColumn::FileName ? entry.fileKtid : entry.typeInfoKtid);
+        if (!json) {
+            AppendCsvField(out, name);
+        } else if (name.empty()) {
+            out.append("null");
+        } else {
+            AppendJsonString(out, name);
+        }
+        return;
+    }
+    default:
+        break;
+    }
+
+    if (!entry.hasLocation) {
+        out.append(json ? "null" : "n/a");
+        return;
+    }
+
+    switch (column) {
+    case RdbExportColumn::NewFlags:
+        hex(entry.location.newFlags, 0);
+        return;
+    case RdbExportColumn::Offset:
+        AppendDec(out, entry.location.offset);
+        return;
+    case RdbExportColumn::SizeInContainer:
+        AppendDec(out, entry.location.sizeInContainer);
+        return;
+    case RdbExportColumn::FdataId:
+        AppendDec(out, entry.location.fdataId);
+        return;
+    case RdbExportColumn::Container:
+        if (json) {
+            AppendJsonString(out, entry.location.containerPath.generic_string());
+        } else {
+            AppendCsvField(out, entry.location.containerPath.generic_string());
+        }
+        return;
+    default:
+        return;
+    }
+}
+
+void AppendCsvRow(std::string& out, const RdbEntry& entry, std::uint32_t columns, const NameDictionary* names) {
+    bool first = true;
+    for (const ColumnInfo& info : kColumns) {
+        if (!HasColumn(columns, info.column)) {
+            continue;
+        }
+        if (!first) {
+            out.push_back(',');
+        }
+        first = false;
+        AppendColumnText(out, entry, info.column, false, names);
+    }
+    out.push_back('\n');
+}
+
+void AppendJsonRow(std::string& out, const RdbEntry& entry, std::uint32_t columns, const NameDictionary* names) {
+    out.push_back('{');
+    bool first = true;
+    for (const ColumnInfo& info : kColumns) {
+        if (!HasColumn(columns, info.column)) {
+            continue;
+        }
+        if (!first) {
+            out.push_back(',');
+        }
+        first = false;
+        out.push_back('"');
+        out.append(info.name);
+        out.append("\":");
+        AppendColumnText(out, entry, info.column, true, names);
+    }
+    out.append("}\n");
+}
+
+[[nodiscard]] std::uint64_t ColumnValue(const RdbEntry& entry, RdbExportColumn column) {
+    switch (column) {
+    case RdbExportColumn::Index:
+        return entry.index;
+    case RdbExportColumn::FileKtid:
+        return entry.fileKtid;
+    case RdbExportColumn::TypeInfoKtid:
+        return entry.typeInfoKtid;
+    case RdbExportColumn::FileSize:
+        return entry.fileSize;
+    case RdbExportColumn::Flags:
+        return entry.flags;
+    case RdbExportColumn::DataSize:
+        return entry.dataSize;
+    case RdbExportColumn::NewFlags:
+        return entry.hasLocation ? entry.location.newFlags : 0;
+    case RdbExportColumn::Offset:
+        return entry.hasLocation ? entry.location.offset : 0;
+    case RdbExportColumn::SizeInContainer:
+        return entry.hasLocation ? entry.location.sizeInContainer : 0;
+    case RdbExportColumn::FdataId:
+        return entry.hasLocation ? entry.location.fdataId : 0;
+    default:
+        return 0;
+    }
+}
+
+void StoreLE(std::byte* dst, std::uint64_t value, std::uint32_t size) {
+    for (std::uint32_t i = 0; i < size; ++i) {
+        dst[i] = static_cast<std::byte>((value >> (i * 8)) & 0xFFu);
+    }
+}
+
+[[nodiscard]] std::uint64_t AlignUp8(std::uint64_t value) {
+    return (value + 7u) & ~std::uint64_t{7};
+}
+
+[[nodiscard]] std::vector<const RdbEntry*> SelectRows(std::span<const RdbEntry> entries,
+                                                      const std::vector<std::uint32_t>& typeFilter) {
+    std::vector<std::uint32_t> sortedTypes = typeFilter;
+    std::sort(sortedTypes.begin(), sortedTypes.end());
+
+    std::vector<const RdbEntry*> rows;
+    rows.reserve(entries.size());
+    for (const RdbEntry& entry : entries) {
+        if (sortedTypes.empty() || std::binary_search(sortedTypes.begin(), sortedTypes.end(), entry.typeInfoKtid)) {
+            rows.push_back(&entry);
+        }
+    }
+    return rows;
+}
+
+void WriteText(binary_io::file_ostream& out, std::string_view text) {
+    if (!text.empty()) {
+        out.write_bytes(std::as_bytes(std::span<const char>(text.data(), text.size())));
+    }
+}
+
+std::string FormatCsvPreamble(const RdbHeader& header, std::size_t entryCount, std::uint32_t columns, bool includeHeader) {
+    std::string out;
+    if (includeHeader) {
+        out.append("RDB Header\nmagic=");
+        out.append(header.magic.data(), header.magic.size());
+        out.append("\nversion=0x");
+        AppendHex(out, header.version, 8);
+        out.append("\nheaderSize=");
+        AppendDec(out, header.headerSize);
+        out.append("\nsystemId=");
+        AppendDec(out, header.systemId);
+        out.append("\nfileCount=");
+        AppendDec(out, entryCount);
+        out.append("\ndatabaseId=0x");
+        AppendHex(out, header.databaseId, 8);
+        out.append("\nfolderPath=");
+        out.append(header.FolderPath());
+        out.append("\n\n");
+    }
+
+    bool first = true;
+    for (const ColumnInfo& info : kColumns) {
+        if (!HasColumn(columns, info.column)) {
+            continue;
+        }
+        if (!first) {
+            out.push_back(',');
+        }
+        first = false;
+        out.append(info.name);
+    }
+    out.push_back('\n');
+    return out;
+}
+
+// Formats rows on worker threads in bounded batches and writes each batch in row order.
+template <class RowFormatter>
+void WriteTextRows(binary_io::file_ostream& out, const std::vector<const RdbEntry*>& rows,
+                   std::size_t threadCount, RowFormatter&& formatRow) {
+    const std::size_t chunkCount = (rows.size() + kRowsPerChunk - 1) / kRowsPerChunk;
+    const std::size_t workers = ResolveThreadCount(threadCount, chunkCount);
+    const std::size_t chunksPerBatch = workers * kChunksPerWorkerInFlight;
+
+    std::vector<std::string> buffers(std::min(chunksPerBatch, chunkCount));
+    for (std::size_t batchBegin = 0; batchBegin < chunkCount; batchBegin += chunksPerBatch) {
+        const std::size_t batchSize = std::min(chunksPerBatch, chunkCount - batchBegin);
+        ParallelFor(batchSize, workers, [&](std::size_t slot) {
+            std::string& buffer = buffers[slot];
+            buffer.clear();
+            const std::size_t begin = (batchBegin + slot) * kRowsPerChunk;
+            const std::size_t end = std::min(begin + kRowsPerChunk, rows.size());
+            for (std::size_t row = begin; row < end; ++row) {
+                formatRow(buffer, *rows[row]);
+            }
+        });
+        for (std::size_t slot = 0; slot < batchSize; ++slot) {
+            WriteText(out, buffers[slot]);
+        }
+    }
+}
+
+struct StringColumnData {
+    std::vector<std::byte> offsets;  // rowCount + 1 little-endian uint32
+    std::string blob;
+};
+
+[[nodiscard]] StringColumnData BuildStringColumn(const std::vector<const RdbEntry*>& rows, RdbExportColumn column,
+                                                 const NameDictionary* names, std::size_t threadCount) {
+    const std::size_t rowCount = rows.size();
+    const std::size_t chunkCount = (rowCount + kRowsPerChunk - 1) / kRowsPerChunk;
+
+    std::vector<std::string> chunkBlobs(chunkCount);
+    std::vector<std::vector<std::uint32_t>> chunkEnds(chunkCount);
+    ParallelFor(chunkCount, threadCount, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * kRowsPerChunk;
+        const std::size_t end = std::min(begin + kRowsPerChunk, rowCount);
+        chunkEnds[chunk].reserve(end - begin);
+        for (std::size_t row = begin; row < end; ++row) {
+            chunkBlobs[chunk].append(StringColumnValue(*rows[row], column, names));
+            chunkEnds[chunk].push_back(static_cast<std::uint32_t>(chunkBlobs[chunk].size()));
+        }
+    });
+
+    StringColumnData data;
+    data.offsets.resize((rowCount + 1) * sizeof(std::uint32_t));
+    std::size_t row = 0;
+    StoreLE(data.offsets.data(), 0, 4);
+    for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        const auto base = static_cast<std::uint32_t>(data.blob.size());
+        for (const std::uint32_t end : chunkEnds[chunk]) {
+            ++row;
+            StoreLE(data.offsets.data() + row * 4, base + end, 4);
+        }
+        data.blob.append(chunkBlobs[chunk]);
+    }
+    return data;
+}
+
+void WriteColumnar(binary_io::file_ostream& out, const RdbHeader& header,
+                   const std::vector<const RdbEntry*>& rows, std::uint32_t columns,
+                   const NameDictionary* names, std::size_t threadCount) {
+    const std::size_t rowCount = rows.size();
+    const std::size_t chunkCount = (rowCount + kRowsPerChunk - 1) / kRowsPerChunk;
+
+    // String column sizes are not known up front; build them first.
+    std::array<StringColumnData, kRdbExportColumnCount> stringColumns;
+    std::vector<RdbColumnarColumn> descriptors;
+    for (std::size_t i = 0; i < kColumns.size(); ++i) {
+        const ColumnInfo& info = kColumns[i];
+        if (!HasColumn(columns, info.column)) {
+            continue;
+        }
+        RdbColumnarColumn desc{};
+        desc.column = static_cast<std::uint32_t>(info.column);
+        desc.valueSize = info.valueSize;
+        if (info.valueSize != 0) {
+            desc.dataSize = static_cast<std::uint64_t>(rowCount) * info.valueSize;
+        } else {
+            stringColumns[i] = BuildStringColumn(rows, info.column, names, threadCount);
+            desc.dataSize = stringColumns[i].offsets.size() + stringColumns[i].blob.size();
+        }
+        descriptors.push_back(desc);
+    }
+
+    RdbColumnarHeader fileHeader{};
+    fileHeader.rowCount = rowCount;
+    fileHeader.columnCount = static_cast<std::uint32_t>(descriptors.size());
+    fileHeader.databaseId = header.databaseId;
+
+    std::uint64_t cursor = AlignUp8(sizeof(RdbColumnarHeader) + descriptors.size() * sizeof(RdbColumnarColumn));
+    for (RdbColumnarColumn& desc : descriptors) {
+        desc.dataOffset = cursor;
+        cursor = AlignUp8(cursor + desc.dataSize);
+    }
+
+    out.write_bytes(std::as_bytes(std::span(&fileHeader, 1)));
+    out.write_bytes(std::as_bytes(std::span(descriptors)));
+
+    std::uint64_t written = sizeof(RdbColumnarHeader) + descriptors.size() * sizeof(RdbColumnarColumn);
+    const auto padTo = [&](std::uint64_t target) {
+        static constexpr std::array<std::byte, 8> zeros{};
+        if (target > written) {
+            out.write_bytes(std::span(zeros.data(), static_cast<std::size_t>(target - written)));
+            written = target;
+        }
+    };
+
+    std::vector<std::byte> columnData;
+    for (const RdbColumnarColumn& desc : descriptors) {
+        padTo(desc.dataOffset);
+        const auto column = static_cast<RdbExportColumn>(desc.column);
+        if (desc.valueSize == 0) {
+            const auto it = std::find_if(kColumns.begin(), kColumns.end(),
+                                         [column](const ColumnInfo& info) { return info.column == column; });
+            const StringColumnData& data = stringColumns[static_cast<std::size_t>(it - kColumns.begin())];
+            out.write_bytes(data.offsets);
+            WriteText(out, data.blob);
+        } else {
+            columnData.resize(static_cast<std::size_t>(desc.dataSize));
+            ParallelFor(chunkCount, threadCount, [&](std::size_t chunk) {
+                const std::size_t begin = chunk * kRowsPerChunk;
+                const std::size_t end = std::min(begin + kRowsPerChunk, rowCount);
+                for (std::size_t row = begin; row < end; ++row) {
+                    StoreLE(columnData.data() + row * desc.valueSize, ColumnValue(*rows[row], column), desc.valueSize);
+                }
+            });
+            out.write_bytes(columnData);
+        }
+        written += desc.dataSize;
+    }
+}
+
+}  // namespace
+
+bool ExportRdbEntries(const RdbHeader& header,
+                      std::span<const RdbEntry> entries,
+                      const fs::path& outputPath,
+                      const RdbExportOptions& options,
+                      std::string* error) {
+    std::uint32_t columns = options.columns & kRdbExportAllColumns;
+    if (options.names == nullptr) {
+        columns &= ~(RdbExportColumn::FileName | RdbExportColumn::TypeName);
+    }
+    if (columns == 0) {
+        SetError(error, "Export column selection is empty.");
+        return false;
+    }
+
+    std::error_code ec;
+    if (!outputPath.parent_path().empty()) {
+        fs::create_directories(outputPath.parent_path(), ec);
+    }
+
+    const std::vector<const RdbEntry*> rows = SelectRows(entries, options.typeInfoKtids);
+
+    try {
+        binary_io::file_ostream out(outputPath, binary_io::write_mode::truncate);
+        switch (options.format) {
+        case RdbExportFormat::Csv:
+            WriteText(out, FormatCsvPreamble(header, entries.size(), columns, options.includeHeader));
+            WriteTextRows(out, rows, options.threadCount, [&](std::string& buffer, const RdbEntry& entry) {
+                AppendCsvRow(buffer, entry, columns, options.names);
+            });
+            break;
+        case RdbExportFormat::JsonLines:
+            WriteTextRows(out, rows, options.threadCount, [&](std::string& buffer, const RdbEntry& entry) {
+                AppendJsonRow(buffer, entry, columns, options.names);
+            });
+            break;
+        case RdbExportFormat::Columnar:
+            WriteColumnar(out, header, rows, columns, options.names, options.threadCount);
+            break;
+        default:
+            SetError(error, "Unsupported export format.");
+            return false;
+        }
+        out.flush();
+    } catch (const std::exception& ex) {
+        SetError(error, std::string("Failed to write export file: ") + ex.what());
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace LooseFileLoader
@@ -1,4 +1,5 @@
 #include "RdbTool.h"
+#include "RdbExport.h"
 
 #include "binary_io/binary_io.hpp"
 
@@ -6,13 +7,14 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <charconv>
 #include <cstring>
-#include <fstream>
-#include <iomanip>
 #include <limits>
+#include <mutex>
 #include <optional>
-#include <sstream>
+#include <shared_mutex>
 #include <string_view>
 #include <utility>
 
@@ -27,6 +29,7 @@ constexpr std::uint32_t kCompressionMask = (0x3Fu << 20);
 constexpr std::uint32_t kCompressionZlib = 1;
 constexpr std::uint32_t kCompressionEncrypted = 3;
 constexpr std::uint32_t kCompressionExtended = 4;
+constexpr std::size_t kRdbHeaderSize = 32;
 constexpr std::size_t kRdbEntryHeaderSize = 48;
 constexpr std::size_t kKrdiHeaderSize = 56;
 constexpr std::size_t kDefaultChunkSize = 0x4000;
@@ -40,9 +43,29 @@ constexpr std::size_t kDefaultChunkSize = 0x4000;
 }
 
 [[nodiscard]] std::string Hex8(std::uint32_t value) {
-    std::ostringstream oss;
-    oss << std::hex << std::nouppercase << std::setfill('0') << std::setw(8) << value;
-    return oss.str();
+    std::string out(8, '0');
+    char buffer[8];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, 16);
+    const std::size_t digits = static_cast<std::size_t>(result.ptr - buffer);
+    std::memcpy(out.data() + (8 - digits), buffer, digits);
+    return out;
+}
+
+// Word-at-a-time 64-bit hash used to detect whether already parsed RDB bytes changed.
+[[nodiscard]] std::uint64_t HashBytes(std::span<const std::byte> bytes) {
+    constexpr std::uint64_t kMul = 0x9E3779B97F4A7C15ull;
+    std::uint64_t hash = 0xCBF29CE484222325ull ^ (bytes.size() * kMul);
+    std::size_t pos = 0;
+    for (; pos + 8 <= bytes.size(); pos += 8) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes.data() + pos, sizeof(word));
+        hash = (hash ^ word) * kMul;
+        hash ^= hash >> 29;
+    }
+    for (; pos < bytes.size(); ++pos) {
+        hash = (hash ^ static_cast<std::uint64_t>(bytes[pos])) * kMul;
+    }
+    return hash ^ (hash >> 32);
 }
 
 [[nodiscard]] bool ToSizeT(std::uint64_t value, std::size_t* out) {
@@ -143,6 +166,46 @@ std::string RdbHeader::FolderPath() const {
     return path;
 }
 
+struct RdbTool::SharedState {
+    // Serializes Reload/Replace/Insert and guards the writer-side bookkeeping in RdbTool.
+    std::mutex writeMutex;
+    // Container files: shared while Extract reads them, exclusive while a mutation rewrites them.
+    mutable std::shared_mutex containerMutex;
+    std::atomic<std::shared_ptr<const RdbCatalog>> catalog{std::make_shared<const RdbCatalog>()};
+};
+
+const RdbHeader& RdbCatalog::Header() const {
+    return header_;
+}
+
+const std::vector<RdxEntry>& RdbCatalog::RdxEntries() const {
+    return rdxEntries_;
+}
+
+const std::vector<RdbEntry>& RdbCatalog::Entries() const {
+    return entries_;
+}
+
+const RdbEntry* RdbCatalog::FindEntryByFileKtid(std::uint32_t fileKtid) const {
+    const auto it = entryIndexByKtid_.find(fileKtid);
+    if (it == entryIndexByKtid_.end()) {
+        return nullptr;
+    }
+    return &entries_[it->second];
+}
+
+void RdbCatalog::IndexEntry(std::size_t position) {
+    entryIndexByKtid_.emplace(entries_[position].fileKtid, position);
+}
+
+RdbTool::RdbTool() : shared_(std::make_unique<SharedState>()) {}
+
+RdbTool::RdbTool(RdbTool&& other) noexcept = default;
+
+RdbTool& RdbTool::operator=(RdbTool&& other) noexcept = default;
+
+RdbTool::~RdbTool() = default;
+
 std::optional<RdbTool> RdbTool::Open(const fs::path& rootRdbPath,
                                      const fs::path& rootRdxPath,
                                      std::string* error) {
@@ -157,82 +220,122 @@ std::optional<RdbTool> RdbTool::Open(const fs::path& rootRdbPath,
 }
 
 bool RdbTool::Reload(std::string* error) {
-    entries_.clear();
-    rdxEntries_.clear();
-    if (!ReadRdx(error)) {
+    std::lock_guard lock(shared_->writeMutex);
+    return ReloadLocked(error);
+}
+
+bool RdbTool::ReloadLocked(std::string* error) {
+    SourceFileState rdbState{};
+    SourceFileState rdxState{};
+    if (!QuerySourceFileState(rootRdbPath_, &rdbState, error) ||
+        !QuerySourceFileState(rootRdxPath_, &rdxState, error)) {
+        return false;
+    }
+    if (loaded_ && rdbState == rdbFileState_ && rdxState == rdxFileState_) {
+        return true;
+    }
+
+    std::vector<RdxEntry> rdxEntries;
+    if (!ReadRdx(&rdxEntries, error)) {
+        return false;
+    }
+    std::vector<std::byte> rdbBytes;
+    if (!ReadWholeFile(rootRdbPath_, &rdbBytes, error)) {
+        return false;
+    }
+    RdbHeader header{};
+    if (!ParseRdbHeader(rdbBytes, &header, error)) {
         return false;
     }
-    if (!ReadRdb(error)) {
+
+    const CatalogPtr current = Snapshot();
+
+    // Parsed entries stay valid when the RDX only gained fdata ids and the RDB only gained entries.
+    const bool rdxExtended = loaded_ && rdxEntries.size() >= current->rdxEntries_.size() &&
+                             std::equal(current->rdxEntries_.begin(), current->rdxEntries_.end(), rdxEntries.begin());
+    const bool incremental = rdxExtended && IsParsedRdbPrefixUnchanged(*current, rdbBytes, header);
+
+    if (incremental) {
+        auto next = std::make_shared<RdbCatalog>(*current);
+        next->rdxEntries_ = rdxEntries;
+        next->header_ = header;
+        std::uint64_t parsedEnd = rdbParsedEnd_;
+        if (ParseRdbEntries(*next, rdbBytes, rdbParsedEnd_, header.fileCount - current->entries_.size(), &parsedEnd,
+                            nullptr)) {
+            RecordRdbState(rdbBytes, parsedEnd);
+            rdbFileState_ = rdbState;
+            rdxFileState_ = rdxState;
+            Publish(std::move(next));
+            return true;
+        }
+    }
+
+    auto next = std::make_shared<RdbCatalog>();
+    next->rdxEntries_ = std::move(rdxEntries);
+    next->header_ = header;
+    std::uint64_t parsedEnd = 0;
+    if (!ParseRdbEntries(*next, rdbBytes, kRdbHeaderSize, header.fileCount, &parsedEnd, error)) {
+        loaded_ = false;
         return false;
     }
+    RecordRdbState(rdbBytes, parsedEnd);
+    rdbFileState_ = rdbState;
+    rdxFileState_ = rdxState;
+    loaded_ = true;
+    Publish(std::move(next));
     return true;
 }
 
+RdbTool::CatalogPtr RdbTool::Snapshot() const {
+    return shared_->catalog.load(std::memory_order_acquire);
+}
+
+void RdbTool::Publish(std::shared_ptr<const RdbCatalog> catalog) {
+    shared_->catalog.store(std::move(catalog), std::memory_order_release);
+}
+
 const RdbHeader& RdbTool::Header() const {
-    return header_;
+    return Snapshot()->Header();
 }
 
 const std::vector<RdbEntry>& RdbTool::Entries() const {
-    return entries_;
+    return Snapshot()->Entries();
 }
 
 const RdbEntry* RdbTool::FindEntryByFileKtid(std::uint32_t fileKtid) const {
-    const auto it = std::find_if(entries_.begin(), entries_.end(), [fileKtid](const RdbEntry& entry) {
-        return entry.fileKtid == fileKtid;
-    });
-    if (it == entries_.end()) {
-        return nullptr;
-    }
-    return &(*it);
+    return Snapshot()->FindEntryByFileKtid(fileKtid);
 }
 
 bool RdbTool::Dump(const fs::path& outputPath, std::string* error) const {
-    std::error_code ec;
-    if (!outputPath.parent_path().empty()) {
-        fs::create_directories(outputPath.parent_path(), ec);
-    }
-
-    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
-    if (!out.is_open()) {
-        SetError(error, "Failed to open dump output file.");
-        return false;
-    }
-
-    out << "RDB Header\n";
-    out << "magic=" << std::string(header_.magic.data(), header_.magic.size()) << "\n";
-    out << "version=0x" << Hex8(header_.version) << "\n";
-    out << "headerSize=" << header_.headerSize << "\n";
-    out << "systemId=" << header_.systemId << "\n";
-    out << "fileCount=" << entries_.size() << "\n";
-    out << "databaseId=0x" << Hex8(header_.databaseId) << "\n";
-    out << "folderPath=" << header_.FolderPath() << "\n\n";
-
-    out << "index,fileKtid,typeInfoKtid,fileSize,flags,dataSize,newFlags,offset,sizeInContainer,fdataId,container\n";
-    for (const RdbEntry& entry : entries_) {
-        out << entry.index << ",0x" << Hex8(entry.fileKtid)
-            << ",0x" << Hex8(entry.typeInfoKtid)
-            << "," << entry.fileSize
-            << ",0x" << Hex8(entry.flags)
-            << "," << entry.dataSize
-            << ",";
-
-        if (entry.hasLocation) {
-            out << "0x" << std::hex << std::nouppercase << entry.location.newFlags << std::dec
-                << "," << entry.location.offset
-                << "," << entry.location.sizeInContainer
-                << "," << entry.location.fdataId
-                << "," << entry.location.containerPath.generic_string();
-        } else {
-            out << "n/a,n/a,n/a,n/a,n/a";
-        }
-        out << "\n";
-    }
+    return Export(outputPath, RdbExportOptions{}, error);
+}
 
-    return true;
+bool RdbTool::Dump(const fs::path& outputPath, const NameDictionary& names, std::string* error) const {
+    RdbExportOptions options{};
+    options.names = &names;
+    return Export(outputPath, options, error);
+}
+
+bool RdbTool::Export(const fs::path& outputPath, const RdbExportOptions& options, std::string* error) const {
+    const CatalogPtr catalog = Snapshot();
+    return ExportRdbEntries(catalog->Header(), catalog->Entries(), outputPath, options, error);
 }
 
 bool RdbTool::Extract(std::uint32_t fileKtid, const fs::path& outputPath, std::string* error) const {
-    const RdbEntry* entry = FindEntryByFileKtid(fileKtid);
+    std::vector<std::byte> payload;
+    if (!Extract(fileKtid, &payload, error)) {
+        return false;
+    }
+    return WriteWholeFile(outputPath, payload, error);
+}
+
+bool RdbTool::Extract(std::uint32_t fileKtid, std::vector<std::byte>* outPayload, std::string* error) const {
+    if (outPayload == nullptr) {
+        SetError(error, "Invalid output buffer.");
+        return false;
+    }
+    const CatalogPtr catalog = Snapshot();
+    const RdbEntry* entry = catalog->FindEntryByFileKtid(fileKtid);
     if (entry == nullptr) {
         SetError(error, "Entry not found for fileKtid.");
         return false;
@@ -242,24 +345,19 @@ bool RdbTool::Extract(std::uint32_t fileKtid, const fs::path& outputPath, std::s
         return false;
     }
 
-    fs::path containerPath;
-    std::vector<std::byte> containerBytes;
-    if (!ReadContainer(*entry, &containerPath, &containerBytes, error)) {
-        return false;
+    std::vector<std::byte> blockBytes;
+    {
+        std::shared_lock containerLock(shared_->containerMutex);
+        if (!ReadBlock(*entry, &blockBytes, error)) {
+            return false;
+        }
     }
 
-    const std::uint64_t blockOffset = (entry->location.newFlags == kLocationInternal) ? entry->location.offset : 0;
     ParsedKrdi krdi;
-    if (!ParseKrdiAt(containerBytes, blockOffset, &krdi, error)) {
-        return false;
-    }
-
-    std::vector<std::byte> payload;
-    if (!ExtractPayload(containerBytes, krdi, &payload, error)) {
+    if (!ParseKrdiAt(blockBytes, 0, &krdi, error)) {
         return false;
     }
-
-    return WriteWholeFile(outputPath, payload, error);
+    return ExtractPayload(blockBytes, krdi, outPayload, error);
 }
 
 bool RdbTool::Replace(std::uint32_t fileKtid, const fs::path& inputFilePath, std::string* error) {
@@ -271,26 +369,32 @@ bool RdbTool::Replace(std::uint32_t fileKtid, const fs::path& inputFilePath, std
 }
 
 bool RdbTool::Replace(std::uint32_t fileKtid, std::span<const std::byte> replacementData, std::string* error) {
-    auto entryIt = std::find_if(entries_.begin(), entries_.end(), [fileKtid](const RdbEntry& entry) {
-        return entry.fileKtid == fileKtid;
-    });
-    if (entryIt == entries_.end()) {
+    std::lock_guard lock(shared_->writeMutex);
+    const CatalogPtr current = Snapshot();
+
+    const auto indexIt = current->entryIndexByKtid_.find(fileKtid);
+    if (indexIt == current->entryIndexByKtid_.end()) {
         SetError(error, "Entry not found for replace.");
         return false;
     }
-    if (!entryIt->hasLocation) {
+    const std::size_t position = indexIt->second;
+    const RdbEntry& sourceEntry = current->entries_[position];
+    if (!sourceEntry.hasLocation) {
         SetError(error, "Target entry has no location metadata.");
         return false;
     }
 
+    // Readers may still be extracting from this container; hold them off until it is rewritten.
+    std::unique_lock containerLock(shared_->containerMutex);
+
     fs::path containerPath;
     std::vector<std::byte> containerBytes;
-    if (!ReadContainer(*entryIt, &containerPath, &containerBytes, error)) {
+    if (!ReadContainer(sourceEntry, &containerPath, &containerBytes, error)) {
         return false;
     }
 
-    const bool isInternal = (entryIt->location.newFlags == kLocationInternal);
-    const std::uint64_t blockOffset = isInternal ? entryIt->location.offset : 0;
+    const bool isInternal = (sourceEntry.location.newFlags == kLocationInternal);
+    const std::uint64_t blockOffset = isInternal ? sourceEntry.location.offset : 0;
 
     ParsedKrdi sourceKrdi;
     if (!ParseKrdiAt(containerBytes, blockOffset, &sourceKrdi, error)) {
@@ -314,7 +418,7 @@ bool RdbTool::Replace(std::uint32_t fileKtid, std::span<const std::byte> replace
         newOffset = 0;
     }
 
-    RdbEntry updatedEntry = *entryIt;
+    RdbEntry updatedEntry = sourceEntry;
     updatedEntry.fileSize = replacementData.size();
     if (!PatchEntryLocation(&updatedEntry, newOffset, static_cast<std::uint32_t>(newBlock.size()), error)) {
         return false;
@@ -324,8 +428,13 @@ bool RdbTool::Replace(std::uint32_t fileKtid, std::span<const std::byte> replace
         return false;
     }
 
-    *entryIt = std::move(updatedEntry);
-    return SaveRdb(error);
+    auto next = std::make_shared<RdbCatalog>(*current);
+    next->entries_[position] = std::move(updatedEntry);
+    if (!SaveRdb(*next, error)) {
+        return false;
+    }
+    Publish(std::move(next));
+    return true;
 }
 
 bool RdbTool::Insert(std::uint32_t newFileKtid, std::uint32_t templateFileKtid,
@@ -353,12 +462,15 @@ bool RdbTool::Insert(std::uint32_t newFileKtid, std::uint32_t templateFileKtid,
         return Insert(newFileKtid, templateFileKtid, true, typeInfoKtid, error);
     }
 
-    if (FindEntryByFileKtid(newFileKtid) != nullptr) {
+    std::lock_guard lock(shared_->writeMutex);
+    const CatalogPtr current = Snapshot();
+
+    if (current->FindEntryByFileKtid(newFileKtid) != nullptr) {
         SetError(error, "newFileKtid already exists in RDB.");
         return false;
     }
 
-    const RdbEntry* templateEntry = FindEntryByFileKtid(templateFileKtid);
+    const RdbEntry* templateEntry = current->FindEntryByFileKtid(templateFileKtid);
     if (templateEntry == nullptr) {
         SetError(error, "Template entry not found.");
         return false;
@@ -368,6 +480,8 @@ bool RdbTool::Insert(std::uint32_t newFileKtid, std::uint32_t templateFileKtid,
         return false;
     }
 
+    std::unique_lock containerLock(shared_->containerMutex);
+
     fs::path templateContainerPath;
     std::vector<std::byte> templateContainerBytes;
     if (!ReadContainer(*templateEntry, &templateContainerPath, &templateContainerBytes, error)) {
@@ -413,7 +527,7 @@ bool RdbTool::Insert(std::uint32_t newFileKtid, std::uint32_t templateFileKtid,
     } else {
         const std::string folderPrefix = Hex8(newFileKtid).substr(6, 2);
         const std::string relFile = "0x" + Hex8(newFileKtid) + ".file";
-        const fs::path folder = fs::path(header_.FolderPath()) / folderPrefix;
+        const fs::path folder = fs::path(current->header_.FolderPath()) / folderPrefix;
         const fs::path relPath = folder / relFile;
         const fs::path absPath = packageDir_ / relPath;
         if (!PatchEntryLocation(&newEntry, 0, newSize, error)) {
@@ -424,16 +538,20 @@ bool RdbTool::Insert(std::uint32_t newFileKtid, std::uint32_t templateFileKtid,
         }
         newEntry.location.containerPath = relPath;
     }
+    containerLock.unlock();
 
-    newEntry.index = entries_.size();
+    auto next = std::make_shared<RdbCatalog>(*current);
+    newEntry.index = next->entries_.size();
     newEntry.entryOffsetInRdb = 0;
-    entries_.push_back(std::move(newEntry));
-    header_.fileCount = static_cast<std::uint32_t>(entries_.size());
+    next->entries_.push_back(std::move(newEntry));
+    ResolveContainerPath(*next, &next->entries_.back());
+    next->IndexEntry(next->entries_.size() - 1);
 
-    if (!SaveRdb(error)) {
+    if (!SaveRdb(*next, error)) {
         return false;
     }
-    return Reload(error);
+    Publish(std::move(next));
+    return ReloadLocked(error);
 }
 
 bool RdbTool::Insert(std::uint32_t newFileKtid, std::uint32_t templateFileKtid,
@@ -445,12 +563,15 @@ bool RdbTool::Insert(std::uint32_t newFileKtid, std::uint32_t templateFileKtid,
         return false;
     }
 
-    if (FindEntryByFileKtid(newFileKtid) != nullptr) {
+    std::lock_guard lock(shared_->writeMutex);
+    const CatalogPtr current = Snapshot();
+
+    if (current->FindEntryByFileKtid(newFileKtid) != nullptr) {
         SetError(error, "newFileKtid already exists in RDB.");
         return false;
     }
 
-    const RdbEntry* templateEntry = FindEntryByFileKtid(templateFileKtid);
+    const RdbEntry* templateEntry = current->FindEntryByFileKtid(templateFileKtid);
     if (templateEntry == nullptr) {
         SetError(error, "Template entry not found.");
         return false;
@@ -464,23 +585,25 @@ bool RdbTool::Insert(std::uint32_t newFileKtid, std::uint32_t templateFileKtid,
         return false;
     }
 
+    auto next = std::make_shared<RdbCatalog>(*current);
     RdbEntry newEntry = *templateEntry;
     newEntry.fileKtid = newFileKtid;
     if (typeInfoKtid != 0) {
         newEntry.typeInfoKtid = typeInfoKtid;
     }
-    newEntry.index = entries_.size();
+    newEntry.index = next->entries_.size();
     newEntry.entryOffsetInRdb = 0;
-    entries_.push_back(std::move(newEntry));
-    header_.fileCount = static_cast<std::uint32_t>(entries_.size());
+    next->entries_.push_back(std::move(newEntry));
+    next->IndexEntry(next->entries_.size() - 1);
 
-    if (!SaveRdb(error)) {
+    if (!SaveRdb(*next, error)) {
         return false;
     }
-    return Reload(error);
+    Publish(std::move(next));
+    return ReloadLocked(error);
 }
 
-bool RdbTool::ReadRdx(std::string* error) {
+bool RdbTool::ReadRdx(std::vector<RdxEntry>* outEntries, std::string* error) const {
     std::vector<std::byte> bytes;
     if (!ReadWholeFile(rootRdxPath_, &bytes, error)) {
         return false;
@@ -492,49 +615,46 @@ bool RdbTool::ReadRdx(std::string* error) {
 
     binary_io::span_istream stream(std::span<const std::byte>(bytes.data(), bytes.size()));
     const std::size_t count = bytes.size() / 8u;
-    rdxEntries_.clear();
-    rdxEntries_.reserve(count);
+    outEntries->clear();
+    outEntries->reserve(count);
 
     for (std::size_t i = 0; i < count; ++i) {
         RdxEntry entry{};
         if (!ReadValues(stream, error, entry.index, entry.marker, entry.fileId)) {
             return false;
         }
-        rdxEntries_.push_back(entry);
+        outEntries->push_back(entry);
     }
     return true;
 }
 
-bool RdbTool::ReadRdb(std::string* error) {
-    std::vector<std::byte> bytes;
-    if (!ReadWholeFile(rootRdbPath_, &bytes, error)) {
-        return false;
-    }
-    if (bytes.size() < 32) {
+bool RdbTool::ParseRdbHeader(std::span<const std::byte> rdbBytes, RdbHeader* outHeader, std::string* error) const {
+    if (rdbBytes.size() < kRdbHeaderSize) {
         SetError(error, "RDB file is too small.");
         return false;
     }
 
-    binary_io::span_istream stream(std::span<const std::byte>(bytes.data(), bytes.size()));
+    binary_io::span_istream stream(rdbBytes);
+    RdbHeader header{};
 
     std::array<std::byte, 4> magicBytes{};
     if (!ReadBytes(stream, magicBytes, error)) {
         return false;
     }
     for (std::size_t i = 0; i < magicBytes.size(); ++i) {
-        header_.magic[i] = static_cast<char>(magicBytes[i]);
+        header.magic[i] = static_cast<char>(magicBytes[i]);
     }
-    if (std::string(header_.magic.data(), header_.magic.size()) != "_DRK") {
+    if (std::string(header.magic.data(), header.magic.size()) != "_DRK") {
         SetError(error, "Invalid RDB magic.");
         return false;
     }
 
     if (!ReadValues(stream, error,
-                    header_.version,
-                    header_.headerSize,
-                    header_.systemId,
-                    header_.fileCount,
-                    header_.databaseId)) {
+                    header.version,
+                    header.headerSize,
+                    header.systemId,
+                    header.fileCount,
+                    header.databaseId)) {
         return false;
     }
 
@@ -543,13 +663,25 @@ bool RdbTool::ReadRdb(std::string* error) {
         return false;
     }
     for (std::size_t i = 0; i < folderBytes.size(); ++i) {
-        header_.folderPathRaw[i] = static_cast<char>(folderBytes[i]);
+        header.folderPathRaw[i] = static_cast<char>(folderBytes[i]);
+    }
+
+    *outHeader = header;
+    return true;
+}
+
+bool RdbTool::ParseRdbEntries(RdbCatalog& catalog, std::span<const std::byte> rdbBytes, std::uint64_t startOffset,
+                              std::size_t count, std::uint64_t* outEndOffset, std::string* error) const {
+    if (startOffset > rdbBytes.size()) {
+        SetError(error, "RDB entry offset is out of range.");
+        return false;
     }
 
-    entries_.clear();
-    entries_.reserve(header_.fileCount);
+    binary_io::span_istream stream(rdbBytes);
+    stream.seek_absolute(static_cast<binary_io::streamoff>(startOffset));
+    catalog.entries_.reserve(catalog.entries_.size() + count);
 
-    for (std::uint32_t index = 0; index < header_.fileCount; ++index) {
+    for (std::size_t parsed = 0; parsed < count; ++parsed) {
         while ((stream.tell() & 3) != 0) {
             std::array<std::byte, 1> skip{};
             if (!ReadBytes(stream, skip, error)) {
@@ -558,7 +690,7 @@ bool RdbTool::ReadRdb(std::string* error) {
         }
 
         RdbEntry entry{};
-        entry.index = index;
+        entry.index = catalog.entries_.size();
         entry.entryOffsetInRdb = static_cast<std::uint64_t>(stream.tell());
 
         std::array<std::byte, 4> entryMagic{};
@@ -616,24 +748,46 @@ bool RdbTool::ReadRdb(std::string* error) {
             SetError(error, "Failed to parse RDB entry location.");
             return false;
         }
-        if (!ResolveContainerPath(&entry)) {
+        if (!ResolveContainerPath(catalog, &entry)) {
             SetError(error, "Failed to resolve RDB entry container path.");
             return false;
         }
 
-        entries_.push_back(std::move(entry));
+        catalog.entries_.push_back(std::move(entry));
+        catalog.IndexEntry(catalog.entries_.size() - 1);
     }
 
+    *outEndOffset = static_cast<std::uint64_t>(stream.tell());
     return true;
 }
 
-bool RdbTool::ResolveContainerPath(RdbEntry* entry) const {
+bool RdbTool::IsParsedRdbPrefixUnchanged(const RdbCatalog& catalog, std::span<const std::byte> rdbBytes,
+                                         const RdbHeader& newHeader) const {
+    const RdbHeader& header = catalog.header_;
+    if (newHeader.version != header.version || newHeader.headerSize != header.headerSize ||
+        newHeader.systemId != header.systemId || newHeader.databaseId != header.databaseId ||
+        newHeader.folderPathRaw != header.folderPathRaw) {
+        return false;
+    }
+    if (newHeader.fileCount < catalog.entries_.size() || rdbBytes.size() < rdbParsedEnd_ || rdbParsedEnd_ < kRdbHeaderSize) {
+        return false;
+    }
+    return HashBytes(rdbBytes.subspan(kRdbHeaderSize, static_cast<std::size_t>(rdbParsedEnd_ - kRdbHeaderSize))) ==
+           rdbPrefixHash_;
+}
+
+void RdbTool::RecordRdbState(std::span<const std::byte> rdbBytes, std::uint64_t parsedEnd) {
+    rdbParsedEnd_ = parsedEnd;
+    rdbPrefixHash_ = HashBytes(rdbBytes.subspan(kRdbHeaderSize, static_cast<std::size_t>(parsedEnd - kRdbHeaderSize)));
+}
+
+bool RdbTool::ResolveContainerPath(const RdbCatalog& catalog, RdbEntry* entry) const {
     if (!entry->hasLocation) {
         return true;
     }
 
     if (entry->location.newFlags == kLocationExternal) {
-        std::string folderPath = header_.FolderPath();
+        std::string folderPath = catalog.header_.FolderPath();
         if (folderPath.empty()) {
             folderPath = "data/";
         }
@@ -642,10 +796,10 @@ bool RdbTool::ResolveContainerPath(RdbEntry* entry) const {
         return true;
     }
 
-    const auto it = std::find_if(rdxEntries_.begin(), rdxEntries_.end(), [entry](const RdxEntry& rdx) {
+    const auto it = std::find_if(catalog.rdxEntries_.begin(), catalog.rdxEntries_.end(), [entry](const RdxEntry& rdx) {
         return rdx.index == entry->location.fdataId;
     });
-    if (it == rdxEntries_.end()) {
+    if (it == catalog.rdxEntries_.end()) {
         return false;
     }
 
@@ -722,6 +876,42 @@ bool RdbTool::ReadContainer(const RdbEntry& entry, fs::path* resolvedPath,
     return ReadWholeFile(fullPath, outBytes, error);
 }
 
+bool RdbTool::ReadBlock(const RdbEntry& entry, std::vector<std::byte>* outBytes, std::string* error) const {
+    if (entry.location.newFlags != kLocationInternal) {
+        return ReadContainer(entry, nullptr, outBytes, error);
+    }
+    if (outBytes == nullptr) {
+        SetError(error, "Invalid output buffer.");
+        return false;
+    }
+
+    const fs::path fullPath = packageDir_ / entry.location.containerPath;
+    std::error_code ec;
+    const std::uint64_t fileSize = fs::file_size(fullPath, ec);
+    if (ec) {
+        SetError(error, "Failed to query file size: " + fullPath.string());
+        return false;
+    }
+    if (entry.location.offset > fileSize || entry.location.sizeInContainer > fileSize - entry.location.offset) {
+        SetError(error, "KRDI block exceeds container bounds: " + fullPath.string());
+        return false;
+    }
+
+    outBytes->clear();
+    outBytes->resize(entry.location.sizeInContainer);
+    try {
+        binary_io::file_istream in(fullPath);
+        in.seek_absolute(static_cast<binary_io::streamoff>(entry.location.offset));
+        if (!outBytes->empty()) {
+            in.read_bytes(std::span<std::byte>(outBytes->data(), outBytes->size()));
+        }
+    } catch (const std::exception& ex) {
+        SetError(error, std::string("Failed to read file: ") + ex.what());
+        return false;
+    }
+    return true;
+}
+
 bool RdbTool::ParseKrdiAt(const std::vector<std::byte>& containerBytes, std::uint64_t offset,
                           ParsedKrdi* outKrdi, std::string* error) const {
     if (outKrdi == nullptr) {
@@ -977,26 +1167,28 @@ bool RdbTool::PatchEntryLocation(RdbEntry* entry, std::uint64_t newOffset, std::
     return false;
 }
 
-bool RdbTool::SaveRdb(std::string* error) {
+bool RdbTool::SaveRdb(RdbCatalog& catalog, std::string* error) {
     binary_io::memory_ostream out;
 
-    header_.fileCount = static_cast<std::uint32_t>(entries_.size());
+    RdbHeader& header = catalog.header_;
+    std::vector<RdbEntry>& entries = catalog.entries_;
+    header.fileCount = static_cast<std::uint32_t>(entries.size());
 
-    out.write_bytes(std::as_bytes(std::span(header_.magic)));
-    out.write(header_.version,
-              header_.headerSize,
-              header_.systemId,
-              header_.fileCount,
-              header_.databaseId);
-    out.write_bytes(std::as_bytes(std::span(header_.folderPathRaw)));
+    out.write_bytes(std::as_bytes(std::span(header.magic)));
+    out.write(header.version,
+              header.headerSize,
+              header.systemId,
+              header.fileCount,
+              header.databaseId);
+    out.write_bytes(std::as_bytes(std::span(header.folderPathRaw)));
 
-    for (std::size_t i = 0; i < entries_.size(); ++i) {
+    for (std::size_t i = 0; i < entries.size(); ++i) {
         while ((out.tell() & 3) != 0) {
             const std::array<std::byte, 1> pad{std::byte{0}};
             out.write_bytes(pad);
         }
 
-        RdbEntry& entry = entries_[i];
+        RdbEntry& entry = entries[i];
         entry.index = i;
         entry.entryOffsetInRdb = static_cast<std::uint64_t>(out.tell());
         entry.dataSize = entry.metadataBlock.size();
@@ -1020,7 +1212,33 @@ bool RdbTool::SaveRdb(std::string* error) {
     }
 
     const std::vector<std::byte> bytes = std::move(out.rdbuf());
-    return WriteWholeFile(rootRdbPath_, bytes, error);
+    if (!WriteWholeFile(rootRdbPath_, bytes, error)) {
+        return false;
+    }
+
+    // The file now matches the catalog exactly, so a following Reload() has nothing to re-parse.
+    RecordRdbState(bytes, bytes.size());
+    if (!QuerySourceFileState(rootRdbPath_, &rdbFileState_, error)) {
+        return false;
+    }
+    return true;
+}
+
+bool RdbTool::QuerySourceFileState(const fs::path& path, SourceFileState* outState, std::string* error) {
+    std::error_code ec;
+    const std::uint64_t size = fs::file_size(path, ec);
+    if (ec) {
+        SetError(error, "Failed to query file size: " + path.string());
+        return false;
+    }
+    const fs::file_time_type writeTime = fs::last_write_time(path, ec);
+    if (ec) {
+        SetError(error, "Failed to query file write time: " + path.string());
+        return false;
+    }
+    outState->size = size;
+    outState->writeTime = writeTime;
+    return true;
 }
 
 bool RdbTool::ReadWholeFile(const fs::path& path, std::vector<std::byte>* outBytes, std::string* error) {
@@ -1,15 +1,35 @@
 #include "RdbTool.h"
+#include "RdbExport.h"
+#include "NameHash.h"
+#include "AssetIdTable.h"
+#include "AssetLoadTrace.h"
+#include "AssetTelemetry.h"
+#include "ModAccessProfile.h"
+#include "ModDelta.h"
+#include "ModFileReader.h"
+#include "ModOverrideCache.h"
+#include "ModOverrideIndex.h"
+#include "RcuCell.h"
+#include "SortKey.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <optional>
+#include <span>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <zlib.h>
+
 #ifdef _WIN32
 #include <process.h>
 #else
@@ -187,6 +207,747 @@ int main() {
         return 1;
     }
 
+    LooseFileLoader::RdbExportOptions exportOptions{};
+    exportOptions.threadCount = 4;
+    const fs::path exportCsvPath = testRoot / "export_parallel.csv";
+    std::vector<std::byte> dumpBytes;
+    std::vector<std::byte> exportBytes;
+    if (!tool.Export(exportCsvPath, exportOptions, &error) ||
+        !ReadFileBytes(dumpPath, &dumpBytes) || !ReadFileBytes(exportCsvPath, &exportBytes) ||
+        !BytesEqual(dumpBytes, exportBytes)) {
+        std::cerr << "[FAIL] Parallel CSV export differs from Dump: " << error << "\n";
+        return 1;
+    }
+
+    // Dump goes through ExportRdbEntries, so check the CSV against the pre-export Dump format
+    // rendered by hand: hex8 ktids/flags, unpadded hex newFlags, n/a for rows without a location.
+    {
+        LooseFileLoader::RdbHeader fixtureHeader{};
+        fixtureHeader.version = 0x1e;
+        fixtureHeader.headerSize = 32;
+        fixtureHeader.systemId = 3;
+        fixtureHeader.databaseId = 0xdeadbeef;
+        fixtureHeader.folderPathRaw = {'d', 'a', 't', 'a', '\0', '\0', '\0', '\0'};
+        std::vector<LooseFileLoader::RdbEntry> fixtureEntries(2);
+        fixtureEntries[0].index = 0;
+        fixtureEntries[0].fileKtid = 0x0000abcd;
+        fixtureEntries[0].typeInfoKtid = 0x12345678;
+        fixtureEntries[0].fileSize = 4096;
+        fixtureEntries[0].flags = 0x401;
+        fixtureEntries[0].dataSize = 100;
+        fixtureEntries[0].hasLocation = true;
+        fixtureEntries[0].location.newFlags = 0x401;
+        fixtureEntries[0].location.offset = 5000000000ull;
+        fixtureEntries[0].location.sizeInContainer = 77;
+        fixtureEntries[0].location.fdataId = 2;
+        fixtureEntries[0].location.containerPath = "package/0x00000002.fdata";
+        fixtureEntries[1].index = 1;
+        fixtureEntries[1].fileKtid = 0xffffffff;
+        fixtureEntries[1].typeInfoKtid = 0x1;
+        const std::string expected =
+            "RDB Header\n"
+            "magic=_DRK\n"
+            "version=0x0000001e\n"
+            "headerSize=32\n"
+            "systemId=3\n"
+            "fileCount=2\n"
+            "databaseId=0xdeadbeef\n"
+            "folderPath=data\n"
+            "\n"
+            "index,fileKtid,typeInfoKtid,fileSize,flags,dataSize,newFlags,offset,sizeInContainer,fdataId,container\n"
+            "0,0x0000abcd,0x12345678,4096,0x00000401,100,0x401,5000000000,77,2,package/0x00000002.fdata\n"
+            "1,0xffffffff,0x00000001,0,0x00000000,0,n/a,n/a,n/a,n/a,n/a\n";
+        const fs::path fixturePath = testRoot / "export_fixture.csv";
+        std::vector<std::byte> fixtureBytes;
+        if (!LooseFileLoader::ExportRdbEntries(fixtureHeader, fixtureEntries, fixturePath, {}, &error) ||
+            !ReadFileBytes(fixturePath, &fixtureBytes) || !BytesEqual(fixtureBytes, StringToBytes(expected))) {
+            std::cerr << "[FAIL] CSV export no longer matches the Dump format: " << error << "\n";
+            return 1;
+        }
+    }
+
+    exportOptions.format = LooseFileLoader::RdbExportFormat::JsonLines;
+    exportOptions.typeInfoKtids = {tool.Entries().front().typeInfoKtid};
+    const fs::path exportJsonPath = testRoot / "export_filtered.jsonl";
+    const auto expectedJsonRows = std::count_if(tool.Entries().begin(), tool.Entries().end(), [&](const auto& entry) {
+        return entry.typeInfoKtid == exportOptions.typeInfoKtids.front();
+    });
+    if (!tool.Export(exportJsonPath, exportOptions, &error) || !ReadFileBytes(exportJsonPath, &exportBytes) ||
+        std::count(exportBytes.begin(), exportBytes.end(), std::byte{'\n'}) != expectedJsonRows) {
+        std::cerr << "[FAIL] Filtered JSON-lines export failed: " << error << "\n";
+        return 1;
+    }
+
+    exportOptions.format = LooseFileLoader::RdbExportFormat::Columnar;
+    exportOptions.typeInfoKtids.clear();
+    exportOptions.columns = LooseFileLoader::RdbExportColumn::FileKtid | LooseFileLoader::RdbExportColumn::Container;
+    const fs::path exportColumnarPath = testRoot / "export.rdbc";
+    LooseFileLoader::RdbColumnarHeader columnarHeader{};
+    if (!tool.Export(exportColumnarPath, exportOptions, &error) || !ReadFileBytes(exportColumnarPath, &exportBytes) ||
+        exportBytes.size() < sizeof(columnarHeader)) {
+        std::cerr << "[FAIL] Columnar export failed: " << error << "\n";
+        return 1;
+    }
+    std::memcpy(&columnarHeader, exportBytes.data(), sizeof(columnarHeader));
+    if (columnarHeader.rowCount != tool.Entries().size() || columnarHeader.columnCount != 2) {
+        std::cerr << "[FAIL] Columnar export header mismatch.\n";
+        return 1;
+    }
+
+    // Every row of property_hashes.csv must match the engine hash and survive a table round trip.
+    const fs::path propertyCsv = *repoRoot / "plugins/LooseFileLoader/property_hashes.csv";
+    LooseFileLoader::NameDictionaryBuilder nameBuilder;
+    const fs::path namesPath = testRoot / "property.names";
+    if (!nameBuilder.LoadCsv(propertyCsv, &error) || nameBuilder.Size() == 0 ||
+        !nameBuilder.Save(namesPath, &error)) {
+        std::cerr << "[FAIL] Building name table failed: " << error << "\n";
+        return 1;
+    }
+    const auto propertyNames = LooseFileLoader::NameDictionary::Load(namesPath, &error);
+    if (!propertyNames.has_value() || propertyNames->Size() != nameBuilder.Size()) {
+        std::cerr << "[FAIL] Loading mapped name table failed: " << error << "\n";
+        return 1;
+    }
+    {
+        std::ifstream csv(propertyCsv);
+        std::string line;
+        std::getline(csv, line);
+        while (std::getline(csv, line)) {
+            const std::size_t comma = line.find(',');
+            const std::string name = line.substr(comma + 1, line.find_last_not_of("\r") - comma);
+            const auto hash = static_cast<std::uint32_t>(std::stoul(line.substr(0, comma), nullptr, 16));
+            if (LooseFileLoader::HashName(name) != hash || propertyNames->Find(hash).empty()) {
+                std::cerr << "[FAIL] Name hash mismatch for " << name << "\n";
+                return 1;
+            }
+        }
+    }
+
+    LooseFileLoader::NameRecoveryOptions recoveryOptions{};
+    recoveryOptions.prefixes = {"Recovered"};
+    recoveryOptions.suffixes = {"_v2"};
+    recoveryOptions.threadCount = 4;
+    const std::vector<std::string> words{"Alpha", "Beta", "Gamma"};
+    const std::vector<std::uint32_t> recoveryTargets{
+        LooseFileLoader::HashName("RecoveredAlpha"),
+        LooseFileLoader::HashName("Beta_v2"),
+        LooseFileLoader::HashName("RecoveredGamma_v2"),
+        0x12345678u,
+    };
+    const auto recovered = LooseFileLoader::RecoverNames(recoveryTargets, words, recoveryOptions);
+    const auto recoveredName = [&](std::uint32_t hash) {
+        const auto it = std::find_if(recovered.begin(), recovered.end(),
+                                     [hash](const LooseFileLoader::RecoveredName& hit) { return hit.hash == hash; });
+        return it != recovered.end() ? it->name : std::string{};
+    };
+    if (recovered.size() != 3 || recoveredName(recoveryTargets[0]) != "RecoveredAlpha" ||
+        recoveredName(recoveryTargets[1]) != "Beta_v2" || recoveredName(recoveryTargets[2]) != "RecoveredGamma_v2") {
+        std::cerr << "[FAIL] Wordlist name recovery mismatch.\n";
+        return 1;
+    }
+
+    const auto unknownKtids = LooseFileLoader::CollectUnknownKtids(tool.Entries(), &*propertyNames);
+    if (unknownKtids.empty() || !std::is_sorted(unknownKtids.begin(), unknownKtids.end())) {
+        std::cerr << "[FAIL] Unknown ktid collection failed.\n";
+        return 1;
+    }
+
+    LooseFileLoader::NameDictionaryBuilder entryNameBuilder;
+    entryNameBuilder.Add(tool.Entries().front().fileKtid, "RdbToolTestFileName");
+    entryNameBuilder.Add(tool.Entries().back().fileKtid, "Rdb,\"Tool\"\nName");
+    const auto entryNames = LooseFileLoader::NameDictionary::FromImage(entryNameBuilder.Build(), &error);
+    const fs::path namedDumpPath = testRoot / "dump_named.csv";
+    std::vector<std::byte> namedDumpBytes;
+    if (!entryNames.has_value() || !tool.Dump(namedDumpPath, *entryNames, &error) ||
+        !ReadFileBytes(namedDumpPath, &namedDumpBytes)) {
+        std::cerr << "[FAIL] Named dump failed: " << error << "\n";
+        return 1;
+    }
+    const std::string namedDump(reinterpret_cast<const char*>(namedDumpBytes.data()), namedDumpBytes.size());
+    if (namedDump.find(",container,fileName,typeName\n") == std::string::npos ||
+        namedDump.find(",RdbToolTestFileName,\n") == std::string::npos ||
+        namedDump.find(",\"Rdb,\"\"Tool\"\"\nName\",\n") == std::string::npos) {
+        std::cerr << "[FAIL] Named dump is missing or misquotes name columns.\n";
+        return 1;
+    }
+
+    // The k-ary fileKtid index must agree with a plain sorted array for hits and misses.
+    const auto assetIdTable = LooseFileLoader::AssetIdTable::Build(tool.Entries());
+    {
+        std::vector<std::uint32_t> sortedKtids;
+        for (const auto& entry : tool.Entries()) {
+            sortedKtids.push_back(entry.fileKtid);
+        }
+        std::sort(sortedKtids.begin(), sortedKtids.end());
+        sortedKtids.erase(std::unique(sortedKtids.begin(), sortedKtids.end()), sortedKtids.end());
+        if (assetIdTable.KeyCount() != sortedKtids.size() ||
+            assetIdTable.TreeDepth() != LooseFileLoader::AssetIdTable::DepthForKeyCount(assetIdTable.KeyCount())) {
+            std::cerr << "[FAIL] AssetIdTable shape mismatch.\n";
+            return 1;
+        }
+        std::uint32_t probe = 0x9E3779B9u;
+        for (std::size_t i = 0; i < sortedKtids.size() * 4 + 64; ++i) {
+            probe = probe * 1664525u + 1013904223u;
+            const std::uint32_t key = (i % 2 == 0) ? sortedKtids[i / 2 % sortedKtids.size()] : probe;
+            const auto it = std::lower_bound(sortedKtids.begin(), sortedKtids.end(), key);
+            const auto position = static_cast<std::uint32_t>(it - sortedKtids.begin());
+            const std::uint32_t expected =
+                (it != sortedKtids.end() && *it == key) ? position : LooseFileLoader::AssetIdTable::kInvalidResId;
+            if (assetIdTable.LowerBound(key) != position || assetIdTable.Find(key) != expected) {
+                std::cerr << "[FAIL] AssetIdTable lookup mismatch.\n";
+                return 1;
+            }
+        }
+
+        LooseFileLoader::AssetIdManagerLayout layout{};
+        layout.sortedFileKtid = assetIdTable.SortedKeys().data();
+        layout.keyCount = assetIdTable.KeyCount();
+        layout.keyCountCopy = assetIdTable.KeyCount();
+        layout.treeDepth = assetIdTable.TreeDepth();
+        layout.branchFactor = LooseFileLoader::AssetIdTable::kBranchFactor;
+        layout.branchSpan = assetIdTable.BranchSpan();
+        layout.bucketStrideBytes = LooseFileLoader::AssetIdTable::kBucketStrideBytes;
+        const auto report = LooseFileLoader::ValidateAssetIdManagerLayout(
+            layout, [&assetIdTable](std::uint32_t fileKtid) { return assetIdTable.Find(fileKtid); });
+        if (!report.Ok() || !report.depthMatchesKeyCount || !report.strideMatchesBranchFactor ||
+            report.sampledLookups == 0) {
+            std::cerr << "[FAIL] AssetIdManager layout validation failed on the offline table.\n";
+            return 1;
+        }
+    }
+
+    {
+        // Records arrive in precedence order: the first one per fileKtid must win.
+        std::vector<LooseFileLoader::ModOverrideIndex::Record> records;
+        std::vector<std::uint32_t> overridden;
+        for (const auto& entry : tool.Entries()) {
+            if (records.size() % 3 == 0) {
+                records.push_back({entry.fileKtid, fs::path("mods") / "A" / "winner.bin", entry.fileSize, true});
+                overridden.push_back(entry.fileKtid);
+            }
+            records.push_back({entry.fileKtid, fs::path("mods") / "B" / "loser.bin", 0, false});
+            if (records.size() > 64) {
+                break;
+            }
+        }
+        std::vector<LooseFileLoader::ModOverrideConflict> conflicts;
+        const auto overrideIndex = LooseFileLoader::ModOverrideIndex::Build(records, &conflicts);
+        std::sort(overridden.begin(), overridden.end());
+        overridden.erase(std::unique(overridden.begin(), overridden.end()), overridden.end());
+        bool overridesOk = overrideIndex.Size() + conflicts.size() == records.size();
+        for (const std::uint32_t fileKtid : overridden) {
+            const auto* hit = overrideIndex.Find(fileKtid);
+            overridesOk = overridesOk && hit != nullptr && hit->valid && hit->fileKtid == fileKtid &&
+                          hit->displayPath == "mods/A/winner.bin";
+        }
+        for (const auto& entry : assetIdTable.SortedKeys()) {
+            const auto* hit = overrideIndex.Find(entry);
+            const bool expected = std::any_of(records.begin(), records.end(),
+                                              [entry](const auto& record) { return record.fileKtid == entry; });
+            overridesOk = overridesOk && (hit != nullptr) == expected;
+        }
+        if (!overridesOk || LooseFileLoader::ModOverrideIndex{}.Find(0) != nullptr) {
+            std::cerr << "[FAIL] ModOverrideIndex precedence or lookup mismatch.\n";
+            return 1;
+        }
+
+        // Cache round trip: folders, winners and conflicts come back from the mapped file, and
+        // restored entries re-check their size on open.
+        std::vector<LooseFileLoader::ModCacheFolder> cacheFolders(2);
+        cacheFolders[0].dir = testRoot / "mods";
+        cacheFolders[1].dir = testRoot / "mods" / "A";
+        cacheFolders[1].fingerprint = {0x0123456789ABCDEFll, 42, 0xDEADBEEFu};
+        cacheFolders[1].candidates = records;
+        const fs::path cachePath = testRoot / "LooseFileLoader.modcache";
+        if (!LooseFileLoader::ModOverrideCache::Save(cachePath, cacheFolders[0].dir, cacheFolders,
+                                                     overrideIndex.Overrides(), conflicts, &error)) {
+            std::cerr << "[FAIL] ModOverrideCache save failed: " << error << "\n";
+            return 1;
+        }
+        const auto cache = LooseFileLoader::ModOverrideCache::Open(cachePath, &error);
+        if (!cache.has_value()) {
+            std::cerr << "[FAIL] ModOverrideCache open failed: " << error << "\n";
+            return 1;
+        }
+        const auto cachedCandidates = cache->FolderCandidates(1);
+        const auto cachedWinners = cache->Winners();
+        const auto cachedConflicts = cache->Conflicts();
+        bool cacheOk = cache->ModsDir() == LooseFileLoader::ToCachePath(cacheFolders[0].dir) &&
+                       cache->FolderCount() == 2 && cache->FolderCandidates(0).empty() &&
+                       cache->FolderFingerprint(1) == cacheFolders[1].fingerprint &&
+                       cachedCandidates.size() == records.size() && cachedWinners.size() == overrideIndex.Size() &&
+                       cachedConflicts.size() == conflicts.size();
+        for (std::size_t i = 0; cacheOk && i < records.size(); ++i) {
+            cacheOk = cachedCandidates[i].fileKtid == records[i].fileKtid && cachedCandidates[i].path == records[i].path &&
+                      cachedCandidates[i].fileSize == records[i].fileSize && cachedCandidates[i].valid == records[i].valid &&
+                      cachedCandidates[i].verifySizeOnOpen;
+        }
+        for (std::size_t i = 0; cacheOk && i < conflicts.size(); ++i) {
+            cacheOk = cachedConflicts[i].fileKtid == conflicts[i].fileKtid && cachedConflicts[i].kept == conflicts[i].kept &&
+                      cachedConflicts[i].skipped == conflicts[i].skipped;
+        }
+        const auto restoredIndex = LooseFileLoader::ModOverrideIndex::Build(cachedWinners);
+        for (const std::uint32_t fileKtid : overridden) {
+            const auto* hit = restoredIndex.Find(fileKtid);
+            cacheOk = cacheOk && hit != nullptr && hit->displayPath == "mods/A/winner.bin" && hit->verifySizeOnOpen;
+        }
+        if (!cacheOk) {
+            std::cerr << "[FAIL] ModOverrideCache round trip mismatch.\n";
+            return 1;
+        }
+    }
+
+    {
+        // RcuCell: readers keep seeing a whole snapshot while the writer replaces it, and a
+        // replaced snapshot is only destroyed (which scrambles its check word) once no reader
+        // can still hold it.
+        struct Snapshot {
+            std::uint32_t value = 0;
+            std::uint32_t check = 0;
+            ~Snapshot() {
+                check = 0;
+            }
+        };
+        constexpr std::uint32_t kCheckMask = 0x5A5A5A5Au;
+        constexpr std::uint32_t kPublishCount = 2000;
+        LooseFileLoader::RcuCell<Snapshot> cell(std::make_unique<const Snapshot>(Snapshot{0, kCheckMask}));
+        std::atomic<bool> publishDone{false};
+        std::atomic<int> rcuFailures{0};
+        std::vector<std::thread> rcuReaders;
+        for (int i = 0; i < 3; ++i) {
+            rcuReaders.emplace_back([&]() {
+                std::uint32_t lastValue = 0;
+                do {
+                    const auto snapshot = cell.Read();
+                    const std::uint32_t value = snapshot->value;
+                    std::this_thread::yield();
+                    if (snapshot->check != (value ^ kCheckMask) || value < lastValue) {
+                        ++rcuFailures;
+                        return;
+                    }
+                    lastValue = value;
+                } while (!publishDone.load());
+            });
+        }
+        for (std::uint32_t value = 1; value <= kPublishCount; ++value) {
+            cell.Publish(std::make_unique<const Snapshot>(Snapshot{value, value ^ kCheckMask}));
+        }
+        publishDone = true;
+        for (auto& reader : rcuReaders) {
+            reader.join();
+        }
+        if (rcuFailures.load() != 0 || cell.Read()->value != kPublishCount) {
+            std::cerr << "[FAIL] RcuCell readers observed a torn or freed snapshot.\n";
+            return 1;
+        }
+    }
+
+    {
+        // SortKey: the SIMD fold must agree with the scalar tail at every length and around the
+        // ASCII letter boundaries, and keys order like an upper-casing ordinal comparison.
+        const std::u16string ascii = u"@AZ[`az{0x1234abcdEF.g1t_mods/Some-Mod_Folder~";
+        bool sortKeyOk = true;
+        for (std::size_t length = 0; length <= ascii.size(); ++length) {
+            std::u16string folded = ascii.substr(0, length);
+            std::u16string expected = folded;
+            for (char16_t& ch : expected) {
+                ch = (ch >= u'a' && ch <= u'z') ? static_cast<char16_t>(ch - 0x20) : ch;
+            }
+            sortKeyOk = sortKeyOk && LooseFileLoader::FoldAsciiUpper(folded) && folded == expected;
+        }
+        std::u16string mixed = u"abcdefghij\u00E9klmnopqrs";
+        sortKeyOk = sortKeyOk && !LooseFileLoader::FoldAsciiUpper(mixed) && mixed == u"ABCDEFGHIJ\u00E9KLMNOPQRS";
+        sortKeyOk = sortKeyOk && LooseFileLoader::MakeSortKey(u"aZ") < LooseFileLoader::MakeSortKey(u"a_") &&
+                    LooseFileLoader::MakePathSortKey(fs::path("Mod")) == LooseFileLoader::MakePathSortKey(fs::path("mOD"));
+        if (!sortKeyOk) {
+            std::cerr << "[FAIL] SortKey folding or ordering mismatch.\n";
+            return 1;
+        }
+    }
+
+    {
+        // Preload: smallest overrides first within the budget, contents byte-identical, and a
+        // file whose size no longer matches, or a compressed one, keeps streaming.
+        const fs::path preloadDir = testRoot / "preload";
+        fs::create_directories(preloadDir);
+        std::vector<LooseFileLoader::ModOverrideIndex::Record> preloadRecords;
+        const std::size_t sizes[] = {0, 40, 10, 300, 20};
+        for (std::uint32_t i = 0; i < 5; ++i) {
+            const fs::path path = preloadDir / ("0x" + std::to_string(0x100 + i) + ".bin");
+            std::ofstream(path, std::ios::binary) << std::string(sizes[i], static_cast<char>('a' + i));
+            preloadRecords.push_back({0x100 + i, path, sizes[i], true});
+        }
+        preloadRecords[1].fileSize = 41;  // stale size: must fail and keep streaming
+        const fs::path compressedPath = preloadDir / "0x105.bin.GZ";  // compressed: always streams
+        std::ofstream(compressedPath, std::ios::binary) << "12345";
+        preloadRecords.push_back({0x105, compressedPath, 5, true});
+        auto preloadIndex = LooseFileLoader::ModOverrideIndex::Build(preloadRecords);
+        const auto stats = preloadIndex.Preload(100, 64, 2);
+        bool preloadOk = stats.fileCount == 3 && stats.failedCount == 1 && stats.bytes == 30;
+        for (std::uint32_t i = 0; i < 5; ++i) {
+            const auto* entry = preloadIndex.Find(0x100 + i);
+            const bool expected = i == 0 || i == 2 || i == 4;
+            preloadOk = preloadOk && entry != nullptr && entry->preloaded == expected;
+            if (preloadOk && expected) {
+                preloadOk = entry->preloadedData.size() == sizes[i] &&
+                            std::all_of(entry->preloadedData.begin(), entry->preloadedData.end(),
+                                        [i](std::byte b) { return b == static_cast<std::byte>('a' + i); });
+            }
+        }
+        const auto* compressedEntry = preloadIndex.Find(0x105);
+        preloadOk = preloadOk && compressedEntry != nullptr && compressedEntry->compressed && !compressedEntry->preloaded;
+        if (!preloadOk) {
+            std::cerr << "[FAIL] ModOverrideIndex preload selection or contents mismatch.\n";
+            return 1;
+        }
+    }
+
+    {
+        // ModAccessProfile: a session's first hits lead, unhit entries of the previous profile
+        // follow in their old order, and the file round-trips.
+        const LooseFileLoader::ModAccessProfile previous({0x10, 0x20, 0x30, 0x40});
+        const std::uint32_t session[] = {0x30, 0x50, 0x30, 0x10};
+        const auto merged = LooseFileLoader::ModAccessProfile::Merge(session, previous);
+        const std::vector<std::uint32_t> expectedOrder = {0x30, 0x50, 0x10, 0x20, 0x40};
+        const fs::path profilePath = testRoot / "LooseFileLoader.modprofile";
+        const auto reopened = merged.Save(profilePath, &error)
+                                  ? LooseFileLoader::ModAccessProfile::Load(profilePath, &error)
+                                  : std::nullopt;
+        if (!reopened.has_value() || !std::ranges::equal(merged.Order(), expectedOrder) ||
+            !std::ranges::equal(reopened->Order(), expectedOrder) || reopened->Position(0x20) != 3 ||
+            reopened->Position(0x60) != LooseFileLoader::ModAccessProfile::kNotFound) {
+            std::cerr << "[FAIL] ModAccessProfile merge or round trip mismatch. " << error << "\n";
+            return 1;
+        }
+    }
+
+    {
+        // AssetTelemetry: concurrent per-thread recording sums exactly, latencies land in their
+        // log2 buckets, and each handler vtable is named once.
+        struct FakeHandler {
+            virtual ~FakeHandler() = default;
+        };
+        const FakeHandler handlerA;
+        const FakeHandler handlerB;
+        LooseFileLoader::AssetTelemetry telemetry;
+        constexpr std::uint64_t kSamplesPerThread = 1000;
+        std::vector<std::thread> recorders;
+        for (int t = 0; t < 3; ++t) {
+            recorders.emplace_back([&, t]() {
+                for (std::uint64_t i = 0; i < kSamplesPerThread; ++i) {
+                    // Type 0xA: vanilla 100 ns and override 3000 ns; type 0xB: vanilla 1 ms.
+                    telemetry.Record({0xA, &handlerA, 10, 100, false});
+                    telemetry.Record({0xA, t == 0 ? &handlerA : &handlerB, 20, 3000, true});
+                    telemetry.Record({0xB, &handlerB, 1, 1000000, false});
+                }
+            });
+        }
+        for (auto& recorder : recorders) {
+            recorder.join();
+        }
+        const auto snapshot = telemetry.Snapshot();
+        int resolverCalls = 0;
+        const std::string json = telemetry.ToJson(snapshot, [&resolverCalls](const void*) {
+            ++resolverCalls;
+            return std::string("FakeHandler");
+        });
+        const auto& typeA = snapshot.types.front();
+        const auto& typeB = snapshot.types.back();
+        const std::uint64_t total = 3 * kSamplesPerThread;
+        const bool telemetryOk = snapshot.threadCount == 3 && snapshot.types.size() == 2 && typeA.typeInfoKtid == 0xA &&
+                                 typeA.vanilla.count == total && typeA.vanilla.bytes == 10 * total &&
+                                 typeA.overrides.count == total && typeA.overrides.totalNanoseconds == 3000 * total &&
+                                 typeA.vanilla.histogram[7] == total && typeA.overrides.histogram[12] == total &&
+                                 typeA.overrides.PercentileNanoseconds(0.99) == 3000 && typeB.overrides.count == 0 &&
+                                 typeB.vanilla.maxNanoseconds == 1000000 && typeB.vanilla.histogram[20] == total &&
+                                 resolverCalls == 1 && json.find("\"typeInfoKtid\":\"0x0000000B\"") != std::string::npos;
+        if (!telemetryOk) {
+            std::cerr << "[FAIL] AssetTelemetry totals, buckets or JSON mismatch.\n";
+            return 1;
+        }
+    }
+
+    {
+        // ModFileReader: bytes, small reads, skips both ways and direct reads past the read-ahead
+        // buffer agree with the file, reads stop at the end, and a cached size is re-read on open.
+        const fs::path readerPath = testRoot / "0x200.bin";
+        std::vector<std::byte> readerData(300000);
+        for (std::size_t i = 0; i < readerData.size(); ++i) {
+            readerData[i] = static_cast<std::byte>((i * 131) ^ (i >> 9));
+        }
+        std::ofstream(readerPath, std::ios::binary)
+            .write(reinterpret_cast<const char*>(readerData.data()), static_cast<std::streamsize>(readerData.size()));
+        LooseFileLoader::ModOverride readerOverride{};
+        readerOverride.path = readerPath;
+        readerOverride.fileSize = 1;  // stale: re-read because verifySizeOnOpen is set
+        readerOverride.valid = true;
+        readerOverride.verifySizeOnOpen = true;
+        LooseFileLoader::ModFileReader reader(readerOverride);
+        bool readerOk = reader.IsOpen() && reader.IsRedirectable() && reader.GetFileSize() == readerData.size();
+        std::uint64_t position = 0;
+        std::vector<std::byte> got(readerData.size() + 16);
+        const auto readAndCheck = [&](std::uint64_t size) {
+            const std::uint64_t expected = std::min<std::uint64_t>(size, readerData.size() - position);
+            const std::uint64_t count = reader.Read(got.data(), 3, size);
+            readerOk = readerOk && count == expected &&
+                       std::memcmp(got.data() + 3, readerData.data() + position, static_cast<std::size_t>(count)) == 0;
+            position += count;
+        };
+        for (int i = 0; i < 5; ++i) {
+            std::uint8_t byte = 0;
+            readerOk = readerOk && reader.ReadByte(&byte) == 1 && std::byte{byte} == readerData[position];
+            ++position;
+        }
+        readAndCheck(10);
+        readAndCheck(LooseFileLoader::ModFileReader::kReadAheadBytes - 20);  // ends inside the buffer
+        readAndCheck(LooseFileLoader::ModFileReader::kReadAheadBytes + 7);   // buffered head, direct tail
+        readerOk = readerOk && reader.Skip(-100000) == -100000;
+        position -= 100000;
+        readAndCheck(3);
+        readerOk = readerOk && reader.Skip(150000) == 150000;
+        position += 150000;
+        readAndCheck(200000);  // clamped at the end
+        std::uint8_t pastEnd = 0;
+        readerOk = readerOk && reader.ReadByte(&pastEnd) == 0 && reader.Read(got.data(), 0, 1) == 0 &&
+                   reader.Skip(5) == 0 && reader.Skip(-static_cast<std::int64_t>(readerData.size()) - 5) ==
+                                              -static_cast<std::int64_t>(readerData.size());
+        position = 0;
+        readAndCheck(readerData.size());
+        reader.Close();
+        readerOk = readerOk && !reader.IsOpen() && reader.Read(got.data(), 0, 1) == 0;
+        if (!readerOk) {
+            std::cerr << "[FAIL] ModFileReader positioned reads mismatch.\n";
+            return 1;
+        }
+    }
+
+    {
+        // ModInflateReader: .gz and .zlib overrides stream the inflated bytes through ReadByte,
+        // Read, a forward Skip and backward Skips within and past the 64 KB window; the size is
+        // the gzip ISIZE, and truncated files do not serve a full payload.
+        std::vector<std::byte> payload(300000);
+        for (std::size_t i = 0; i < payload.size(); ++i) {
+            payload[i] = static_cast<std::byte>((i % 251) ^ ((i / 4096) * 37));
+        }
+        const auto compress = [&](int windowBits) {
+            std::vector<std::byte> out(compressBound(static_cast<uLong>(payload.size())) + 64);
+            z_stream zs{};
+            deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+            zs.next_in = reinterpret_cast<Bytef*>(payload.data());
+            zs.avail_in = static_cast<uInt>(payload.size());
+            zs.next_out = reinterpret_cast<Bytef*>(out.data());
+            zs.avail_out = static_cast<uInt>(out.size());
+            deflate(&zs, Z_FINISH);
+            out.resize(zs.total_out);
+            deflateEnd(&zs);
+            return out;
+        };
+        const auto openReader = [&](const fs::path& path, std::span<const std::byte> bytes,
+                                    LooseFileLoader::ModOverride& modOverride) {
+            std::ofstream(path, std::ios::binary)
+                .write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            modOverride.path = path;
+            modOverride.fileSize = bytes.size();
+            modOverride.valid = true;
+            modOverride.compressed = true;
+            return std::make_unique<LooseFileLoader::ModInflateReader>(modOverride);
+        };
+
+        bool inflateOk = true;
+        for (const auto& [name, windowBits] : {std::pair{"0x400.bin.gz", 15 + 16}, std::pair{"0x401.bin.zlib", 15}}) {
+            const std::vector<std::byte> compressed = compress(windowBits);
+            LooseFileLoader::ModOverride inflateOverride{};
+            const auto reader = openReader(testRoot / name, compressed, inflateOverride);
+            std::uint64_t expectedSize = payload.size();
+            if (windowBits > 15) {
+                const auto* isize = reinterpret_cast<const std::uint8_t*>(compressed.data() + compressed.size() - 4);
+                expectedSize = isize[0] | (isize[1] << 8) | (isize[2] << 16) | (std::uint64_t{isize[3]} << 24);
+            }
+            inflateOk = inflateOk && reader->IsOpen() && !reader->IsRedirectable() &&
+                        expectedSize == payload.size() && reader->GetFileSize() == expectedSize;
+
+            std::uint64_t position = 0;
+            std::vector<std::byte> got(payload.size());
+            const auto readAndCheck = [&](std::uint64_t size) {
+                const std::uint64_t expected = std::min<std::uint64_t>(size, payload.size() - position);
+                const std::uint64_t count = reader->Read(got.data(), 0, size);
+                inflateOk = inflateOk && count == expected &&
+                            std::memcmp(got.data(), payload.data() + position, static_cast<std::size_t>(count)) == 0;
+                position += count;
+            };
+            for (int i = 0; i < 3; ++i) {
+                std::uint8_t byte = 0;
+                inflateOk = inflateOk && reader->ReadByte(&byte) == 1 && std::byte{byte} == payload[position];
+                ++position;
+            }
+            readAndCheck(1000);
+            inflateOk = inflateOk && reader->Skip(100000) == 100000;
+            position += 100000;
+            readAndCheck(10);
+            inflateOk = inflateOk && reader->Skip(-1000) == -1000;  // inside the window
+            position -= 1000;
+            readAndCheck(10);
+            inflateOk = inflateOk && reader->Skip(-90000) == -90000;  // past the window: restarts
+            position -= 90000;
+            readAndCheck(20);
+            readAndCheck(payload.size());  // clamped at the end
+            std::uint8_t pastEnd = 0;
+            inflateOk = inflateOk && position == payload.size() && reader->ReadByte(&pastEnd) == 0;
+
+            // Half the file: zlib must inflate to the end to learn its size and fails to open; gzip
+            // still reads ISIZE from the (wrong) last four bytes, but cannot produce that many.
+            LooseFileLoader::ModOverride truncatedOverride{};
+            const auto truncated = openReader(testRoot / (std::string("truncated_") + name),
+                                              std::span(compressed).first(compressed.size() / 2), truncatedOverride);
+            if (windowBits > 15) {
+                inflateOk = inflateOk && (!truncated->IsOpen() ||
+                                          truncated->Read(got.data(), 0, got.size()) < truncated->GetFileSize());
+            } else {
+                inflateOk = inflateOk && !truncated->IsOpen();
+            }
+        }
+        if (!inflateOk) {
+            std::cerr << "[FAIL] ModInflateReader round trip, skips, size or truncation mismatch.\n";
+            return 1;
+        }
+    }
+
+    {
+        // ModDelta: in-place patches, an insertion and a removal encode to little more than the
+        // changed bytes and round-trip; ModDeltaReader streams the same output from a forward
+        // source, across backward skips in and beyond its window, and refuses another source size or
+        // another source of the same size.
+        std::vector<std::byte> original(400000);
+        std::uint32_t seed = 0x44454C54u;
+        for (auto& value : original) {
+            seed = seed * 1664525u + 1013904223u;
+            value = static_cast<std::byte>(seed >> 24);
+        }
+        std::vector<std::byte> modified = original;
+        for (std::size_t offset = 1000; offset < modified.size(); offset += 50000) {
+            modified[offset] = ~modified[offset];
+        }
+        const std::byte inserted[] = {std::byte{'m'}, std::byte{'o'}, std::byte{'d'}};
+        modified.insert(modified.begin() + 120000, std::begin(inserted), std::end(inserted));
+        modified.erase(modified.begin() + 300000, modified.begin() + 300100);
+        const auto delta = LooseFileLoader::EncodeModDelta(original, modified);
+        std::vector<std::byte> applied;
+        bool deltaOk = delta.size() < 256 && LooseFileLoader::ApplyModDelta(original, delta, &applied, &error) &&
+                       applied == modified;
+        std::vector<std::byte> otherOriginal = original;
+        otherOriginal[5] = ~otherOriginal[5];
+        deltaOk = deltaOk && !LooseFileLoader::ApplyModDelta(otherOriginal, delta, &applied);
+
+        // The game's stream for the asset: counts backward skips, which only the source check in
+        // Open and a restart may issue.
+        struct SourceStream final : LooseFileLoader::IFileStreamReader {
+            std::span<const std::byte> data{};
+            std::uint64_t position = 0;
+            int rewinds = 0;
+            void Close() override {}
+            std::int64_t Skip(std::int64_t deltaBytes) override {
+                rewinds += deltaBytes < 0 ? 1 : 0;
+                const auto target = std::clamp<std::int64_t>(static_cast<std::int64_t>(position) + deltaBytes, 0,
+                                                             static_cast<std::int64_t>(data.size()));
+                const auto moved = target - static_cast<std::int64_t>(position);
+                position = static_cast<std::uint64_t>(target);
+                return moved;
+            }
+            std::uint64_t ReadByte(std::uint8_t* outByte) override {
+                return Read(outByte, 0, 1);
+            }
+            std::uint64_t Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) override {
+                const std::uint64_t count = std::min<std::uint64_t>(size, data.size() - position);
+                std::memcpy(static_cast<std::byte*>(dst) + dstOffset, data.data() + position, static_cast<std::size_t>(count));
+                position += count;
+                return count;
+            }
+            std::uint64_t GetID() const override {
+                return 0;
+            }
+        };
+        const fs::path deltaPath = testRoot / "0x300.bin.delta";
+        std::ofstream(deltaPath, std::ios::binary)
+            .write(reinterpret_cast<const char*>(delta.data()), static_cast<std::streamsize>(delta.size()));
+        LooseFileLoader::ModOverride deltaOverride{};
+        deltaOverride.path = deltaPath;
+        deltaOverride.fileSize = delta.size();
+        deltaOverride.valid = true;
+        deltaOverride.delta = LooseFileLoader::IsDeltaOverridePath(deltaPath);
+        SourceStream source;
+        source.data = original;
+        LooseFileLoader::ModDeltaReader deltaReader(deltaOverride, source, original.size());
+        std::vector<std::byte> streamed(modified.size());
+        std::uint8_t firstByte = 0;
+        // The .delta file is not the served bytes, so GetArchiveInfo must keep the game's path.
+        deltaOk = deltaOk && deltaOverride.delta && deltaReader.IsOpen() && !deltaReader.IsRedirectable() &&
+                  deltaReader.GetFileSize() == modified.size() && deltaReader.ReadByte(&firstByte) == 1 &&
+                  std::byte{firstByte} == modified[0] && source.rewinds == 1;
+        source.rewinds = 0;
+        deltaOk = deltaOk && deltaReader.Skip(200000) == 200000 && deltaReader.Read(streamed.data(), 0, 10) == 10 &&
+                  std::memcmp(streamed.data(), modified.data() + 200001, 10) == 0 && source.rewinds == 0;
+        deltaOk = deltaOk && deltaReader.Skip(-1000) == -1000 && deltaReader.Read(streamed.data(), 0, 10) == 10 &&
+                  std::memcmp(streamed.data(), modified.data() + 199011, 10) == 0 && source.rewinds == 0;
+        deltaOk = deltaOk && deltaReader.Skip(-199021) == -199021 && deltaReader.Read(streamed.data(), 0, modified.size()) == modified.size() &&
+                  streamed == modified && source.rewinds == 1 && deltaReader.Read(streamed.data(), 0, 1) == 0;
+        SourceStream otherSource;
+        otherSource.data = std::span(original).first(original.size() - 1);
+        LooseFileLoader::ModDeltaReader mismatched(deltaOverride, otherSource, otherSource.data.size());
+        deltaOk = deltaOk && !mismatched.IsOpen() && mismatched.IsSourceMismatch() &&
+                  mismatched.GetSourceSize() == original.size();
+        SourceStream patchedSource;
+        patchedSource.data = otherOriginal;
+        LooseFileLoader::ModDeltaReader patched(deltaOverride, patchedSource, otherOriginal.size());
+        deltaOk = deltaOk && !patched.IsOpen() && patched.IsSourceMismatch() && patchedSource.position == 0;
+        if (!deltaOk) {
+            std::cerr << "[FAIL] ModDelta encode, apply or streaming mismatch. " << error << "\n";
+            return 1;
+        }
+    }
+
+    {
+        // AssetLoadTrace: records from two threads come back sorted by start time with per-thread
+        // indices, durations saturate, and a torn trailing record is dropped.
+        using Clock = LooseFileLoader::AssetLoadTrace::Clock;
+        const fs::path tracePath = testRoot / "LooseFileLoader.lftrace";
+        LooseFileLoader::AssetLoadTrace trace;
+        bool traceOk = trace.Start(tracePath, &error);
+        const auto base = Clock::now() + std::chrono::seconds(1);
+        std::vector<std::thread> loaders;
+        for (int t = 0; t < 2; ++t) {
+            loaders.emplace_back([&, t]() {
+                for (int i = 0; i < 100; ++i) {
+                    // Thread 0 takes the even microseconds, thread 1 the odd ones.
+                    const auto start = base + std::chrono::microseconds(2 * i + t);
+                    trace.Record(start, start + std::chrono::microseconds(5), 0x1000 + t, 0xABCD, 64, t == 1);
+                }
+            });
+        }
+        for (auto& loader : loaders) {
+            loader.join();
+        }
+        trace.Record(base + std::chrono::milliseconds(1), base + std::chrono::seconds(10), 0xFFFFFFFF, 0, 0, false);
+        traceOk = trace.Stop(&error) && traceOk;
+        {
+            std::ofstream torn(tracePath, std::ios::binary | std::ios::app);
+            torn.write("torn", 4);
+        }
+        const auto records = traceOk ? LooseFileLoader::AssetLoadTrace::Load(tracePath, &error) : std::nullopt;
+        traceOk = records.has_value() && records->size() == 201 && (*records)[0].threadIndex != (*records)[1].threadIndex;
+        for (std::size_t i = 0; traceOk && i < 200; ++i) {
+            const auto& record = (*records)[i];
+            const std::uint32_t t = static_cast<std::uint32_t>(i % 2);
+            const std::uint16_t flags = t == 1 ? LooseFileLoader::kAssetLoadTraceOverride : 0;
+            traceOk = record.fileKtid == 0x1000 + t && record.typeInfoKtid == 0xABCD && record.size == 64 &&
+                      record.nanoseconds == 5000 && record.flags == flags && record.threadIndex == (*records)[t].threadIndex &&
+                      (i == 0 || record.startNanoseconds == (*records)[i - 1].startNanoseconds + 1000);
+        }
+        if (!traceOk || records->back().fileKtid != 0xFFFFFFFF || records->back().nanoseconds != 0xFFFFFFFFu) {
+            std::cerr << "[FAIL] AssetLoadTrace order, fields or torn tail mismatch. " << error << "\n";
+            return 1;
+        }
+    }
+
     const auto templateKtid = PickExtractableEntry(tool, dstPackageDir, testRoot);
     if (!templateKtid.has_value()) {
         std::cerr << "[FAIL] Could not find an extractable internal entry.\n";
@@ -228,16 +989,43 @@ int main() {
         return 1;
     }
 
+    // The in-memory extract reads only the entry's block, which the replace appended at the end.
+    std::vector<std::byte> replacedPayload;
+    if (!tool.Extract(*templateKtid, &replacedPayload, &error) || !BytesEqual(replacedPayload, replacementData)) {
+        std::cerr << "[FAIL] In-memory extract of the replaced payload mismatch: " << error << "\n";
+        return 1;
+    }
+
     std::uint32_t reuseFileKtid = 0xF0ABB000u;
     while (tool.FindEntryByFileKtid(reuseFileKtid) != nullptr) {
         ++reuseFileKtid;
     }
 
+    auto watcherOpt = LooseFileLoader::RdbTool::Open(rootRdb, rootRdx, &error);
+    if (!watcherOpt.has_value()) {
+        std::cerr << "[FAIL] Open watcher failed: " << error << "\n";
+        return 1;
+    }
+    LooseFileLoader::RdbTool watcher = std::move(*watcherOpt);
+    const auto* watcherEntriesBefore = watcher.Entries().data();
+    if (!watcher.Reload(&error) || watcher.Entries().data() != watcherEntriesBefore) {
+        std::cerr << "[FAIL] Reload of an unchanged catalog was not a no-op: " << error << "\n";
+        return 1;
+    }
+
     if (!tool.Insert(reuseFileKtid, *templateKtid, true, 0, &error)) {
         std::cerr << "[FAIL] Reuse insert failed: " << error << "\n";
         return 1;
     }
 
+    const std::size_t watcherCountBefore = watcher.Entries().size();
+    if (!watcher.Reload(&error) || watcher.Entries().size() != watcherCountBefore + 1 ||
+        watcher.FindEntryByFileKtid(reuseFileKtid) == nullptr ||
+        watcher.FindEntryByFileKtid(*templateKtid) == nullptr) {
+        std::cerr << "[FAIL] Incremental reload after append failed: " << error << "\n";
+        return 1;
+    }
+
     toolOpt = LooseFileLoader::RdbTool::Open(rootRdb, rootRdx, &error);
     if (!toolOpt.has_value()) {
         std::cerr << "[FAIL] Re-open after reuse insert failed: " << error << "\n";
@@ -266,12 +1054,50 @@ int main() {
         ++newFileKtid;
     }
 
+    // Readers extract and look up through snapshots while the insert rewrites the template container.
+    const LooseFileLoader::RdbTool::CatalogPtr snapshotBefore = tool.Snapshot();
+    std::atomic<bool> insertDone{false};
+    std::atomic<int> readerFailures{0};
+    std::vector<std::thread> readers;
+    for (int readerIndex = 0; readerIndex < 3; ++readerIndex) {
+        readers.emplace_back([&, readerIndex]() {
+            const fs::path readerPath = testRoot / ("extract_concurrent_" + std::to_string(readerIndex) + ".bin");
+            do {
+                std::string readerError;
+                std::vector<std::byte> readerBytes;
+                const auto snapshot = tool.Snapshot();
+                if (snapshot->FindEntryByFileKtid(*templateKtid) == nullptr ||
+                    !tool.Extract(*templateKtid, readerPath, &readerError) ||
+                    !ReadFileBytes(readerPath, &readerBytes) || !BytesEqual(readerBytes, replacementData)) {
+                    ++readerFailures;
+                    return;
+                }
+            } while (!insertDone.load());
+        });
+    }
+
     std::vector<std::byte> insertData = StringToBytes("RDB_TOOL_INSERT_PAYLOAD_TEST_ABCDEFGHIJ");
     constexpr std::uint32_t customTypeInfo = 0xBBD39F2D;
-    if (!tool.Insert(newFileKtid, *templateKtid, insertData, customTypeInfo, false, &error)) {
+    const bool inserted = tool.Insert(newFileKtid, *templateKtid, insertData, customTypeInfo, false, &error);
+    insertDone = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    if (!inserted) {
         std::cerr << "[FAIL] Insert failed: " << error << "\n";
         return 1;
     }
+    if (readerFailures.load() != 0) {
+        std::cerr << "[FAIL] Concurrent readers observed an inconsistent catalog.\n";
+        return 1;
+    }
+    if (snapshotBefore->FindEntryByFileKtid(newFileKtid) != nullptr ||
+        snapshotBefore->FindEntryByFileKtid(*templateKtid) == nullptr ||
+        tool.Snapshot()->FindEntryByFileKtid(newFileKtid) == nullptr ||
+        tool.Snapshot()->Entries().size() != snapshotBefore->Entries().size() + 1) {
+        std::cerr << "[FAIL] Snapshot isolation across insert failed.\n";
+        return 1;
+    }
 
     toolOpt = LooseFileLoader::RdbTool::Open(rootRdb, rootRdx, &error);
     if (!toolOpt.has_value()) {
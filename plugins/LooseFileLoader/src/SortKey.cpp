@@ -0,0 +1,98 @@
+#include "SortKey.h"
+
+#include <cstdint>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <cwctype>
+#endif
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define LOOSEFILELOADER_SORT_KEY_SSE2 1
+#endif
+
+namespace LooseFileLoader {
+namespace {
+
+constexpr bool IsSurrogate(char16_t ch) {
+    return ch >= 0xD800 && ch <= 0xDFFF;
+}
+
+void FoldNonAscii(SortKey& key) {
+#ifdef _WIN32
+    const int length = static_cast<int>(key.size());
+    std::wstring upper(key.size(), L'\0');
+    const int written = LCMapStringEx(LOCALE_NAME_INVARIANT, LCMAP_UPPERCASE, reinterpret_cast<LPCWSTR>(key.data()),
+                                      length, upper.data(), length, nullptr, nullptr, 0);
+    // The invariant table maps code unit to code unit; anything else would not match the
+    // per-unit ordinal comparison, so the key keeps the ASCII-only folding instead.
+    if (written == length) {
+        key.assign(reinterpret_cast<const char16_t*>(upper.data()), upper.size());
+    }
+#else
+    for (char16_t& ch : key) {
+        if (ch < 0x80 || IsSurrogate(ch)) {
+            continue;
+        }
+        const auto upper = static_cast<std::uint32_t>(std::towupper(static_cast<std::wint_t>(ch)));
+        if (upper <= 0xFFFF && !IsSurrogate(static_cast<char16_t>(upper))) {
+            ch = static_cast<char16_t>(upper);
+        }
+    }
+#endif
+}
+
+}  // namespace
+
+bool FoldAsciiUpper(std::span<char16_t> text) {
+    char16_t* data = text.data();
+    const std::size_t size = text.size();
+    std::size_t i = 0;
+    std::uint32_t highBits = 0;
+#ifdef LOOSEFILELOADER_SORT_KEY_SSE2
+    // Signed 16-bit compares: non-ASCII units are either above 'z' or negative, never in range.
+    const __m128i below = _mm_set1_epi16('a' - 1);
+    const __m128i above = _mm_set1_epi16('z' + 1);
+    const __m128i caseBit = _mm_set1_epi16(0x20);
+    __m128i high = _mm_setzero_si128();
+    for (; i + 8 <= size; i += 8) {
+        auto* lanes = reinterpret_cast<__m128i*>(data + i);
+        const __m128i units = _mm_loadu_si128(lanes);
+        high = _mm_or_si128(high, units);
+        const __m128i lower = _mm_and_si128(_mm_cmpgt_epi16(units, below), _mm_cmpgt_epi16(above, units));
+        _mm_storeu_si128(lanes, _mm_sub_epi16(units, _mm_and_si128(lower, caseBit)));
+    }
+    const __m128i nonAscii = _mm_and_si128(high, _mm_set1_epi16(static_cast<short>(0xFF80)));
+    highBits = _mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, _mm_setzero_si128())) == 0xFFFF ? 0 : 0x80;
+#endif
+    for (; i < size; ++i) {
+        const char16_t ch = data[i];
+        highBits |= ch & 0xFF80u;
+        if (ch >= u'a' && ch <= u'z') {
+            data[i] = static_cast<char16_t>(ch - 0x20);
+        }
+    }
+    return highBits == 0;
+}
+
+SortKey MakeSortKey(std::u16string_view text) {
+    SortKey key(text);
+    if (!FoldAsciiUpper(key)) {
+        FoldNonAscii(key);
+    }
+    return key;
+}
+
+SortKey MakePathSortKey(const std::filesystem::path& path) {
+#ifdef _WIN32
+    const std::wstring& native = path.native();
+    return MakeSortKey(std::u16string_view(reinterpret_cast<const char16_t*>(native.data()), native.size()));
+#else
+    return MakeSortKey(std::u16string_view(path.u16string()));
+#endif
+}
+
+}  // namespace LooseFileLoader
@@ -0,0 +1,134 @@
+// Compares AssetIdTable lookups with std::lower_bound and std::unordered_map.
+//
+//   AssetIdTableBench <root.rdb> <root.rdx> [lookups]
+//   AssetIdTableBench --synthetic <keyCount> [lookups]
+//
+// Probes are half hits, half misses, in random order. Every method's result is checked against
+// std::lower_bound before timing.
+
+#include "AssetIdTable.h"
+#include "RdbTool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace LooseFileLoader;
+
+namespace {
+
+constexpr std::uint32_t kMissing = AssetIdTable::kInvalidResId;
+
+template <class Fn>
+double MeasureNsPerLookup(const std::vector<std::uint32_t>& probes, Fn&& lookup) {
+    // One untimed pass to warm caches and branch predictors.
+    std::uint64_t sink = 0;
+    for (const std::uint32_t probe : probes) {
+        sink += lookup(probe);
+    }
+
+    constexpr int kRounds = 5;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+        for (const std::uint32_t probe : probes) {
+            sink += lookup(probe);
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if (sink == 0x5A5A5A5A5A5A5A5Aull) {
+        std::puts("");
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (static_cast<double>(probes.size()) * kRounds);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: AssetIdTableBench <root.rdb> <root.rdx> [lookups]\n"
+                     "       AssetIdTableBench --synthetic <keyCount> [lookups]\n";
+        return 2;
+    }
+
+    std::mt19937 rng(0x4B544944u);
+    std::vector<std::uint32_t> fileKtids;
+    if (std::string_view(argv[1]) == "--synthetic") {
+        const auto keyCount = static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10));
+        fileKtids.resize(keyCount);
+        for (auto& key : fileKtids) {
+            key = rng();
+        }
+    } else {
+        std::string error;
+        const auto tool = RdbTool::Open(fs::path(argv[1]), fs::path(argv[2]), &error);
+        if (!tool.has_value()) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        for (const RdbEntry& entry : tool->Snapshot()->Entries()) {
+            fileKtids.push_back(entry.fileKtid);
+        }
+    }
+    const std::size_t lookupCount = argc > 3 ? static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10)) : 1000000;
+
+    auto buildStart = std::chrono::steady_clock::now();
+    const AssetIdTable table = AssetIdTable::Build(fileKtids);
+    const double buildMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+    if (table.KeyCount() == 0) {
+        std::cerr << "No keys.\n";
+        return 1;
+    }
+
+    const std::vector<std::uint32_t> sorted(table.SortedKeys().begin(), table.SortedKeys().end());
+    std::unordered_map<std::uint32_t, std::uint32_t> hashed;
+    hashed.reserve(sorted.size());
+    for (std::uint32_t i = 0; i < sorted.size(); ++i) {
+        hashed.emplace(sorted[i], i);
+    }
+
+    std::vector<std::uint32_t> probes(lookupCount);
+    std::uniform_int_distribution<std::size_t> pick(0, sorted.size() - 1);
+    for (std::size_t i = 0; i < probes.size(); ++i) {
+        probes[i] = (i % 2 == 0) ? sorted[pick(rng)] : static_cast<std::uint32_t>(rng());
+    }
+    std::shuffle(probes.begin(), probes.end(), rng);
+
+    const auto viaLowerBound = [&](std::uint32_t key) -> std::uint32_t {
+        const auto it = std::lower_bound(sorted.begin(), sorted.end(), key);
+        return (it != sorted.end() && *it == key) ? static_cast<std::uint32_t>(it - sorted.begin()) : kMissing;
+    };
+    const auto viaHash = [&](std::uint32_t key) -> std::uint32_t {
+        const auto it = hashed.find(key);
+        return it != hashed.end() ? it->second : kMissing;
+    };
+    const auto viaTable = [&](std::uint32_t key) -> std::uint32_t {
+        return table.Find(key);
+    };
+
+    for (const std::uint32_t probe : probes) {
+        const std::uint32_t expected = viaLowerBound(probe);
+        if (viaTable(probe) != expected || viaHash(probe) != expected) {
+            std::fprintf(stderr, "Lookup mismatch for 0x%08X\n", probe);
+            return 1;
+        }
+    }
+
+    std::printf("keys=%u depth=%u branchFactor=%u bucketStride=%u tableBytes=%zu build=%.2fms lookups=%zu\n",
+                table.KeyCount(), table.TreeDepth(), AssetIdTable::kBranchFactor, AssetIdTable::kBucketStrideBytes,
+                table.MemoryBytes(), buildMs, probes.size());
+    std::printf("AssetIdTable::Find   %7.2f ns/lookup\n", MeasureNsPerLookup(probes, viaTable));
+    std::printf("std::lower_bound     %7.2f ns/lookup\n", MeasureNsPerLookup(probes, viaLowerBound));
+    std::printf("std::unordered_map   %7.2f ns/lookup\n", MeasureNsPerLookup(probes, viaHash));
+    return 0;
+}
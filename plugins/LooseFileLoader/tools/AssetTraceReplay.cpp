@@ -0,0 +1,365 @@
+// Replays an asset load trace (EnableAssetLoadTrace, LooseFileLoader.lftrace) without the game.
+//
+//   AssetTraceReplay <trace.lftrace> <gameRootDir> [--rdb <root.rdb> <root.rdx>] [--preload-mb <MB>]
+//                    [--preload-max-kb <KB>] [--speed <factor>] [--rounds <n>]
+//
+// Every traced load is looked up in a ModAssetManager built from gameRootDir, as the
+// DeserializeAsset hook does. Hits are read to the end through the reader the hook would pick
+// (preloaded, compressed, delta or plain file); misses are extracted from the package with RdbTool
+// when --rdb is given. A delta is applied to the original extracted from the package, so without
+// --rdb delta hits count as open failures. Each traced thread gets its own replay thread running
+// its loads in their recorded order. --speed keeps the recorded pacing (1 = real time, 2 = twice
+// as fast); without it every thread runs flat out. Only the game's side of a load (parsing, GPU
+// uploads) is left out, so the numbers move with index and reader changes alone.
+//
+// Builds on Linux: it needs neither common_lib nor the game headers.
+
+#include "AssetLoadTrace.h"
+#include "ModAssetManager.h"
+#include "ModFileReader.h"
+#include "RdbTool.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace LooseFileLoader;
+
+// The plugin sources log through _MESSAGE; common_lib's file logger is Windows-only.
+void _MESSAGE(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    std::vfprintf(stderr, fmt, args);
+    va_end(args);
+    std::fputc('\n', stderr);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::uint32_t kUnknownFileKtid = 0xFFFFFFFF;
+constexpr std::size_t kReadChunkBytes = 64 * 1024;
+
+struct Options {
+    fs::path tracePath{};
+    fs::path gameRootDir{};
+    fs::path rootRdbPath{};
+    fs::path rootRdxPath{};
+    std::uint64_t preloadBudgetMB = 0;
+    std::uint64_t preloadMaxFileKB = 256;
+    double speed = 0.0;
+    int rounds = 1;
+};
+
+enum class Operation : std::size_t {
+    Lookup,
+    OverrideRead,
+    VanillaExtract,
+    Count,
+};
+
+constexpr std::array<const char*, static_cast<std::size_t>(Operation::Count)> kOperationNames{
+    "lookup", "override read", "vanilla extract"};
+
+struct OperationStats {
+    std::vector<std::uint64_t> nanoseconds{};
+    std::uint64_t bytes = 0;
+
+    void Add(std::uint64_t elapsed, std::uint64_t byteCount) {
+        nanoseconds.push_back(elapsed);
+        bytes += byteCount;
+    }
+};
+
+struct ThreadResult {
+    std::array<OperationStats, static_cast<std::size_t>(Operation::Count)> operations{};
+    // Loads whose override decision differs from the trace: the mods tree has changed since.
+    std::size_t hitMismatches = 0;
+    std::size_t openFailures = 0;
+    std::size_t extractFailures = 0;
+    std::size_t unknownFileKtids = 0;
+};
+
+std::uint64_t ElapsedNs(Clock::time_point start) {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+// Reads the whole stream the way Deserialize consumes it, in sequential chunks.
+std::uint64_t Drain(ModStreamReader& reader, std::vector<std::byte>& buffer) {
+    std::uint64_t total = 0;
+    while (true) {
+        const std::uint64_t read = reader.Read(buffer.data(), 0, buffer.size());
+        if (read == 0) {
+            break;
+        }
+        total += read;
+    }
+    return total;
+}
+
+// Plays the game's stream for the original of a delta override.
+class PayloadStream final : public IFileStreamReader {
+public:
+    explicit PayloadStream(std::span<const std::byte> data) : data_(data) {}
+
+    void Close() override {}
+    std::int64_t Skip(std::int64_t deltaBytes) override {
+        const auto current = static_cast<std::int64_t>(position_);
+        const std::int64_t target = std::clamp(current + deltaBytes, std::int64_t{0}, static_cast<std::int64_t>(data_.size()));
+        position_ = static_cast<std::uint64_t>(target);
+        return target - current;
+    }
+    std::uint64_t ReadByte(std::uint8_t* outByte) override {
+        return Read(outByte, 0, 1);
+    }
+    std::uint64_t Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) override {
+        const std::uint64_t count = std::min<std::uint64_t>(size, data_.size() - position_);
+        std::memcpy(static_cast<std::byte*>(dst) + dstOffset, data_.data() + position_, static_cast<std::size_t>(count));
+        position_ += count;
+        return count;
+    }
+    std::uint64_t GetID() const override {
+        return 0;
+    }
+
+private:
+    std::span<const std::byte> data_{};
+    std::uint64_t position_ = 0;
+};
+
+std::uint64_t ReadOverride(const ModOverride& modOverride, const RdbTool* rdb, std::vector<std::byte>& payload,
+                           std::vector<std::byte>& buffer, bool* outOpened) {
+    std::optional<ModMemoryReader> memoryReader;
+    std::optional<ModInflateReader> inflateReader;
+    std::optional<PayloadStream> original;
+    std::optional<ModDeltaReader> deltaReader;
+    std::optional<ModFileReader> fileReader;
+    ModStreamReader* reader = nullptr;
+    if (modOverride.preloaded) {
+        reader = &memoryReader.emplace(modOverride);
+    } else if (modOverride.compressed) {
+        reader = &inflateReader.emplace(modOverride);
+    } else if (modOverride.delta) {
+        if (rdb == nullptr || !rdb->Extract(modOverride.fileKtid, &payload)) {
+            *outOpened = false;
+            return 0;
+        }
+        reader = &deltaReader.emplace(modOverride, original.emplace(payload), payload.size());
+    } else {
+        reader = &fileReader.emplace(modOverride);
+    }
+    *outOpened = reader->IsOpen();
+    return *outOpened ? Drain(*reader, buffer) : 0;
+}
+
+void ReplayThread(const std::vector<const AssetLoadTraceRecord*>& records, const ModAssetManager& overrides,
+                  const RdbTool* rdb, double speed, Clock::time_point origin, ThreadResult& result) {
+    std::vector<std::byte> buffer(kReadChunkBytes);
+    std::vector<std::byte> payload;
+    auto& lookups = result.operations[static_cast<std::size_t>(Operation::Lookup)];
+    auto& overrideReads = result.operations[static_cast<std::size_t>(Operation::OverrideRead)];
+    auto& vanillaExtracts = result.operations[static_cast<std::size_t>(Operation::VanillaExtract)];
+    for (const AssetLoadTraceRecord* record : records) {
+        if (speed > 0.0) {
+            std::this_thread::sleep_until(
+                origin + std::chrono::nanoseconds(static_cast<std::int64_t>(static_cast<double>(record->startNanoseconds) / speed)));
+        }
+        const bool tracedHit = (record->flags & kAssetLoadTraceOverride) != 0;
+        if (record->fileKtid == kUnknownFileKtid) {
+            ++result.unknownFileKtids;
+            continue;
+        }
+
+        auto start = Clock::now();
+        const auto index = overrides.Acquire();
+        const ModOverride* modOverride = index->Find(record->fileKtid);
+        const bool hit = modOverride != nullptr && modOverride->valid;
+        lookups.Add(ElapsedNs(start), 0);
+        result.hitMismatches += hit != tracedHit ? 1 : 0;
+
+        if (hit) {
+            start = Clock::now();
+            bool opened = false;
+            const std::uint64_t bytes = ReadOverride(*modOverride, rdb, payload, buffer, &opened);
+            if (opened) {
+                overrideReads.Add(ElapsedNs(start), bytes);
+            } else {
+                ++result.openFailures;
+            }
+        } else if (rdb != nullptr) {
+            start = Clock::now();
+            if (rdb->Extract(record->fileKtid, &payload)) {
+                vanillaExtracts.Add(ElapsedNs(start), payload.size());
+            } else {
+                ++result.extractFailures;
+            }
+        }
+    }
+}
+
+double Percentile(const std::vector<std::uint64_t>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const auto rank = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+    return static_cast<double>(sorted[rank]) / 1000.0;
+}
+
+void PrintStats(const char* name, std::vector<std::uint64_t> nanoseconds, std::uint64_t bytes) {
+    if (nanoseconds.empty()) {
+        std::printf("  %-16s count=0\n", name);
+        return;
+    }
+    std::sort(nanoseconds.begin(), nanoseconds.end());
+    std::uint64_t total = 0;
+    for (const std::uint64_t value : nanoseconds) {
+        total += value;
+    }
+    const double totalMs = static_cast<double>(total) / 1e6;
+    std::printf("  %-16s count=%zu bytes=%llu total=%.2f ms p50=%.2f us p99=%.2f us p99.9=%.2f us max=%.2f us",
+                name, nanoseconds.size(), static_cast<unsigned long long>(bytes), totalMs, Percentile(nanoseconds, 0.5),
+                Percentile(nanoseconds, 0.99), Percentile(nanoseconds, 0.999), Percentile(nanoseconds, 1.0));
+    if (bytes != 0 && totalMs > 0.0) {
+        std::printf(" (%.1f MB/s per thread)", static_cast<double>(bytes) / (1024.0 * 1024.0) / (totalMs / 1000.0));
+    }
+    std::printf("\n");
+}
+
+std::optional<Options> ParseOptions(int argc, char** argv) {
+    if (argc < 3) {
+        return std::nullopt;
+    }
+    Options options;
+    options.tracePath = argv[1];
+    options.gameRootDir = argv[2];
+    for (int i = 3; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--rdb" && i + 2 < argc) {
+            options.rootRdbPath = argv[++i];
+            options.rootRdxPath = argv[++i];
+        } else if (arg == "--preload-mb" && i + 1 < argc) {
+            options.preloadBudgetMB = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--preload-max-kb" && i + 1 < argc) {
+            options.preloadMaxFileKB = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--speed" && i + 1 < argc) {
+            options.speed = std::max(0.0, std::strtod(argv[++i], nullptr));
+        } else if (arg == "--rounds" && i + 1 < argc) {
+            options.rounds = std::max(1, std::atoi(argv[++i]));
+        } else {
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const auto options = ParseOptions(argc, argv);
+    if (!options.has_value()) {
+        std::cerr << "Usage: AssetTraceReplay <trace.lftrace> <gameRootDir> [--rdb <root.rdb> <root.rdx>]\n"
+                     "                        [--preload-mb <MB>] [--preload-max-kb <KB>] [--speed <factor>] [--rounds <n>]\n";
+        return 2;
+    }
+
+    std::string error;
+    const auto records = AssetLoadTrace::Load(options->tracePath, &error);
+    if (!records.has_value()) {
+        std::cerr << error << '\n';
+        return 1;
+    }
+
+    std::optional<RdbTool> rdb;
+    if (!options->rootRdbPath.empty()) {
+        rdb = RdbTool::Open(options->rootRdbPath, options->rootRdxPath, &error);
+        if (!rdb.has_value()) {
+            std::cerr << error << '\n';
+            return 1;
+        }
+    }
+
+    ModAssetManager overrides;
+    overrides.SetPreloadBudget(options->preloadBudgetMB << 20, options->preloadMaxFileKB << 10);
+    auto start = Clock::now();
+    overrides.Build(options->gameRootDir);
+    const double buildMs = static_cast<double>(ElapsedNs(start)) / 1e6;
+
+    // Loads per traced thread, in start order (Load sorts the trace).
+    std::map<std::uint16_t, std::vector<const AssetLoadTraceRecord*>> byThread;
+    std::uint64_t tracedNanoseconds = 0;
+    std::size_t tracedHits = 0;
+    for (const AssetLoadTraceRecord& record : *records) {
+        byThread[record.threadIndex].push_back(&record);
+        tracedHits += (record.flags & kAssetLoadTraceOverride) != 0 ? 1 : 0;
+    }
+    if (!records->empty()) {
+        tracedNanoseconds = records->back().startNanoseconds;
+    }
+    std::printf("trace: %zu loads (%zu override hits) on %zu threads over %.2f s\n", records->size(), tracedHits,
+                byThread.size(), static_cast<double>(tracedNanoseconds) / 1e9);
+    std::printf("index: %zu overrides, built in %.2f ms\n", overrides.Acquire()->Size(), buildMs);
+
+    int exitCode = 0;
+    for (int round = 0; round < options->rounds; ++round) {
+        std::vector<ThreadResult> results(byThread.size());
+        std::vector<std::thread> threads;
+        threads.reserve(byThread.size());
+        start = Clock::now();
+        std::size_t slot = 0;
+        for (const auto& [threadIndex, threadRecords] : byThread) {
+            threads.emplace_back(ReplayThread, std::cref(threadRecords), std::cref(overrides),
+                                 rdb.has_value() ? &*rdb : nullptr, options->speed, start, std::ref(results[slot++]));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const double wallMs = static_cast<double>(ElapsedNs(start)) / 1e6;
+
+        ThreadResult total;
+        for (ThreadResult& result : results) {
+            for (std::size_t i = 0; i < total.operations.size(); ++i) {
+                auto& from = result.operations[i];
+                total.operations[i].nanoseconds.insert(total.operations[i].nanoseconds.end(), from.nanoseconds.begin(),
+                                                       from.nanoseconds.end());
+                total.operations[i].bytes += from.bytes;
+            }
+            total.hitMismatches += result.hitMismatches;
+            total.openFailures += result.openFailures;
+            total.extractFailures += result.extractFailures;
+            total.unknownFileKtids += result.unknownFileKtids;
+        }
+
+        std::uint64_t bytes = 0;
+        for (const auto& operation : total.operations) {
+            bytes += operation.bytes;
+        }
+        std::printf("round %d: wall=%.2f ms, %.1f loads/s, %.1f MB/s\n", round + 1, wallMs,
+                    static_cast<double>(records->size()) / (wallMs / 1000.0),
+                    static_cast<double>(bytes) / (1024.0 * 1024.0) / (wallMs / 1000.0));
+        for (std::size_t i = 0; i < total.operations.size(); ++i) {
+            PrintStats(kOperationNames[i], std::move(total.operations[i].nanoseconds), total.operations[i].bytes);
+        }
+        std::printf("  hit mismatches=%zu, open failures=%zu, extract failures=%zu, unknown fileKtids=%zu\n",
+                    total.hitMismatches, total.openFailures, total.extractFailures, total.unknownFileKtids);
+        if (total.openFailures != 0) {
+            exitCode = 1;
+        }
+    }
+    return exitCode;
+}
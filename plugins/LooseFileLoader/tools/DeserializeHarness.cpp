@@ -0,0 +1,591 @@
+// Load-tests the DeserializeAsset hook body (AssetDeserializer.h) without the game.
+//
+//   DeserializeHarness [--threads <n>] [--assets <n>] [--overrides <n>] [--loads <perThread>]
+//                      [--size-kb <KB>] [--compressed <percent>] [--delta <percent>]
+//                      [--preload-mb <MB>] [--preload-max-kb <KB>] [--root <dir>] [--keep]
+//
+// Writes a synthetic mods tree (overrides of sizes spread around --size-kb, --compressed percent
+// of them gzip, --delta percent of them ModDelta patches of the vanilla payload), builds the
+// override index from it, and runs --threads loader threads. Each load
+// goes through DeserializeAsset with stand-in game objects: a FakeAssetReader whose own stream
+// plays the vanilla archive, and a FakeAssetHandler whose Deserialize consumes the stream the
+// way handlers do (single bytes, a header, a forward and a backward Skip, then chunked reads) and
+// checks the size and content it got. 80% of loads hit the hottest 20% of assets. Reports
+// throughput, per-path latency percentiles and operator new calls per load.
+//
+// Builds on Linux: game functions are never called, so relocations resolve to stubs.
+
+#include "AssetDeserializer.h"
+#include "ModAssetManager.h"
+#include "ModDelta.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <zlib.h>
+
+namespace fs = std::filesystem;
+using namespace LooseFileLoader;
+
+// Relocation stubs: the harness never reaches game code, but Common.h's relocations are resolved
+// during static initialization.
+std::uintptr_t RelocationManager::s_baseAddr = 0;
+std::uintptr_t REL::Pattern::address() const {
+    return 0;
+}
+
+// The plugin logs every override load; formatting is kept, the output is dropped.
+void _MESSAGE(const char* fmt, ...) {
+    char buffer[1024];
+    va_list args;
+    va_start(args, fmt);
+    std::vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+}
+
+namespace {
+
+thread_local std::uint64_t t_allocations = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+    ++t_allocations;
+    if (void* memory = std::malloc(size != 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    ++t_allocations;
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::uint32_t kFirstFileKtid = 0x10000000;
+constexpr std::uint32_t kFakeTypeInfoKtid = 0x0BADF00D;
+constexpr std::size_t kHandlerChunkBytes = 16 * 1024;
+constexpr std::size_t kHandlerHeaderBytes = 32;
+
+struct Options {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t assets = 20000;
+    std::size_t overrides = 2000;
+    std::size_t loadsPerThread = 20000;
+    std::uint64_t sizeKB = 64;
+    unsigned compressedPercent = 10;
+    unsigned deltaPercent = 0;
+    std::uint64_t preloadBudgetMB = 0;
+    std::uint64_t preloadMaxFileKB = 256;
+    fs::path root{};
+    bool keep = false;
+};
+
+// Deterministic content in runs of 7 bytes (so gzip has something to do), for checking what a
+// handler was served.
+std::byte ContentByte(std::uint32_t fileKtid, std::uint64_t offset) {
+    return static_cast<std::byte>((fileKtid * 0x9E3779B1u ^ static_cast<std::uint32_t>(offset / 7) * 0x01000193u) >> 24);
+}
+
+std::uint64_t Fnv1a(std::uint64_t hash, std::span<const std::byte> bytes) {
+    for (const std::byte value : bytes) {
+        hash = (hash ^ static_cast<std::uint8_t>(value)) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+constexpr std::uint64_t kFnvOffset = 0xCBF29CE484222325ull;
+
+bool WriteGzip(const fs::path& path, std::span<const std::byte> data) {
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    std::vector<std::byte> out(deflateBound(&stream, static_cast<uLong>(data.size())));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<std::byte*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef*>(out.data());
+    stream.avail_out = static_cast<uInt>(out.size());
+    const int result = deflate(&stream, Z_FINISH);
+    const std::size_t written = out.size() - stream.avail_out;
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END) {
+        return false;
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(written));
+    return static_cast<bool>(file);
+}
+
+struct Expected {
+    std::uint64_t size = 0;
+    std::uint64_t hash = 0;
+    // What the archive stream serves: the vanilla payload, also for a delta override.
+    std::uint64_t archiveSize = 0;
+    bool isOverride = false;
+};
+
+// fileKtid -> what a load of it must deliver. Vanilla assets are served from a shared blob.
+struct Catalog {
+    std::unordered_map<std::uint32_t, Expected> assets{};
+    std::vector<std::byte> vanillaBlob{};
+    std::size_t compressedCount = 0;
+    std::size_t deltaCount = 0;
+    std::uint64_t overrideBytes = 0;
+};
+
+std::optional<Catalog> WriteModsTree(const Options& options, std::string* error) {
+    Catalog catalog;
+    std::mt19937 rng(0x4841524Eu);
+    // Sizes spread over [size/4, 4*size): a few small, a few large files per folder.
+    std::uniform_real_distribution<double> scale(-2.0, 2.0);
+    const auto pickSize = [&]() {
+        return static_cast<std::uint64_t>(static_cast<double>(options.sizeKB * 1024) * std::exp2(scale(rng)));
+    };
+
+    std::uint64_t maxVanilla = 0;
+    std::vector<std::uint64_t> sizes(options.assets);
+    for (auto& size : sizes) {
+        size = std::max<std::uint64_t>(kHandlerHeaderBytes, pickSize());
+        maxVanilla = std::max(maxVanilla, size);
+    }
+    catalog.vanillaBlob.resize(maxVanilla);
+    for (std::size_t i = 0; i < catalog.vanillaBlob.size(); ++i) {
+        catalog.vanillaBlob[i] = ContentByte(0, i);
+    }
+
+    std::vector<std::size_t> order(options.assets);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+    const std::size_t overrideCount = std::min(options.overrides, options.assets);
+
+    std::vector<std::byte> content;
+    char name[32];
+    for (std::size_t i = 0; i < options.assets; ++i) {
+        const auto fileKtid = static_cast<std::uint32_t>(kFirstFileKtid + i);
+        Expected& expected = catalog.assets[fileKtid];
+        expected.size = sizes[i];
+        expected.archiveSize = sizes[i];
+        expected.hash = Fnv1a(kFnvOffset, std::span(catalog.vanillaBlob).first(expected.size));
+    }
+    for (std::size_t n = 0; n < overrideCount; ++n) {
+        const std::size_t i = order[n];
+        const auto fileKtid = static_cast<std::uint32_t>(kFirstFileKtid + i);
+        Expected& expected = catalog.assets[fileKtid];
+        const bool compressed = rng() % 100 < options.compressedPercent;
+        const bool delta = !compressed && rng() % 100 < options.deltaPercent;
+        if (delta) {
+            // A few bytes patched every 4 KB and a short insertion, on top of the vanilla payload.
+            const auto vanilla = std::span(catalog.vanillaBlob).first(expected.archiveSize);
+            content.assign(vanilla.begin(), vanilla.end());
+            for (std::size_t offset = 100; offset < content.size(); offset += 4096) {
+                content[offset] = ContentByte(fileKtid, offset);
+            }
+            content.insert(content.begin() + static_cast<std::ptrdiff_t>(content.size() / 2), 24, std::byte{0x5A});
+            expected.size = content.size();
+        } else {
+            expected.archiveSize = 0;
+            expected.size = std::max<std::uint64_t>(kHandlerHeaderBytes, pickSize());
+            content.resize(expected.size);
+            for (std::size_t offset = 0; offset < content.size(); ++offset) {
+                content[offset] = ContentByte(fileKtid, offset);
+            }
+        }
+        expected.hash = Fnv1a(kFnvOffset, content);
+        expected.isOverride = true;
+        catalog.overrideBytes += expected.size;
+
+        const fs::path folder = options.root / "mods" / ("HarnessMod" + std::to_string(n % 8));
+        std::error_code ec;
+        fs::create_directories(folder, ec);
+        std::snprintf(name, sizeof(name), compressed ? "0x%08X.bin.gz" : delta ? "0x%08X.bin.delta" : "0x%08X.bin",
+                      fileKtid);
+        if (delta) {
+            ++catalog.deltaCount;
+            const auto vanilla = std::span(catalog.vanillaBlob).first(expected.archiveSize);
+            const std::vector<std::byte> patch = EncodeModDelta(vanilla, content);
+            std::ofstream file(folder / name, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(patch.data()), static_cast<std::streamsize>(patch.size()));
+            if (!file) {
+                *error = "Failed to write " + (folder / name).string();
+                return std::nullopt;
+            }
+        } else if (compressed) {
+            ++catalog.compressedCount;
+            if (!WriteGzip(folder / name, content)) {
+                *error = "Failed to write " + (folder / name).string();
+                return std::nullopt;
+            }
+        } else {
+            std::ofstream file(folder / name, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+            if (!file) {
+                *error = "Failed to write " + (folder / name).string();
+                return std::nullopt;
+            }
+        }
+    }
+    return catalog;
+}
+
+// The archive side of a vanilla load: the first size bytes of the shared blob.
+class FakeArchiveStream final : public IFileStreamReader {
+public:
+    explicit FakeArchiveStream(std::span<const std::byte> data) : data_(data) {}
+
+    void Close() override {}
+
+    std::int64_t Skip(std::int64_t deltaBytes) override {
+        const auto current = static_cast<std::int64_t>(position_);
+        const std::int64_t target = std::clamp(current + deltaBytes, std::int64_t{0}, static_cast<std::int64_t>(data_.size()));
+        position_ = static_cast<std::uint64_t>(target);
+        return target - current;
+    }
+
+    std::uint64_t ReadByte(std::uint8_t* outByte) override {
+        return Read(outByte, 0, 1);
+    }
+
+    std::uint64_t Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) override {
+        const std::uint64_t toRead = std::min<std::uint64_t>(size, data_.size() - position_);
+        std::memcpy(static_cast<std::byte*>(dst) + dstOffset, data_.data() + position_, static_cast<std::size_t>(toRead));
+        position_ += toRead;
+        return toRead;
+    }
+
+    std::uint64_t GetID() const override {
+        return 0x4641524348495645ull;
+    }
+
+private:
+    std::span<const std::byte> data_{};
+    std::uint64_t position_ = 0;
+};
+
+// Stands in for the game's AssetReader, which forwards to its current streamReader; the hook
+// swaps that for a mod reader.
+class FakeAssetReader final : public AssetReader {
+public:
+    FakeAssetReader(IFileStreamReader& archiveStream, std::uint64_t size) {
+        archiveManager = nullptr;
+        streamReader = &archiveStream;
+        archiveFileHandle = 0;
+        archiveFileOffset = 0;
+        assetFileSize = size;
+    }
+
+    void Close() override {
+        streamReader->Close();
+    }
+    std::int64_t Skip(std::int64_t deltaBytes) override {
+        return streamReader->Skip(deltaBytes);
+    }
+    std::uint64_t ReadByte(std::uint8_t* outByte) override {
+        return streamReader->ReadByte(outByte);
+    }
+    std::uint64_t Read(void* dst, std::uint64_t dstOffset, std::uint64_t size) override {
+        return streamReader->Read(dst, dstOffset, size);
+    }
+    std::uint64_t GetID() const override {
+        return 0x4153534554524452ull;
+    }
+};
+
+struct LoadResult {
+    std::uint64_t bytes = 0;
+    std::uint64_t hash = kFnvOffset;
+};
+
+class FakeAssetHandler final : public IBaseGameAssetHandler {
+public:
+    void Unk00() override {}
+    void Unk08() override {}
+    uint32_t ResolveFields(ObjectField*, uint32_t, uint32_t) override {
+        return 0;
+    }
+    const char*& GetTypeName(const char*& typeNameOut) const override {
+        typeNameOut = "FakeAssetHandler";
+        return typeNameOut;
+    }
+    std::uint32_t GetTypeID() override {
+        return kFakeTypeInfoKtid;
+    }
+    void Unk28() override {}
+    void Unk30() override {}
+    void Unk38() override {}
+    void Unk40() override {}
+    void Unk48() override {}
+    void Unk50() override {}
+    void Unk58() override {}
+    void Unk60() override {}
+    void Unk68() override {}
+    void Unk70() override {}
+    void Unk78() override {}
+    void Unk80() override {}
+    void Unk88() override {}
+    void Unk90() override {}
+    void Unk98() override {}
+    void UnkA0() override {}
+    void UnkA8() override {}
+
+    // Consumes the whole stream into the thread's LoadResult; returns it as the "asset".
+    void* Deserialize(AssetLoadingContext*, IFileStreamReader* reader, void* param3) override {
+        thread_local std::array<std::byte, kHandlerChunkBytes> chunk{};
+        auto* result = static_cast<LoadResult*>(param3);
+        *result = {};
+        // Magic bytes one at a time, then the rest of the header.
+        std::uint8_t value = 0;
+        for (std::size_t i = 0; i < 4; ++i) {
+            if (reader->ReadByte(&value) != 1) {
+                return nullptr;
+            }
+            const std::byte byte{value};
+            result->hash = Fnv1a(result->hash, std::span(&byte, 1));
+        }
+        if (reader->Read(chunk.data(), 0, kHandlerHeaderBytes - 4) != kHandlerHeaderBytes - 4) {
+            return nullptr;
+        }
+        result->hash = Fnv1a(result->hash, std::span(chunk).first(kHandlerHeaderBytes - 4));
+        result->bytes = kHandlerHeaderBytes;
+        // Peek ahead and come back, as handlers do for section tables.
+        const std::int64_t ahead = reader->Skip(512);
+        if (reader->Skip(-ahead) != -ahead) {
+            return nullptr;
+        }
+        while (true) {
+            const std::uint64_t read = reader->Read(chunk.data(), 0, chunk.size());
+            if (read == 0) {
+                break;
+            }
+            result->hash = Fnv1a(result->hash, std::span(chunk).first(static_cast<std::size_t>(read)));
+            result->bytes += read;
+        }
+        return result;
+    }
+};
+
+struct PathStats {
+    std::vector<std::uint64_t> nanoseconds{};
+    std::uint64_t bytes = 0;
+    std::uint64_t allocations = 0;
+};
+
+struct ThreadStats {
+    PathStats overrides{};
+    PathStats vanilla{};
+    std::size_t failures = 0;
+};
+
+void LoaderThread(const std::vector<std::uint32_t>& fileKtids, const Catalog& catalog, FakeAssetHandler& handler,
+                  ThreadStats& stats) {
+    stats.overrides.nanoseconds.reserve(fileKtids.size());
+    stats.vanilla.nanoseconds.reserve(fileKtids.size());
+    for (const std::uint32_t fileKtid : fileKtids) {
+        const Expected& expected = catalog.assets.at(fileKtid);
+        GameAsset gameAsset{};
+        gameAsset.typeInfoKtid = kFakeTypeInfoKtid;
+        gameAsset.fileKtid = fileKtid;
+        AssetLoadingContext loadingContext{};
+        loadingContext.gameAsset = &gameAsset;
+        FakeArchiveStream archiveStream(std::span(catalog.vanillaBlob).first(expected.archiveSize));
+        FakeAssetReader assetReader(archiveStream, expected.archiveSize);
+        LoadResult result;
+
+        const std::uint64_t allocationsBefore = t_allocations;
+        const auto start = Clock::now();
+        void* asset = DeserializeAsset(&handler, &loadingContext, &assetReader, &result, fileKtid);
+        const auto elapsed = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        PathStats& path = expected.isOverride ? stats.overrides : stats.vanilla;
+        path.nanoseconds.push_back(elapsed);
+        path.bytes += result.bytes;
+        path.allocations += t_allocations - allocationsBefore;
+        if (asset == nullptr || result.bytes != expected.size || result.hash != expected.hash) {
+            ++stats.failures;
+        }
+    }
+}
+
+double PercentileUs(const std::vector<std::uint64_t>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const auto rank = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+    return static_cast<double>(sorted[rank]) / 1000.0;
+}
+
+void PrintPath(const char* name, PathStats& stats) {
+    std::sort(stats.nanoseconds.begin(), stats.nanoseconds.end());
+    const std::size_t count = stats.nanoseconds.size();
+    std::printf("  %-9s count=%zu bytes=%llu p50=%.2f us p99=%.2f us p99.9=%.2f us max=%.2f us new/load=%.2f\n", name,
+                count, static_cast<unsigned long long>(stats.bytes), PercentileUs(stats.nanoseconds, 0.5),
+                PercentileUs(stats.nanoseconds, 0.99), PercentileUs(stats.nanoseconds, 0.999),
+                PercentileUs(stats.nanoseconds, 1.0),
+                count != 0 ? static_cast<double>(stats.allocations) / static_cast<double>(count) : 0.0);
+}
+
+std::optional<Options> ParseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--keep") {
+            options.keep = true;
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--assets" && hasValue) {
+            options.assets = std::max<std::size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--overrides" && hasValue) {
+            options.overrides = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--loads" && hasValue) {
+            options.loadsPerThread = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--size-kb" && hasValue) {
+            options.sizeKB = std::max<std::uint64_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        } else if (arg == "--compressed" && hasValue) {
+            options.compressedPercent = std::min(100u, static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10)));
+        } else if (arg == "--delta" && hasValue) {
+            options.deltaPercent = std::min(100u, static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10)));
+        } else if (arg == "--preload-mb" && hasValue) {
+            options.preloadBudgetMB = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--preload-max-kb" && hasValue) {
+            options.preloadMaxFileKB = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--root" && hasValue) {
+            options.root = argv[++i];
+        } else {
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto options = ParseOptions(argc, argv);
+    if (!options.has_value()) {
+        std::cerr << "Usage: DeserializeHarness [--threads <n>] [--assets <n>] [--overrides <n>] [--loads <perThread>]\n"
+                     "                          [--size-kb <KB>] [--compressed <percent>] [--delta <percent>]\n"
+                     "                          [--preload-mb <MB>] [--preload-max-kb <KB>] [--root <dir>] [--keep]\n";
+        return 2;
+    }
+    if (options->root.empty()) {
+        options->root = fs::temp_directory_path() / "LooseFileLoader_DeserializeHarness";
+    }
+    std::error_code ec;
+    fs::remove_all(options->root / "mods", ec);
+
+    std::string error;
+    auto start = Clock::now();
+    const auto catalog = WriteModsTree(*options, &error);
+    if (!catalog.has_value()) {
+        std::cerr << error << '\n';
+        return 1;
+    }
+    const double writeMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    g_modAssetManager.SetPreloadBudget(options->preloadBudgetMB << 20, options->preloadMaxFileKB << 10);
+    start = Clock::now();
+    g_modAssetManager.Build(options->root);
+    const double buildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::printf("tree: %zu assets, %zu overrides (%zu gzip, %zu delta, %.1f MB) written in %.0f ms, index built in %.2f ms\n",
+                options->assets, std::min(options->overrides, options->assets), catalog->compressedCount, catalog->deltaCount,
+                static_cast<double>(catalog->overrideBytes) / (1024.0 * 1024.0), writeMs, buildMs);
+
+    // Load sequences are drawn before timing: 80% from the hottest 20% of assets.
+    std::vector<std::vector<std::uint32_t>> sequences(options->threads);
+    for (unsigned t = 0; t < options->threads; ++t) {
+        std::mt19937 rng(0x4C4F4144u + t);
+        const std::size_t hot = std::max<std::size_t>(1, options->assets / 5);
+        sequences[t].reserve(options->loadsPerThread);
+        for (std::size_t i = 0; i < options->loadsPerThread; ++i) {
+            const std::size_t index = rng() % 100 < 80 ? rng() % hot : rng() % options->assets;
+            sequences[t].push_back(static_cast<std::uint32_t>(kFirstFileKtid + index));
+        }
+    }
+
+    FakeAssetHandler handler;
+    std::vector<ThreadStats> stats(options->threads);
+    std::vector<std::thread> loaders;
+    start = Clock::now();
+    for (unsigned t = 0; t < options->threads; ++t) {
+        loaders.emplace_back(LoaderThread, std::cref(sequences[t]), std::cref(*catalog), std::ref(handler),
+                             std::ref(stats[t]));
+    }
+    for (auto& loader : loaders) {
+        loader.join();
+    }
+    const double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    ThreadStats total;
+    for (ThreadStats& threadStats : stats) {
+        for (auto [from, to] : {std::pair{&threadStats.overrides, &total.overrides}, std::pair{&threadStats.vanilla, &total.vanilla}}) {
+            to->nanoseconds.insert(to->nanoseconds.end(), from->nanoseconds.begin(), from->nanoseconds.end());
+            to->bytes += from->bytes;
+            to->allocations += from->allocations;
+        }
+        total.failures += threadStats.failures;
+    }
+    const std::size_t loads = options->loadsPerThread * options->threads;
+    const std::uint64_t bytes = total.overrides.bytes + total.vanilla.bytes;
+    std::printf("threads=%u loads=%zu wall=%.2f ms, %.0f loads/s, %.1f MB/s\n", options->threads, loads, wallMs,
+                static_cast<double>(loads) / (wallMs / 1000.0),
+                static_cast<double>(bytes) / (1024.0 * 1024.0) / (wallMs / 1000.0));
+    PrintPath("override", total.overrides);
+    PrintPath("vanilla", total.vanilla);
+    std::printf("  failures=%zu\n", total.failures);
+
+    if (!options->keep) {
+        fs::remove_all(options->root / "mods", ec);
+    }
+    return total.failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+// Makes and checks ".delta" mod overrides (ModDelta.h).
+//
+//   ModDeltaTool encode <original> <modified> <output.delta>
+//   ModDeltaTool encode --rdb <root.rdb> <root.rdx> <fileKtid> <modified> <output.delta>
+//   ModDeltaTool apply <original> <input.delta> <output>
+//
+// `encode --rdb` takes the original straight from the game package. Name the result
+// "<fileKtid>[.ext].delta" inside mods/; the game then loads the original and patches it while it
+// reads. `apply` rebuilds the modified file and checks both checksums.
+//
+// Builds on Linux: it needs neither common_lib nor the game headers.
+
+#include "MappedFile.h"
+#include "ModDelta.h"
+#include "RdbTool.h"
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace LooseFileLoader;
+
+namespace {
+
+int PrintUsage() {
+    std::cerr << "Usage:\n"
+                 "  ModDeltaTool encode <original> <modified> <output.delta>\n"
+                 "  ModDeltaTool encode --rdb <root.rdb> <root.rdx> <fileKtid> <modified> <output.delta>\n"
+                 "  ModDeltaTool apply <original> <input.delta> <output>\n";
+    return 2;
+}
+
+bool ReadFile(const fs::path& path, std::vector<std::byte>* outBytes, std::string* error) {
+    const auto mapping = MappedFile::Open(path, error);
+    if (!mapping.has_value()) {
+        return false;
+    }
+    const auto bytes = mapping->Bytes();
+    outBytes->assign(bytes.begin(), bytes.end());
+    return true;
+}
+
+bool WriteFile(const fs::path& path, std::span<const std::byte> bytes, std::string* error) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        *error = "Failed to write " + path.string();
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::uint32_t> ParseFileKtid(std::string_view text) {
+    if (text.starts_with("0x") || text.starts_with("0X")) {
+        text.remove_prefix(2);
+    }
+    std::uint32_t value = 0;
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value, 16);
+    if (ec != std::errc{} || end != text.data() + text.size() || text.empty()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+int RunEncode(const std::vector<std::string_view>& args) {
+    std::string error;
+    std::vector<std::byte> original;
+    std::size_t next = 0;
+    if (args.size() == 6 && args[0] == "--rdb") {
+        const auto fileKtid = ParseFileKtid(args[3]);
+        if (!fileKtid.has_value()) {
+            std::cerr << "Invalid fileKtid: " << args[3] << '\n';
+            return 2;
+        }
+        const auto rdb = RdbTool::Open(fs::path(args[1]), fs::path(args[2]), &error);
+        if (!rdb.has_value() || !rdb->Extract(*fileKtid, &original, &error)) {
+            std::cerr << error << '\n';
+            return 1;
+        }
+        next = 4;
+    } else if (args.size() == 3) {
+        if (!ReadFile(fs::path(args[0]), &original, &error)) {
+            std::cerr << error << '\n';
+            return 1;
+        }
+        next = 1;
+    } else {
+        return PrintUsage();
+    }
+
+    std::vector<std::byte> modified;
+    if (!ReadFile(fs::path(args[next]), &modified, &error)) {
+        std::cerr << error << '\n';
+        return 1;
+    }
+    const std::vector<std::byte> delta = EncodeModDelta(original, modified);
+    // The hook applies what was written, so prove it round-trips before it is used.
+    std::vector<std::byte> check;
+    if (!ApplyModDelta(original, delta, &check, &error) || check != modified) {
+        std::cerr << "Delta does not reproduce the modified file. " << error << '\n';
+        return 1;
+    }
+    if (!WriteFile(fs::path(args[next + 1]), delta, &error)) {
+        std::cerr << error << '\n';
+        return 1;
+    }
+    std::printf("original=%zu modified=%zu delta=%zu (%.2f%% of modified)\n", original.size(), modified.size(),
+                delta.size(), modified.empty() ? 0.0 : 100.0 * static_cast<double>(delta.size()) / static_cast<double>(modified.size()));
+    return 0;
+}
+
+int RunApply(const std::vector<std::string_view>& args) {
+    if (args.size() != 3) {
+        return PrintUsage();
+    }
+    std::string error;
+    std::vector<std::byte> original;
+    std::vector<std::byte> delta;
+    std::vector<std::byte> modified;
+    if (!ReadFile(fs::path(args[0]), &original, &error) || !ReadFile(fs::path(args[1]), &delta, &error) ||
+        !ApplyModDelta(original, delta, &modified, &error) || !WriteFile(fs::path(args[2]), modified, &error)) {
+        std::cerr << error << '\n';
+        return 1;
+    }
+    std::printf("modified=%zu\n", modified.size());
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return PrintUsage();
+    }
+    const std::string_view command = argv[1];
+    const std::vector<std::string_view> args(argv + 2, argv + argc);
+    if (command == "encode") {
+        return RunEncode(args);
+    }
+    if (command == "apply") {
+        return RunApply(args);
+    }
+    return PrintUsage();
+}
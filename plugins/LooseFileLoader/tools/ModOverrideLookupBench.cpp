@@ -0,0 +1,151 @@
+// Replays DeserializeAsset-style fileKtid lookups against the mod override index.
+//
+//   ModOverrideLookupBench <root.rdb> <root.rdx> <overrideCount> [lookups]
+//   ModOverrideLookupBench --synthetic <assetCount> <overrideCount> [lookups]
+//
+// overrideCount of the package's fileKtids get an override; the probes are drawn uniformly from
+// all fileKtids, so the hit rate matches a mod that replaces that many assets. The previous
+// lookup (unordered_map<uint32_t, path> returning an optional copy, then two stat calls on hits)
+// is timed without the stat calls next to a plain unordered_map::find for reference.
+
+#include "ModOverrideIndex.h"
+#include "RdbTool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace LooseFileLoader;
+
+namespace {
+
+template <class Fn>
+double MeasureNsPerLookup(const std::vector<std::uint32_t>& probes, Fn&& lookup) {
+    // One untimed pass to warm caches and branch predictors.
+    std::uint64_t sink = 0;
+    for (const std::uint32_t probe : probes) {
+        sink += lookup(probe);
+    }
+
+    constexpr int kRounds = 5;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRounds; ++round) {
+        for (const std::uint32_t probe : probes) {
+            sink += lookup(probe);
+        }
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if (sink == 0x5A5A5A5A5A5A5A5Aull) {
+        std::puts("");
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (static_cast<double>(probes.size()) * kRounds);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const bool synthetic = argc > 1 && std::string_view(argv[1]) == "--synthetic";
+    if (argc < 4) {
+        std::cerr << "Usage: ModOverrideLookupBench <root.rdb> <root.rdx> <overrideCount> [lookups]\n"
+                     "       ModOverrideLookupBench --synthetic <assetCount> <overrideCount> [lookups]\n";
+        return 2;
+    }
+
+    std::mt19937 rng(0x4D4F4453u);
+    std::vector<std::uint32_t> fileKtids;
+    if (synthetic) {
+        fileKtids.resize(static_cast<std::size_t>(std::strtoull(argv[2], nullptr, 10)));
+        for (auto& key : fileKtids) {
+            key = rng();
+        }
+    } else {
+        std::string error;
+        const auto tool = RdbTool::Open(fs::path(argv[1]), fs::path(argv[2]), &error);
+        if (!tool.has_value()) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        for (const RdbEntry& entry : tool->Snapshot()->Entries()) {
+            fileKtids.push_back(entry.fileKtid);
+        }
+    }
+    std::sort(fileKtids.begin(), fileKtids.end());
+    fileKtids.erase(std::unique(fileKtids.begin(), fileKtids.end()), fileKtids.end());
+    if (fileKtids.empty()) {
+        std::cerr << "No fileKtids.\n";
+        return 1;
+    }
+
+    const auto overrideCount =
+        std::min<std::size_t>(static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10)), fileKtids.size());
+    const std::size_t lookupCount = argc > 4 ? static_cast<std::size_t>(std::strtoull(argv[4], nullptr, 10)) : 10000000;
+
+    std::vector<std::uint32_t> overridden = fileKtids;
+    std::shuffle(overridden.begin(), overridden.end(), rng);
+    overridden.resize(overrideCount);
+
+    std::vector<ModOverrideIndex::Record> records;
+    std::unordered_map<std::uint32_t, fs::path> previous;
+    char name[64] = {};
+    for (const std::uint32_t fileKtid : overridden) {
+        std::snprintf(name, sizeof(name), "SomeModFolder/0x%08X.g1t", fileKtid);
+        const fs::path path = fs::path("mods") / name;
+        records.push_back({fileKtid, path, 4096, true});
+        previous.emplace(fileKtid, path);
+    }
+
+    const auto buildStart = std::chrono::steady_clock::now();
+    const ModOverrideIndex index = ModOverrideIndex::Build(records);
+    const double buildMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+
+    std::vector<std::uint32_t> probes(lookupCount);
+    std::uniform_int_distribution<std::size_t> pick(0, fileKtids.size() - 1);
+    std::size_t hits = 0;
+    for (auto& probe : probes) {
+        probe = fileKtids[pick(rng)];
+        hits += previous.contains(probe) ? 1 : 0;
+    }
+
+    const auto viaIndex = [&](std::uint32_t key) -> std::uint64_t {
+        const ModOverride* hit = index.Find(key);
+        return hit != nullptr ? hit->fileSize : 0;
+    };
+    const auto viaOptionalCopy = [&](std::uint32_t key) -> std::uint64_t {
+        const auto it = previous.find(key);
+        const auto path = (it != previous.end()) ? std::optional<fs::path>(it->second) : std::nullopt;
+        return path.has_value() ? path->native().size() : 0;
+    };
+    const auto viaMapFind = [&](std::uint32_t key) -> std::uint64_t {
+        const auto it = previous.find(key);
+        return it != previous.end() ? it->second.native().size() : 0;
+    };
+
+    for (const std::uint32_t probe : probes) {
+        const ModOverride* hit = index.Find(probe);
+        const auto it = previous.find(probe);
+        if ((hit == nullptr) != (it == previous.end()) || (hit != nullptr && hit->path != it->second)) {
+            std::fprintf(stderr, "Lookup mismatch for 0x%08X\n", probe);
+            return 1;
+        }
+    }
+
+    std::printf("assets=%zu overrides=%zu indexBytes=%zu build=%.2fms lookups=%zu hitRate=%.2f%%\n", fileKtids.size(),
+                index.Size(), index.MemoryBytes(), buildMs, probes.size(),
+                100.0 * static_cast<double>(hits) / static_cast<double>(std::max<std::size_t>(probes.size(), 1)));
+    std::printf("ModOverrideIndex::Find        %7.2f ns/lookup\n", MeasureNsPerLookup(probes, viaIndex));
+    std::printf("unordered_map + optional copy %7.2f ns/lookup\n", MeasureNsPerLookup(probes, viaOptionalCopy));
+    std::printf("unordered_map::find           %7.2f ns/lookup\n", MeasureNsPerLookup(probes, viaMapFind));
+    return 0;
+}
@@ -0,0 +1,145 @@
+// Times the precedence sort used by ModAssetManager, and optionally a whole index build.
+//
+//   ModSortKeyBench <fileCount> [nonAsciiPercent]
+//   ModSortKeyBench --build <gameRootDir> [rounds]
+//
+// The first form sorts fileCount synthetic mod file paths twice: the previous way, copying and
+// folding both file names on every comparison (CompareStringOrdinal on wstring copies), and with
+// SortKeys built once per path. Both orders are checked to be identical. The second form
+// runs ModAssetManager::Build on an existing game directory without a cache.
+
+#include "ModAssetManager.h"
+#include "SortKey.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cwctype>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace LooseFileLoader;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+char16_t FoldUnit(char16_t ch) {
+    const auto upper = static_cast<std::uint32_t>(std::towupper(static_cast<std::wint_t>(ch)));
+    return upper <= 0xFFFF ? static_cast<char16_t>(upper) : ch;
+}
+
+// Per-comparison case folding on UTF-16 copies, as the comparators did before SortKey.
+int CompareFoldedCopies(const std::u16string& lhs, const std::u16string& rhs) {
+    std::u16string lhsUpper(lhs.size(), u'\0');
+    std::u16string rhsUpper(rhs.size(), u'\0');
+    std::transform(lhs.begin(), lhs.end(), lhsUpper.begin(), FoldUnit);
+    std::transform(rhs.begin(), rhs.end(), rhsUpper.begin(), FoldUnit);
+    return lhsUpper.compare(rhsUpper);
+}
+
+bool LessPrevious(const fs::path& lhs, const fs::path& rhs) {
+    const int fileCmp = CompareFoldedCopies(lhs.filename().u16string(), rhs.filename().u16string());
+    if (fileCmp != 0) {
+        return fileCmp < 0;
+    }
+    return lhs.u16string() < rhs.u16string();
+}
+
+struct KeyedPath {
+    SortKey key{};
+    const fs::path* path = nullptr;
+};
+
+int RunSortBench(std::size_t fileCount, unsigned nonAsciiPercent) {
+    std::mt19937 rng(0x534F5254u);
+    std::vector<fs::path> paths;
+    paths.reserve(fileCount);
+    const fs::path folder = fs::path("mods") / "SomeModFolder";
+    char name[64] = {};
+    for (std::size_t i = 0; i < fileCount; ++i) {
+        const std::uint32_t fileKtid = rng();
+        std::snprintf(name, sizeof(name), (rng() & 1) != 0 ? "0x%08X.g1t" : "0x%08x.G1T", fileKtid);
+        std::u8string fileName(reinterpret_cast<const char8_t*>(name));
+        if (rng() % 100 < nonAsciiPercent) {
+            fileName.insert(0, u8"éÉ_");
+        }
+        paths.push_back(folder / fs::path(fileName));
+    }
+
+    std::vector<fs::path> previous = paths;
+    auto start = Clock::now();
+    std::sort(previous.begin(), previous.end(), LessPrevious);
+    const double previousMs = ElapsedMs(start);
+
+    start = Clock::now();
+    std::vector<KeyedPath> keyed(paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        keyed[i].key = MakePathSortKey(paths[i].filename());
+        keyed[i].path = &paths[i];
+    }
+    const double keyMs = ElapsedMs(start);
+    start = Clock::now();
+    std::sort(keyed.begin(), keyed.end(), [](const KeyedPath& lhs, const KeyedPath& rhs) {
+        const int fileCmp = lhs.key.compare(rhs.key);
+        if (fileCmp != 0) {
+            return fileCmp < 0;
+        }
+        return lhs.path->native() < rhs.path->native();
+    });
+    const double sortMs = ElapsedMs(start);
+
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        mismatches += previous[i] == *keyed[i].path ? 0 : 1;
+    }
+
+    std::printf("files=%zu, nonAscii=%u%%\n", fileCount, nonAsciiPercent);
+    std::printf("  folded copies per comparison: %.2f ms\n", previousMs);
+    std::printf("  sort keys: build=%.2f ms, sort=%.2f ms, total=%.2f ms\n", keyMs, sortMs, keyMs + sortMs);
+    std::printf("  order mismatches: %zu\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
+
+int RunBuildBench(const fs::path& gameRootDir, int rounds) {
+    double bestMs = 0.0;
+    for (int round = 0; round < rounds; ++round) {
+        ModAssetManager manager;
+        const auto start = Clock::now();
+        manager.Build(gameRootDir);
+        const double ms = ElapsedMs(start);
+        bestMs = round == 0 ? ms : std::min(bestMs, ms);
+        if (round == 0) {
+            std::printf("overrides=%zu\n", manager.Acquire()->Size());
+        }
+    }
+    std::printf("Build: best of %d = %.2f ms\n", rounds, bestMs);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 2 && std::string_view(argv[1]) == "--build") {
+        return RunBuildBench(fs::path(argv[2]), argc > 3 ? std::max(1, std::atoi(argv[3])) : 5);
+    }
+    if (argc < 2) {
+        std::cerr << "Usage: ModSortKeyBench <fileCount> [nonAsciiPercent]\n"
+                     "       ModSortKeyBench --build <gameRootDir> [rounds]\n";
+        return 2;
+    }
+    const auto fileCount = static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10));
+    const auto nonAsciiPercent = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 0u;
+    return RunSortBench(fileCount, std::min(nonAsciiPercent, 100u));
+}
@@ -0,0 +1,189 @@
+// Offline helper for ktid/property name tables.
+//
+//   NameTool build <output.names> <input.csv|wordlist.txt>...
+//   NameTool recover <root.rdb> <root.rdx> <wordlist.txt> [--dict <names>] [--prefix <text>]...
+//                    [--suffix <text>]... [--threads <n>] [--out <recovered.csv>]
+//   NameTool dump <root.rdb> <root.rdx> <names> <output.csv>
+//
+// `recover` prints "0xHASH,name" rows for unknown fileKtid/typeInfoKtid values; the output can be
+// fed straight back into `build`.
+
+#include "NameHash.h"
+#include "RdbTool.h"
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace LooseFileLoader;
+
+namespace {
+
+int PrintUsage() {
+    std::cerr << "Usage:\n"
+                 "  NameTool build <output.names> <input.csv|wordlist.txt>...\n"
+                 "  NameTool recover <root.rdb> <root.rdx> <wordlist.txt> [--dict <names>] [--prefix <text>]...\n"
+                 "                   [--suffix <text>]... [--threads <n>] [--out <recovered.csv>]\n"
+                 "  NameTool dump <root.rdb> <root.rdx> <names> <output.csv>\n";
+    return 2;
+}
+
+int RunBuild(const std::vector<std::string_view>& args) {
+    if (args.size() < 2) {
+        return PrintUsage();
+    }
+
+    NameDictionaryBuilder builder;
+    std::string error;
+    for (std::size_t i = 1; i < args.size(); ++i) {
+        const fs::path input(args[i]);
+        const bool ok = (input.extension() == ".csv") ? builder.LoadCsv(input, &error)
+                                                      : builder.LoadWordlist(input, &error);
+        if (!ok) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+    }
+    if (!builder.Save(fs::path(args[0]), &error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    std::cout << "Wrote " << builder.Size() << " names to " << args[0] << "\n";
+    return 0;
+}
+
+int RunRecover(const std::vector<std::string_view>& args) {
+    if (args.size() < 3) {
+        return PrintUsage();
+    }
+
+    NameRecoveryOptions options{};
+    std::optional<fs::path> dictPath;
+    std::optional<fs::path> outPath;
+    for (std::size_t i = 3; i < args.size(); ++i) {
+        if (i + 1 >= args.size()) {
+            return PrintUsage();
+        }
+        const std::string_view flag = args[i];
+        const std::string_view value = args[++i];
+        if (flag == "--dict") {
+            dictPath = fs::path(value);
+        } else if (flag == "--prefix") {
+            options.prefixes.emplace_back(value);
+        } else if (flag == "--suffix") {
+            options.suffixes.emplace_back(value);
+        } else if (flag == "--threads") {
+            std::from_chars(value.data(), value.data() + value.size(), options.threadCount);
+        } else if (flag == "--out") {
+            outPath = fs::path(value);
+        } else {
+            return PrintUsage();
+        }
+    }
+
+    std::string error;
+    const auto tool = RdbTool::Open(fs::path(args[0]), fs::path(args[1]), &error);
+    if (!tool.has_value()) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    std::optional<NameDictionary> known;
+    if (dictPath.has_value()) {
+        known = NameDictionary::Load(*dictPath, &error);
+        if (!known.has_value()) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<std::string> words;
+    if (!LoadWordlist(fs::path(args[2]), &words, &error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    const auto catalog = tool->Snapshot();
+    const std::vector<std::uint32_t> unknown =
+        CollectUnknownKtids(catalog->Entries(), known.has_value() ? &*known : nullptr);
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<RecoveredName> recovered = RecoverNames(unknown, words, options);
+    const auto elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream file;
+    if (outPath.has_value()) {
+        file.open(*outPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open output: " << outPath->string() << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = outPath.has_value() ? static_cast<std::ostream&>(file) : std::cout;
+    out << "property_hash,property_name\n";
+    for (const RecoveredName& hit : recovered) {
+        char hash[16] = {};
+        std::snprintf(hash, sizeof(hash), "0x%08X", hit.hash);
+        out << hash << "," << hit.name << "\n";
+    }
+
+    const std::uint64_t candidates = static_cast<std::uint64_t>(words.size()) * (options.prefixes.size() + 1) *
+                                     (options.suffixes.size() + 1);
+    std::cerr << "unknown=" << unknown.size() << " candidates=" << candidates << " recovered=" << recovered.size()
+              << " time=" << elapsed << "ms\n";
+    return 0;
+}
+
+int RunDump(const std::vector<std::string_view>& args) {
+    if (args.size() != 4) {
+        return PrintUsage();
+    }
+
+    std::string error;
+    const auto tool = RdbTool::Open(fs::path(args[0]), fs::path(args[1]), &error);
+    if (!tool.has_value()) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    const auto names = NameDictionary::Load(fs::path(args[2]), &error);
+    if (!names.has_value()) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    if (!tool->Dump(fs::path(args[3]), *names, &error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        return PrintUsage();
+    }
+
+    const std::string_view command = argv[1];
+    const std::vector<std::string_view> args(argv + 2, argv + argc);
+    if (command == "build") {
+        return RunBuild(args);
+    }
+    if (command == "recover") {
+        return RunRecover(args);
+    }
+    if (command == "dump") {
+        return RunDump(args);
+    }
+    return PrintUsage();
+}
@@ -121,6 +121,7 @@ extern "C" __declspec(dllexport) bool nioh3_plugin_initialize(const Nioh3PluginI
     auto config = LoadUserConfig(param);
 
     auto patchAddr1 = HookUtils::ScanIDAPattern("E8 ? ? ? ? 84 C0 74 ? 45 8B ? 49 8B D3");
+    HookUtils::SaveSignatureCache();
     if (!patchAddr1) {
         _MESSAGE("patchAddr1 not found.");
         return true;